@@ -0,0 +1,148 @@
+/******************************************************************************
+ * @file                    microtech_bench.cpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Host microbenchmarks of the paths of common/ that run every sample
+ *
+ * Description: Each benchmark calls a function many times with the mock of the
+ *              registers and prints the host time per call and the register
+ *              accesses per call. The host time is only useful to compare two
+ *              versions of the same function, while the register accesses are
+ *              a proxy of the bus cycles on the target.
+ *
+ *              Every access is counted by the registers of the mock, see
+ *              mock/register.h, including direct assignments like TA0CCR2 = x.
+ ******************************************************************************/
+#include "Debouncer.hpp"
+#include "GPIOs.hpp"
+#include "MovingAverage.hpp"
+#include "Pwm.hpp"
+#include "ShiftRegister.hpp"
+#include "SignalGenerator.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+using namespace Microtech;
+
+namespace {
+
+constexpr uint32_t ITERATIONS = 1000000;
+
+volatile uint32_t sink = 0;  ///< Keeps the compiler from removing the benchmarked calls
+
+/**
+ * Calls the function ITERATIONS times and prints the time and the register accesses per call.
+ */
+template<class FUNCTION>
+void benchmark(const char* name, FUNCTION function) {
+  const uint32_t accessesBefore = Mock::registerAccesses;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    function(i);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  const uint32_t accesses = Mock::registerAccesses - accessesBefore;
+
+  const double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+  std::printf("%-45s %10.2f ns/call %8.2f register accesses/call\n", name, nanoseconds / ITERATIONS,
+              static_cast<double>(accesses) / ITERATIONS);
+}
+
+/// 64 samples of a sawtooth for the arbitrary waveform
+uint16_t arbitraryWaveformSamples[64];
+
+void benchmarkSignalGenerator(const char* name, const SignalGenerator::Shape shape,
+                              const bool interpolatedSine = false) {
+  SignalGenerator signalGenerator(50);
+  signalGenerator.setNewFrequency(_IQ15(5));
+  for (uint16_t i = 0; i < 64; i++) {
+    arbitraryWaveformSamples[i] = static_cast<uint16_t>(i * 1024);
+  }
+  signalGenerator.setArbitraryWaveform(makeWaveformTable(arbitraryWaveformSamples, true));
+  signalGenerator.setActiveSignalShape(shape);
+  signalGenerator.setSineInterpolation(interpolatedSine);
+  benchmark(name, [&](uint32_t) { sink = sink + signalGenerator.getNextDatapoint(); });
+}
+
+template<uint8_t NUMBER_OF_SAMPLES, uint8_t INPUT_BITS = 16>
+void benchmarkMovingAverage(const char* name) {
+  SimpleMovingAverage<NUMBER_OF_SAMPLES, uint16_t, uint32_t, INPUT_BITS> filter;
+  benchmark(name, [&](uint32_t i) { sink = sink + filter.filterNewSample(static_cast<uint16_t>(i & 0x3FF)); });
+}
+
+/**
+ * Compares the AverageDivider to a division of the sum of 30 samples. The divisor is read from a volatile, so it stays
+ * a division. The host divides in hardware, so the times only show that the multiplication is not slower there; on
+ * the target the division is a software routine, see AverageDivider.
+ */
+void benchmarkAverageDivider() {
+  volatile uint32_t divisor = 30;
+  benchmark("sum / 30 (division)", [&](uint32_t i) { sink = sink + (i & 0x7FFF) / divisor; });
+  benchmark("AverageDivider<30> 10 bit inputs (32 bits)", [&](uint32_t i) {
+    sink = sink + AverageDivider<30, uint16_t, uint32_t, 10>::divide(i & 0x7FFF);
+  });
+  benchmark("AverageDivider<30> 16 bit inputs (32x32->64)", [&](uint32_t i) {
+    sink = sink + AverageDivider<30, uint16_t, uint32_t>::divide(i & 0x7FFF);
+  });
+}
+
+/**
+ * Object whose method is called by the Debouncer
+ */
+struct DebouncedCounter {
+  void pressed() {
+    sink = sink + 1;
+  }
+};
+
+}  // namespace
+
+int main() {
+  benchmarkSignalGenerator("SignalGenerator::getNextDatapoint sinusoidal", SignalGenerator::Shape::SINUSOIDAL);
+  benchmarkSignalGenerator("SignalGenerator::getNextDatapoint sine lerp", SignalGenerator::Shape::SINUSOIDAL, true);
+  benchmarkSignalGenerator("SignalGenerator::getNextDatapoint trapezoidal", SignalGenerator::Shape::TRAPEZOIDAL);
+  benchmarkSignalGenerator("SignalGenerator::getNextDatapoint rectangular", SignalGenerator::Shape::RECTANGULAR);
+  benchmarkSignalGenerator("SignalGenerator::getNextDatapoint arbitrary", SignalGenerator::Shape::ARBITRARY);
+
+  benchmarkMovingAverage<4>("SimpleMovingAverage<4>::filterNewSample");
+  benchmarkMovingAverage<16>("SimpleMovingAverage<16>::filterNewSample");
+  benchmarkMovingAverage<30>("SimpleMovingAverage<30>::filterNewSample");
+  benchmarkMovingAverage<30, 10>("SimpleMovingAverage<30> 10 bit inputs");
+  benchmarkMovingAverage<32>("SimpleMovingAverage<32>::filterNewSample");
+  benchmarkAverageDivider();
+
+  Pwm pwm(GPIOs::getOutputHandle<IOPort::PORT_3, static_cast<uint8_t>(6)>());
+  pwm.init();
+  pwm.setPwmPeriod<250, std::chrono::microseconds>();
+  benchmark("Pwm::setDutyCycle", [&](uint32_t i) { pwm.setDutyCycle(_IQ15(static_cast<int32_t>(i % 101))); });
+
+  const ShiftRegisterPB shiftRegisterPB(GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(4)>(),
+                                        GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(5)>(),
+                                        GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(2)>(),
+                                        GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(3)>(),
+                                        GPIOs::getInputHandle<IOPort::PORT_2, static_cast<uint8_t>(7)>());
+  shiftRegisterPB.init();
+  benchmark("ShiftRegisterPB::getPBValues", [&](uint32_t) { sink = sink + shiftRegisterPB.getPBValues(); });
+
+  PBScanner<ShiftRegisterPB> pbScanner(shiftRegisterPB, 8);
+  benchmark("PBScanner<ShiftRegisterPB>::tick", [&](uint32_t) { sink = sink + pbScanner.tick().pressed; });
+
+  DebouncedCounter counter;
+  Debouncer<DebouncedCounter> debouncer(counter, &DebouncedCounter::pressed);
+  benchmark("Debouncer::evaluateDebounce", [&](uint32_t i) {
+    if ((i & 0x3F) == 0) {
+      debouncer.pinStateChanged();
+    }
+    debouncer.evaluateDebounce();
+  });
+
+  PortDebouncer portDebouncer;
+  benchmark("PortDebouncer::update",
+            [&](uint32_t i) { sink = sink + portDebouncer.update(static_cast<uint8_t>(i >> 4)); });
+  return 0;
+}
@@ -1,11 +1,13 @@
 #ifndef MICROTECH_ADC_HPP
 #define MICROTECH_ADC_HPP
 
+#include "LowPower.hpp"
 #include "MovingAverage.hpp"
 #include "helpers.hpp"
 #include <msp430g2553.h>
-#include <cstdint>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 
 namespace Microtech {
 
@@ -24,13 +26,6 @@ public:
   uint16_t getRawValue() const noexcept {
     return rawValue;
   }
-  /**
-   * Method to get the latest filtered ADC value
-   * @return the latest filtered value
-   */
-  //uint16_t getFilteredValue() noexcept {
-  //  return smaFilter.filterNewSample(rawValue);
-  //}
 
 protected:
   /**
@@ -40,14 +35,80 @@ protected:
   constexpr AdcHandle(uint16_t& adcValueRef) : rawValue(adcValueRef) {}
 
 private:
-  //SimpleMovingAverage<30> smaFilter;  ///< Moving Averaget filter of 30 samples. This can be templated in the future.
-  uint16_t& rawValue;                 ///< Reference to the raw value.
+  uint16_t& rawValue;  ///< Reference to the raw value.
+};
+
+/**
+ * Interface for the handles whose filter is updated by the ADC interruption.
+ */
+class AdcFilterBase {
+  friend class Adc;
+
+public:
+  virtual ~AdcFilterBase() = default;
+
+protected:
+  AdcFilterBase() = default;
+
+  /**
+   * Method called by the ADC interruption after every sweep, to filter the new raw value.
+   */
+  virtual void update() noexcept = 0;
+};
+
+/**
+ * AdcHandle that also owns a filter, which is updated once per conversion in the ADC interruption,
+ * instead of on each read.
+ *
+ * Since the filter runs in the interruption, it should not need a division:
+ * use a SimpleMovingAverage with a power of two number of samples, or an ExponentialMovingAverage. Any other number
+ * of samples should set the INPUT_BITS of the filter to 10, so it only needs a multiplication of 32 bits.
+ * @tparam FILTER Filter type. It must have the method INPUT_TYPE filterNewSample(INPUT_TYPE)
+ */
+template<class FILTER>
+class FilteredAdcHandle : public AdcHandle, public AdcFilterBase {
+public:
+  /**
+   * Constructor
+   * @param handle The handle of the ADC pin to be filtered
+   */
+  explicit FilteredAdcHandle(const AdcHandle& handle) : AdcHandle(handle) {}
+
+  /**
+   * Method to get the latest filtered ADC value
+   * @return the latest filtered value
+   */
+  uint16_t getFilteredValue() const noexcept {
+    return filteredValue;
+  }
+
+private:
+  void update() noexcept override {
+    filteredValue = filter.filterNewSample(getRawValue());
+  }
+
+  FILTER filter;                        ///< Filter of the raw values
+  volatile uint16_t filteredValue = 0;  ///< Latest filtered value
+};
+
+/**
+ * Source that triggers the sample and conversion of the ADC.
+ * The timer outputs have to be configured by the user to generate the trigger edges.
+ */
+enum class AdcTrigger : uint16_t {
+  FREE_RUNNING = SHS_0,  ///< Conversions are started by ADC10SC and run back to back
+  TIMER0_OUT1 = SHS_1,   ///< Each rising edge of Timer0 output 1 starts a conversion
+  TIMER0_OUT0 = SHS_2,   ///< Each rising edge of Timer0 output 0 starts a conversion
+  TIMER0_OUT2 = SHS_3,   ///< Each rising edge of Timer0 output 2 starts a conversion
 };
 
 class Adc {
-  Adc() = default;
+  friend struct SingletonInstance<Adc>;
+  constexpr Adc() = default;
 
 public:
+  typedef void (*BlockCallback)(const uint16_t* samples, uint8_t numberOfSamples);  ///< Type definition of callback
+
   // Deleted copy and move constructors
   Adc(Adc&) = delete;
   Adc(Adc&&) = delete;
@@ -57,26 +118,27 @@ public:
    * Method that guarantees that there is only one instance of the ADC class in the software
    * @return A reference to the instance
    */
-  static Adc& getInstance() {
-    static Adc instance;
-    return instance;
+  static Adc& getInstance() noexcept {
+    return SingletonInstance<Adc>::instance;
   }
 
   /**
-   * Method that initialized the adc
+   * Method that initialized the adc in the sequence of channels mode.
+   * Every sweep converts all the channels, from A7 to A0, and the DTC writes them to the adcValues array.
+   *
+   * If there are filtered handles registered, the ADC10 interruption updates them after every sweep.
+   * Free running, a sweep takes around 34us, which is too often for the interruption, so in this case
+   * a timer trigger should be used. Every trigger edge converts one channel, so a sweep takes 8 edges.
+   * @param[in] trigger Source that starts each conversion
    */
-  void init() noexcept {
-    // Make sure DTC is disabled
-    ADC10DTC0 = 0;
-    ADC10DTC1 = 0;
-
-    // Make sure the ADC is not running.
-    ADC10CTL0 &= ~ENC;
-    while (ADC10CTL1 & ADC10BUSY){}
+  void init(AdcTrigger trigger = AdcTrigger::FREE_RUNNING) noexcept {
+    disable();
     // ADC10 on
     // sample and hold time = 16 ADC Clock cycles = 8*0.2us = 1.6 us
-    // Multiple sample and conversion on.
-    ADC10CTL0 = ADC10ON + ADC10SHT_1 + MSC;
+    // Multiple sample and conversion on when it is free running.
+    const uint16_t multipleConversion = (trigger == AdcTrigger::FREE_RUNNING) ? MSC : 0;
+    const uint16_t interruptEnable = (numberOfFilteredHandles > 0) ? ADC10IE : 0;
+    ADC10CTL0 = ADC10ON + ADC10SHT_1 + multipleConversion + interruptEnable;
 
     // Repeat-sequence-of-channels mode
     // CLk source = ADC10OSC => around 5 MHz
@@ -85,9 +147,9 @@ public:
     // sample and hold time = 16 ADC Clock cycles = 8*0.2us = 1.6 us
     // Convert time = 13 ADC Clock cycles = 13*0.2us = 2.6us
     // Total conversion of 1 channel = Sample and hold + convert time = 1.6us + 2.6us = 4.2us
-    // Source of sample and hold from ADC10SC bit
+    // Source of sample and hold from the trigger
     // Always start sampling from the ADC7, since we are populating the adcValues array with DTC
-    ADC10CTL1 = CONSEQ_3 + ADC10SSEL_0 + ADC10DIV_0 + SHS_0 + INCH_0;
+    ADC10CTL1 = CONSEQ_3 + ADC10SSEL_0 + ADC10DIV_0 + static_cast<uint16_t>(trigger) + INCH_7;
 
     // Setup Data transfer control 0
     // The basic idea is that everytime the ADC does a conversion, the
@@ -96,11 +158,52 @@ public:
     // References of the adcValues array are passed to the AdcHandles
     // so when the user gets the AdcHandles, the latest raw value will always be available
     // without the user having to actively fetch any data from the ADC10MEM.
+    // Since the sequence starts at A7, the first entry of the array is the A7 and the last the A0.
     ADC10DTC0 = ADC10CT;                                   // enable continuous transfer
-    ADC10DTC1 = 1; //sizeof(adcValues) / sizeof(adcValues[0]);  // Number of transfers is equal to the size of array.
+    ADC10DTC1 = sizeof(adcValues) / sizeof(adcValues[0]);  // Number of transfers is equal to the size of array.
     ADC10SA = (size_t)(&adcValues[0]);                     // Starts at address is the first entry of the array;
   }
 
+  /**
+   * Method that initializes the adc to continuously capture blocks of samples of a single channel.
+   *
+   * The DTC works in two-block mode, so while one half of the buffer is being filled, the other half,
+   * that was just completed, is passed to the callback from the ADC10 interruption.
+   * The callback has to finish processing the block before the next block is completed.
+   *
+   * @tparam pinNumber ADC channel to be sampled
+   * @tparam BLOCK_SIZE Number of samples of each block
+   * @param[in] buffer Buffer of two blocks where the DTC writes the samples.
+   * @param[in] callback Function called from the interruption every time a block is completed.
+   * @param[in] trigger Source that starts each conversion
+   */
+  template<uint8_t pinNumber, uint8_t BLOCK_SIZE>
+  void initBlockCapture(std::array<uint16_t, 2 * BLOCK_SIZE>& buffer, BlockCallback callback,
+                        AdcTrigger trigger = AdcTrigger::FREE_RUNNING) noexcept {
+    constexpr uint8_t MAX_NUM_ADC_CHANNELS = 7;
+    static_assert(pinNumber <= MAX_NUM_ADC_CHANNELS, "Cannot set ADC to pin higher than 7");
+    static_assert(BLOCK_SIZE > 0, "Block must have at least one sample");
+
+    disable();
+    blockBuffer = &buffer[0];
+    blockSize = BLOCK_SIZE;
+    blockCallback = callback;
+
+    setRegisterBits(ADC10AE0, static_cast<uint8_t>(0x01 << pinNumber));  // Sets pin as an ADC input
+    // Multiple sample and conversion is only used when it is free running. Otherwise every trigger
+    // edge makes one conversion.
+    const uint16_t multipleConversion = (trigger == AdcTrigger::FREE_RUNNING) ? MSC : 0;
+    ADC10CTL0 = ADC10ON + ADC10SHT_1 + ADC10IE + multipleConversion;
+
+    // Repeat-single-channel mode
+    ADC10CTL1 = CONSEQ_2 + ADC10SSEL_0 + ADC10DIV_0 + static_cast<uint16_t>(trigger) + (pinNumber * INCH_1);
+
+    // Two blocks with continuous transfer, so the DTC goes back to the first block after the second.
+    ADC10DTC0 = ADC10TB + ADC10CT;
+    ADC10DTC1 = BLOCK_SIZE;  // Number of transfers of each block
+    ADC10SA = (size_t)(&buffer[0]);
+  }
+
   /**
    * Method that starts the ADC conversion
    * Previous to this call, one has to already have requested the ADC handles, as well as
@@ -123,24 +226,78 @@ public:
     setRegisterBits(ADC10AE0, bitMask);  // Sets pin as an ADC input
 
     // Creates the AdcHandle and passes the array entry equivalent to the pin to the handle.
-    AdcHandle retVal(adcValues[pinNumber]);
+    // The sequence goes from A7 to A0, so the entries are in the reverse order of the pins.
+    AdcHandle retVal(adcValues[MAX_NUM_ADC_CHANNELS - pinNumber]);
 
     return retVal;
   }
 
+  /**
+   * Method to register a filtered handle, so its filter is updated after every sweep of the sequence of channels.
+   * It should be called before init, which enables the interruption.
+   * @param[in] handle The filtered handle. It must exist during the whole execution.
+   * @return true if the handle was registered, false if there is no space left.
+   */
+  bool registerFilteredHandle(AdcFilterBase& handle) noexcept {
+    if (numberOfFilteredHandles >= filteredHandles.size()) {
+      return false;
+    }
+    filteredHandles[numberOfFilteredHandles++] = &handle;
+    return true;
+  }
+
+  /**
+   * Method called by the ADC10 interruption.
+   * In block capture mode, it passes the block that was just completed to the callback.
+   * Otherwise a sweep was completed and the filtered handles are updated.
+   */
+  void interruptionHappened() noexcept {
+    if (blockCallback == nullptr) {
+      for (uint8_t i = 0; i < numberOfFilteredHandles; i++) {
+        filteredHandles[i]->update();
+      }
+      return;
+    }
+    // ADC10B1 set means the first block was the one filled.
+    const uint16_t* completedBlock = (ADC10DTC0 & ADC10B1) ? blockBuffer : blockBuffer + blockSize;
+    blockCallback(completedBlock, blockSize);
+  }
+
 private:
+  /**
+   * Stops the ADC and the DTC, so they can be configured.
+   */
+  void disable() noexcept {
+    // Make sure the ADC is not running.
+    ADC10CTL0 &= ~ENC;
+    while (ADC10CTL1 & ADC10BUSY) {
+    }
+    // Make sure DTC is disabled
+    ADC10DTC0 = 0;
+    ADC10DTC1 = 0;
+    blockCallback = nullptr;
+  }
+
   /**
    * Array that stores the conversion values from the ADC.
    * It is automatically populated by the DTC
    */
   std::array<uint16_t, 8> adcValues{0, 0, 0, 0, 0, 0, 0, 0};
+  const uint16_t* blockBuffer = nullptr;  ///< Buffer of the block capture mode
+  uint8_t blockSize = 0;                  ///< Number of samples of each block
+  BlockCallback blockCallback = nullptr;  ///< Called every time a block is completed
+  std::array<AdcFilterBase*, 8> filteredHandles{};  ///< Handles updated after every sweep
+  uint8_t numberOfFilteredHandles = 0;              ///< Number of registered filtered handles
 };
 }  // namespace Microtech
 
 // ADC10 Interruption
-// #pragma vector = ADC10_VECTOR
-//__interrupt void ADC10_ISR(void) {
-//  Microtech::Adc::getInstance().interruptionHappened();
-//}
+#pragma vector = ADC10_VECTOR
+__interrupt void ADC10_ISR(void) {
+  Microtech::Adc::getInstance().interruptionHappened();
+  if (Microtech::LowPower::isWakeUpRequested()) {
+    __bic_SR_register_on_exit(LPM4_bits);
+  }
+}
 
 #endif  // MICROTECH_ADC_HPP
@@ -0,0 +1,147 @@
+/******************************************************************************
+ * @file                    ClockSystem.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains the configuration of the basic clock system
+ *
+ * Description: The ClockSystem sets the DCO with the calibration data of the
+ *              information memory (1, 8, 12 or 16 MHz), the dividers of SMCLK
+ *              and ACLK, and the source of ACLK (LFXT1 crystal or VLO). The
+ *              resulting frequencies are constexpr, so the Timer, the Pwm and the
+ *              Serial calculate their registers from them in compile time.
+ *
+ *              The clock of the application is SystemClock. By default it is the
+ *              1 MHz of the initMSP of the templateEMP. Another one is selected by
+ *              defining the macros before including any header:
+ *                #define MICROTECH_DCO_FREQUENCY_MHZ 16
+ *                #define MICROTECH_ACLK_SOURCE_VLO
+ *                #include "ClockSystem.hpp"
+ *                ...
+ *                SystemClock::init();
+ *
+ *              MICROTECH_SMCLK_DIVIDER and MICROTECH_ACLK_DIVIDER (1, 2, 4 or 8)
+ *              set the dividers. The VLO is not calibrated, so ACLK_FREQUENCY_HZ
+ *              is only its typical frequency.
+ ******************************************************************************/
+#ifndef MICROTECH_CLOCKSYSTEM_HPP
+#define MICROTECH_CLOCKSYSTEM_HPP
+
+#include "helpers.hpp"
+#include <msp430g2553.h>
+#include <cstdint>
+
+#ifndef MICROTECH_DCO_FREQUENCY_MHZ
+#define MICROTECH_DCO_FREQUENCY_MHZ 1
+#endif
+
+#ifndef MICROTECH_SMCLK_DIVIDER
+#define MICROTECH_SMCLK_DIVIDER 1
+#endif
+
+#ifndef MICROTECH_ACLK_DIVIDER
+#define MICROTECH_ACLK_DIVIDER 1
+#endif
+
+namespace Microtech {
+
+/**
+ * Enum to choose the source of ACLK
+ */
+enum class AclkSource : uint8_t {
+  LFXT1_32KHZ = 0,  ///< 32768 Hz watch crystal on XIN/XOUT
+  VLO,              ///< Internal very low power oscillator, around 12 kHz
+};
+
+/**
+ * Class that configures the basic clock system. MCLK runs at the DCO frequency.
+ * @tparam DCO_FREQUENCY_MHZ Calibrated frequency of the DCO: 1, 8, 12 or 16
+ * @tparam SMCLK_DIVIDER Divider of the DCO for SMCLK: 1, 2, 4 or 8
+ * @tparam ACLK_SOURCE Source of ACLK
+ * @tparam ACLK_DIVIDER Divider of the source of ACLK: 1, 2, 4 or 8
+ */
+template<uint8_t DCO_FREQUENCY_MHZ, uint8_t SMCLK_DIVIDER = 1, AclkSource ACLK_SOURCE = AclkSource::LFXT1_32KHZ,
+         uint8_t ACLK_DIVIDER = 1>
+class ClockSystem {
+  static_assert((DCO_FREQUENCY_MHZ == 1) || (DCO_FREQUENCY_MHZ == 8) || (DCO_FREQUENCY_MHZ == 12) ||
+                  (DCO_FREQUENCY_MHZ == 16),
+                "There is only calibration data for 1, 8, 12 and 16 MHz");
+  static_assert((SMCLK_DIVIDER == 1) || (SMCLK_DIVIDER == 2) || (SMCLK_DIVIDER == 4) || (SMCLK_DIVIDER == 8),
+                "Invalid divider of SMCLK");
+  static_assert((ACLK_DIVIDER == 1) || (ACLK_DIVIDER == 2) || (ACLK_DIVIDER == 4) || (ACLK_DIVIDER == 8),
+                "Invalid divider of ACLK");
+
+public:
+  ClockSystem() = delete;
+
+  static constexpr uint32_t MCLK_FREQUENCY_HZ = static_cast<uint32_t>(DCO_FREQUENCY_MHZ) * 1000000UL;
+  static constexpr uint32_t SMCLK_FREQUENCY_HZ = MCLK_FREQUENCY_HZ / SMCLK_DIVIDER;
+  static constexpr uint32_t ACLK_FREQUENCY_HZ =
+    ((ACLK_SOURCE == AclkSource::VLO) ? 12000UL : 32768UL) / ACLK_DIVIDER;
+
+  /**
+   * Method to configure the clocks. It should be called right after stopping the watchdog.
+   * With the crystal, it waits until the oscillator fault flag stays cleared.
+   */
+  static void init() noexcept {
+    // The DCO starts from its lowest setting, so it never runs faster than the target while the range changes.
+    DCOCTL = 0;
+    // The calibration of BCSCTL1 also sets XT2OFF, which the G2553 doesn't have, and keeps DIVA at /1.
+    BCSCTL1 = getCalibratedBCSCTL1() | getDividerBits<ACLK_DIVIDER>(DIVA_1);
+    DCOCTL = getCalibratedDCOCTL();
+    BCSCTL2 = SELM_0 | DIVM_0 | getDividerBits<SMCLK_DIVIDER>(DIVS_1);
+    if (ACLK_SOURCE == AclkSource::VLO) {
+      BCSCTL3 = LFXT1S_2;
+    } else {
+      // The crystal of the LaunchPad needs 12.5 pF
+      BCSCTL3 = LFXT1S_0 | XCAP_3;
+      do {
+        resetRegisterBits(IFG1, static_cast<uint8_t>(OFIFG));
+        __delay_cycles(50);
+      } while ((IFG1 & OFIFG) != 0);
+    }
+  }
+
+private:
+  static uint8_t getCalibratedBCSCTL1() noexcept {
+    switch (DCO_FREQUENCY_MHZ) {
+      case 16: return CALBC1_16MHZ;
+      case 12: return CALBC1_12MHZ;
+      case 8: return CALBC1_8MHZ;
+      default: return CALBC1_1MHZ;
+    }
+  }
+
+  static uint8_t getCalibratedDCOCTL() noexcept {
+    switch (DCO_FREQUENCY_MHZ) {
+      case 16: return CALDCO_16MHZ;
+      case 12: return CALDCO_12MHZ;
+      case 8: return CALDCO_8MHZ;
+      default: return CALDCO_1MHZ;
+    }
+  }
+
+  /**
+   * Function to get the bits of a divider field, from the value of its first step
+   */
+  template<uint8_t DIVIDER>
+  static constexpr uint8_t getDividerBits(const uint8_t firstStep) noexcept {
+    return static_cast<uint8_t>(((DIVIDER == 8) ? 3 : (DIVIDER == 4) ? 2 : (DIVIDER == 2) ? 1 : 0) * firstStep);
+  }
+};
+
+/**
+ * Clock of the application, selected by the macros. Its frequencies are used by the Timer, the Pwm and the Serial.
+ */
+using SystemClock = ClockSystem<MICROTECH_DCO_FREQUENCY_MHZ, MICROTECH_SMCLK_DIVIDER,
+#ifdef MICROTECH_ACLK_SOURCE_VLO
+                                AclkSource::VLO,
+#else
+                                AclkSource::LFXT1_32KHZ,
+#endif
+                                MICROTECH_ACLK_DIVIDER>;
+}  // namespace Microtech
+
+#endif  // MICROTECH_CLOCKSYSTEM_HPP
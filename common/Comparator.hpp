@@ -0,0 +1,211 @@
+/******************************************************************************
+ * @file                    Comparator.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains abstraction of the Comparator_A+
+ *
+ * Description: The Comparator_A+ compares two pins of port 1, or a pin with an
+ *              internal reference (0.25 Vcc, 0.5 Vcc or the diode voltage), and
+ *              works in every low power mode. A threshold, like a knock, an over
+ *              temperature or a zero crossing, is then a single interruption
+ *              instead of continuous conversions of the ADC10.
+ *
+ *              The edges of the output are delivered like the ones of the pins
+ *              (see PortInterrupts in GPIOs.hpp). The application defines the
+ *              constant handler and MICROTECH_COMPARATOR_INTERRUPT before
+ *              including any header, so this header defines the interruption:
+ *                #define MICROTECH_COMPARATOR_INTERRUPT
+ *                #include "Comparator.hpp"
+ *                ...
+ *                const PinInterruptHandler Comparator::EDGE_HANDLER = makePinInterruptHandler<&knockDetected>();
+ *                ...
+ *                Comparator::init(ComparatorPositiveInput::CA0, ComparatorNegativeInput::NONE,
+ *                                 ComparatorReference::QUARTER_VCC);
+ *                Comparator::enableInterrupt(ComparatorEdge::RISING);
+ *
+ *              The output is also connected to CCI1B of Timer0_A, so the edges
+ *              can be timestamped by the hardware (see CaptureChannel).
+ ******************************************************************************/
+#ifndef MICROTECH_COMPARATOR_HPP
+#define MICROTECH_COMPARATOR_HPP
+
+#include "GPIOs.hpp"
+#include "LowPower.hpp"
+#include "Timer.hpp"
+#include "helpers.hpp"
+#include <msp430g2553.h>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Pins that can be connected to the + terminal. CAx is P1.x.
+ */
+enum class ComparatorPositiveInput : uint8_t {
+  NONE = 0,
+  CA0 = P2CA0,
+  CA1 = P2CA4,
+  CA2 = P2CA4 | P2CA0,
+};
+
+/**
+ * Pins that can be connected to the - terminal. CAx is P1.x.
+ */
+enum class ComparatorNegativeInput : uint8_t {
+  NONE = 0,
+  CA1 = P2CA1,
+  CA2 = P2CA2,
+  CA3 = P2CA2 | P2CA1,
+  CA4 = P2CA3,
+  CA5 = P2CA3 | P2CA1,
+  CA6 = P2CA3 | P2CA2,
+  CA7 = P2CA3 | P2CA2 | P2CA1,
+};
+
+/**
+ * Internal reference of the comparator
+ */
+enum class ComparatorReference : uint8_t {
+  NONE = CAREF_0,         ///< Both terminals are pins
+  QUARTER_VCC = CAREF_1,  ///< 0.25 Vcc
+  HALF_VCC = CAREF_2,     ///< 0.5 Vcc
+  DIODE = CAREF_3,        ///< Voltage of a diode, around 0.55 V
+};
+
+/**
+ * Terminal that gets the internal reference instead of a pin
+ */
+enum class ComparatorReferenceTerminal : uint8_t {
+  POSITIVE = 0,
+  NEGATIVE = CARSEL,
+};
+
+/**
+ * Edge of the output that triggers the interruption
+ */
+enum class ComparatorEdge : uint8_t {
+  RISING = 0,       ///< The + terminal became higher than the - terminal
+  FALLING = CAIES,  ///< The + terminal became lower than the - terminal
+};
+
+/**
+ * Class to configure the Comparator_A+. There is only one comparator, so it only has static methods.
+ */
+class Comparator {
+public:
+  Comparator() = delete;
+
+  /**
+   * Handler of the edges of the output. It has to be defined by the application when
+   * MICROTECH_COMPARATOR_INTERRUPT is defined.
+   */
+  static const PinInterruptHandler EDGE_HANDLER;
+
+  /**
+   * Method to configure and turn on the comparator. The digital input buffers of the pins that are used are
+   * disabled, since an analog voltage in them would draw current.
+   * @param positiveInput Pin of the + terminal
+   * @param negativeInput Pin of the - terminal
+   * @param reference Internal reference, that replaces the pin of its terminal
+   * @param referenceTerminal Terminal of the internal reference
+   * @param filter If the output is filtered, so an input with noise close to the threshold doesn't oscillate
+   */
+  static void init(const ComparatorPositiveInput positiveInput, const ComparatorNegativeInput negativeInput,
+                   const ComparatorReference reference = ComparatorReference::NONE,
+                   const ComparatorReferenceTerminal referenceTerminal = ComparatorReferenceTerminal::NEGATIVE,
+                   const bool filter = true) noexcept {
+    CACTL1 = 0;
+    CAPD = static_cast<uint8_t>(getPositivePinMask(positiveInput) | getNegativePinMask(negativeInput));
+    CACTL2 = static_cast<uint8_t>(static_cast<uint8_t>(positiveInput) | static_cast<uint8_t>(negativeInput) |
+                                  (filter ? CAF : 0));
+    CACTL1 = static_cast<uint8_t>(static_cast<uint8_t>(reference) | static_cast<uint8_t>(referenceTerminal) | CAON);
+  }
+
+  /**
+   * Method to turn off the comparator and its reference, which saves their current in the low power modes
+   */
+  static void stop() noexcept {
+    CACTL1 = 0;
+    CACTL2 = 0;
+    CAPD = 0;
+  }
+
+  /**
+   * Method to get the output of the comparator
+   * @return true if the + terminal is higher than the - terminal
+   */
+  static bool getOutput() noexcept {
+    return (CACTL2 & CAOUT) != 0;
+  }
+
+  /**
+   * Method to enable the interruption of an edge of the output. The flag is cleared first, since changing the
+   * edge can set it.
+   */
+  static void enableInterrupt(const ComparatorEdge edge) noexcept {
+    resetRegisterBits(CACTL1, static_cast<uint8_t>(CAIE));
+    CACTL1 = static_cast<uint8_t>((CACTL1 & ~(CAIES | CAIFG)) | static_cast<uint8_t>(edge));
+    setRegisterBits(CACTL1, static_cast<uint8_t>(CAIE));
+  }
+
+  /**
+   * Method to disable the interruption. The comparator keeps running, so the output can still be read.
+   */
+  static void disableInterrupt() noexcept {
+    resetRegisterBits(CACTL1, static_cast<uint8_t>(CAIE));
+  }
+
+  /**
+   * Method to capture the edges of the output with CCR1 of Timer0_A, which is connected to it internally.
+   * See Timer::startCapture.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ>
+  static void startCapture(const TimerConfigBase<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ>& config, CaptureChannel& capture,
+                           const CaptureEdge edge) noexcept {
+    Timer<0>::getTimer().startCapture<1>(config, capture, edge, CaptureInput::CCI_B);
+  }
+
+  /**
+   * Function must be called by the interruption of the comparator. The flag is cleared by the hardware.
+   */
+  static void interruptionHappened() noexcept {
+    if (EDGE_HANDLER.callback != nullptr) {
+      EDGE_HANDLER.callback(EDGE_HANDLER.context);
+    }
+  }
+
+private:
+  static constexpr uint8_t getPositivePinMask(const ComparatorPositiveInput input) noexcept {
+    switch (input) {
+      case ComparatorPositiveInput::CA0: return CAPD0;
+      case ComparatorPositiveInput::CA1: return CAPD1;
+      case ComparatorPositiveInput::CA2: return CAPD2;
+      case ComparatorPositiveInput::NONE: return 0;
+    }
+    return 0;  // It will actually never get here. But it is needed due to the compiler warning
+  }
+
+  static constexpr uint8_t getNegativePinMask(const ComparatorNegativeInput input) noexcept {
+    // The inputs are in the order of the pins, from CA1 = P2CA1 to CA7 = P2CA3 | P2CA2 | P2CA1.
+    return (input == ComparatorNegativeInput::NONE)
+             ? 0
+             : static_cast<uint8_t>(0x01 << (static_cast<uint8_t>(input) / P2CA1));
+  }
+};
+}  // namespace Microtech
+
+#ifdef MICROTECH_COMPARATOR_INTERRUPT
+// Comparator_A+ interrupt vector
+#pragma vector = COMPARATORA_VECTOR
+__interrupt void COMPARATORA_ISR(void) {
+  Microtech::Comparator::interruptionHappened();
+  if (Microtech::LowPower::isWakeUpRequested()) {
+    __bic_SR_register_on_exit(LPM4_bits);
+  }
+}
+#endif
+
+#endif  // MICROTECH_COMPARATOR_HPP
@@ -0,0 +1,231 @@
+/******************************************************************************
+ * @file                    Controller.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains a PID and an on/off controller for the Pwm
+ *
+ * Description: Both controllers take the measurement as an integer, e.g. the
+ *              raw value of an AdcHandle, and return a duty cycle in the range of
+ *              Pwm::setDutyCycle, from 0 to 100 in Q15.
+ *
+ *              The PidController runs at a fixed rate given by its template
+ *              parameters, the same ones of the TaskHandler that calls it, so the
+ *              sample time is folded into the gains in compile time. A step then
+ *              only costs up to three _IQ15mpy and no division:
+ *                // 50 counts of error already turn the heating fully on
+ *                PidController<2, std::chrono::seconds> heaterController(2.0, 0.05, 0.0);
+ *                PidController<2, std::chrono::seconds>::Task controlTask(&controlTaskFunc, true);
+ *                ...
+ *                void controlTaskFunc() {
+ *                  heatingPwm.setDutyCycle(heaterController.update(ntcInput.getRawValue()));
+ *                }
+ *
+ *              The gains are converted by a constexpr constructor, so the
+ *              controller should be a global variable, otherwise the
+ *              conversions of the doubles may end up in the binary.
+ *
+ *              The HysteresisController switches the output fully on or off, for
+ *              actuators that cannot be modulated, like a relay.
+ ******************************************************************************/
+#ifndef MICROTECH_CONTROLLER_HPP
+#define MICROTECH_CONTROLLER_HPP
+
+#include "Pwm.hpp"
+#include "Timer.hpp"
+
+#include "IQmathLib.h"
+#include <chrono>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Enum to choose how the output acts on the measurement
+ */
+enum class ControllerAction : uint8_t {
+  DIRECT = 0,  ///< A higher output raises the measurement, e.g. a heater and an NTC on the high side of the divider
+  REVERSE,     ///< A higher output lowers the measurement, e.g. a fan, or an NTC on the low side of the divider
+};
+
+/**
+ * Limits of the output of the controllers, which are the ones of Pwm::setDutyCycle
+ */
+static constexpr _iq15 CONTROLLER_OUTPUT_MIN = 0;
+static constexpr _iq15 CONTROLLER_OUTPUT_MAX = Pwm::MAX_DUTY_CYCLE;
+
+/**
+ * Class implements a PID controller of the equation:
+ * output[n] = Kp * error[n] + sum(Ki * T * error[k]) - Kd / T * (measurement[n] - measurement[n-1])
+ *
+ * The derivative uses the measurement instead of the error, so a change of the setpoint doesn't kick the output.
+ * The integral is limited to the range of the output, and it only accumulates while the output is not saturated
+ * in the direction of the error, so it doesn't wind up while the actuator is at its limit.
+ *
+ * Every term is a _iq15, so the gains must keep each of them within +-65536 for the largest error.
+ *
+ * @tparam periodValue Period of the task that calls update
+ * @tparam Duration Time scale of the period (milliseconds, microseconds...)
+ */
+template<uint64_t periodValue, typename Duration = std::chrono::microseconds>
+class PidController {
+public:
+  /// TaskHandler with the period of the controller
+  using Task = TaskHandler<periodValue, Duration>;
+
+  static constexpr uint64_t PERIOD_IN_US = Task::PERIOD_IN_US;  ///< Sample time of the controller
+
+  /**
+   * Constructor
+   * @param kp Proportional gain, in output percent per unit of the measurement
+   * @param ki Integral gain, in output percent per unit of the measurement and second
+   * @param kd Derivative gain, in output percent per unit of the measurement per second
+   * @param action How the output acts on the measurement
+   */
+  constexpr PidController(const double kp, const double ki, const double kd,
+                          const ControllerAction action = ControllerAction::DIRECT)
+    : proportionalGain(_IQ15(kp)),
+      integralGain(_IQ15(ki * PERIOD_IN_US / MICROSECONDS_PER_SECOND)),
+      derivativeGain(_IQ15(kd * MICROSECONDS_PER_SECOND / PERIOD_IN_US)),
+      action(action) {}
+
+  /**
+   * Method to set the value the measurement is controlled to
+   * @param newSetpoint The setpoint, in the unit of the measurement
+   */
+  void setSetpoint(const int16_t newSetpoint) noexcept {
+    setpoint = newSetpoint;
+  }
+
+  /**
+   * Method to calculate the next output. It has to be called once per period.
+   * @param measurement The current measurement
+   * @return The output, between CONTROLLER_OUTPUT_MIN and CONTROLLER_OUTPUT_MAX
+   */
+  _iq15 update(const int16_t measurement) noexcept {
+    const int16_t error = applyAction(static_cast<int16_t>(setpoint - measurement));
+    _iq15 derivative = 0;
+    if (hasPreviousMeasurement && (derivativeGain != 0)) {
+      const int16_t measurementDecrease = applyAction(static_cast<int16_t>(previousMeasurement - measurement));
+      derivative = _IQ15mpy(derivativeGain, _IQ15(measurementDecrease));
+    }
+    previousMeasurement = measurement;
+    hasPreviousMeasurement = true;
+
+    const _iq15 proportional = _IQ15mpy(proportionalGain, _IQ15(error));
+    const _iq15 unlimitedOutput = proportional + integral + derivative;
+    const bool saturatedByError = ((unlimitedOutput >= CONTROLLER_OUTPUT_MAX) && (error > 0)) ||
+                                  ((unlimitedOutput <= CONTROLLER_OUTPUT_MIN) && (error < 0));
+    if (!saturatedByError && (integralGain != 0)) {
+      integral = limit(integral + _IQ15mpy(integralGain, _IQ15(error)));
+    }
+    output = limit(proportional + integral + derivative);
+    return output;
+  }
+
+  /**
+   * Method to get the last output
+   */
+  _iq15 getOutput() const noexcept {
+    return output;
+  }
+
+  /**
+   * Method to restart the controller, e.g. after the actuator was turned off for a while
+   */
+  void reset() noexcept {
+    integral = 0;
+    output = 0;
+    hasPreviousMeasurement = false;
+  }
+
+private:
+  static constexpr double MICROSECONDS_PER_SECOND = 1000000.0;
+
+  int16_t applyAction(const int16_t difference) const noexcept {
+    return (action == ControllerAction::DIRECT) ? difference : static_cast<int16_t>(-difference);
+  }
+
+  static _iq15 limit(const _iq15 value) noexcept {
+    if (value > CONTROLLER_OUTPUT_MAX) {
+      return CONTROLLER_OUTPUT_MAX;
+    }
+    return (value < CONTROLLER_OUTPUT_MIN) ? CONTROLLER_OUTPUT_MIN : value;
+  }
+
+  const _iq15 proportionalGain;         ///< Kp
+  const _iq15 integralGain;             ///< Ki * T
+  const _iq15 derivativeGain;           ///< Kd / T
+  const ControllerAction action;        ///< How the output acts on the measurement
+  int16_t setpoint = 0;                 ///< Value the measurement is controlled to
+  int16_t previousMeasurement = 0;      ///< Measurement of the last update, for the derivative
+  bool hasPreviousMeasurement = false;  ///< If there was an update since the start, so the derivative is valid
+  _iq15 integral = 0;                   ///< Sum of the integral term, limited to the range of the output
+  _iq15 output = 0;                     ///< Last output
+};
+
+/**
+ * Class implements an on/off controller with hysteresis. With ControllerAction::DIRECT, the output is turned on
+ * when the measurement falls to setpoint - hysteresis and turned off when it rises to setpoint + hysteresis.
+ * The rate doesn't matter, so it can be called by any task.
+ */
+class HysteresisController {
+public:
+  /**
+   * Constructor
+   * @param hysteresis Distance of both thresholds to the setpoint, in the unit of the measurement
+   * @param action How the output acts on the measurement
+   */
+  constexpr explicit HysteresisController(const uint16_t hysteresis,
+                                          const ControllerAction action = ControllerAction::DIRECT)
+    : hysteresis(static_cast<int16_t>(hysteresis)), action(action) {}
+
+  /**
+   * Method to set the value the measurement is controlled to
+   * @param newSetpoint The setpoint, in the unit of the measurement
+   */
+  void setSetpoint(const int16_t newSetpoint) noexcept {
+    setpoint = newSetpoint;
+  }
+
+  /**
+   * Method to calculate the next output
+   * @param measurement The current measurement
+   * @return CONTROLLER_OUTPUT_MAX if the output is on, CONTROLLER_OUTPUT_MIN otherwise
+   */
+  _iq15 update(const int16_t measurement) noexcept {
+    const int16_t error = static_cast<int16_t>(setpoint - measurement);
+    const int16_t actingError = (action == ControllerAction::DIRECT) ? error : static_cast<int16_t>(-error);
+    if (actingError >= hysteresis) {
+      on = true;
+    } else if (actingError <= -hysteresis) {
+      on = false;
+    }
+    return getOutput();
+  }
+
+  /**
+   * Method to know if the output is on, e.g. to set a pin
+   */
+  bool isOn() const noexcept {
+    return on;
+  }
+
+  /**
+   * Method to get the last output
+   */
+  _iq15 getOutput() const noexcept {
+    return on ? CONTROLLER_OUTPUT_MAX : CONTROLLER_OUTPUT_MIN;
+  }
+
+private:
+  const int16_t hysteresis;       ///< Distance of both thresholds to the setpoint
+  const ControllerAction action;  ///< How the output acts on the measurement
+  int16_t setpoint = 0;           ///< Value the measurement is controlled to
+  bool on = false;                ///< If the output is on
+};
+}  // namespace Microtech
+
+#endif  // MICROTECH_CONTROLLER_HPP
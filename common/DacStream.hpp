@@ -0,0 +1,168 @@
+/******************************************************************************
+ * @file                    DacStream.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains a sample stream to the Pwm used as a DAC
+ *
+ * Description: A duty cycle set by a periodic task only changes at the rate of
+ *              the task, and each one costs the multiplication of the duty cycle
+ *              by the scale of the period inside the interruption. The DacStream
+ *              converts the samples to compare values in the main loop and keeps
+ *              them in a ring buffer, and the CCR0 interruption of Timer0 only
+ *              copies the next one to CCR2 at the period boundary, so every
+ *              sample is output for whole periods of the PWM:
+ *                DacStream<32> dacStream(DAC_IN, 8);  // One sample every 8 periods
+ *                ...
+ *                dacStream.fill(signalGenerator);
+ *                dacStream.start();
+ *                while (true) {
+ *                  dacStream.fill(signalGenerator);
+ *                  idle(ClockRequirement::SMCLK);
+ *                }
+ *
+ *              The Timer_A has no buffered compare registers, so the buffer is
+ *              the ring: the next value is always ready when the period starts.
+ *              If the ring is empty, the last sample is held and the underrun
+ *              is counted. The interruption wakes up the main loop when half of
+ *              the ring is free.
+ *
+ *              The CCR0 interruption is the period callback of Timer<0>, so while
+ *              the stream runs, the duty cycle must not be set with
+ *              PwmUpdateMode::NEXT_PERIOD.
+ ******************************************************************************/
+#ifndef MICROTECH_DACSTREAM_HPP
+#define MICROTECH_DACSTREAM_HPP
+
+#include "LowPower.hpp"
+#include "Pwm.hpp"
+#include "SignalGenerator.hpp"
+#include "Timer.hpp"
+
+#include "IQmathLib.h"
+#include <msp430g2553.h>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Class that outputs a stream of samples to the Pwm, paced by its period
+ * @tparam BUFFER_SIZE Number of samples of the ring buffer. It has to be a power of two.
+ */
+template<uint8_t BUFFER_SIZE>
+class DacStream {
+  static constexpr uint8_t BUFFER_MASK = BUFFER_SIZE - 1;
+  static_assert((BUFFER_SIZE & BUFFER_MASK) == 0, "The buffer size has to be a power of two");
+  static_assert(BUFFER_SIZE >= 4, "The main loop is woken up at half of the buffer");
+
+public:
+  /**
+   * Constructor
+   * @param pwm Pwm used as a DAC. Its period must already be set when samples are added, since it scales them.
+   * @param periodsPerSample Number of PWM periods each sample is output for, at least 1. The sample rate of the
+   *                         stream is the PWM frequency divided by it.
+   */
+  constexpr DacStream(const Pwm& pwm, const uint8_t periodsPerSample = 1)
+    : pwm(pwm), periodsPerSample((periodsPerSample == 0) ? 1 : periodsPerSample) {}
+
+  /**
+   * Method to add a sample to the stream
+   * @param dutyCycle Duty cycle of the sample, from 0 to 100
+   * @return true if the sample was added, false if the ring buffer is full
+   */
+  bool addSample(const _iq15 dutyCycle) noexcept {
+    const uint8_t nextHead = (head + 1) & BUFFER_MASK;
+    if (nextHead == tail) {
+      return false;
+    }
+    buffer[head] = pwm.getCompareValue(dutyCycle);
+    head = nextHead;
+    return true;
+  }
+
+  /**
+   * Method to fill the free space of the ring buffer with the next data points of a signal generator
+   * @param signalGenerator Signal generator, whose sampling frequency must be the sample rate of the stream
+   */
+  void fill(SignalGenerator& signalGenerator) noexcept {
+    // The free space is read once, so a data point is never generated without space for it.
+    for (uint8_t freeSpace = getFreeSpace(); freeSpace > 0; freeSpace--) {
+      addSample(signalGenerator.getNextDatapoint());
+    }
+  }
+
+  /**
+   * Method to get how many samples can still be added
+   * @return The number of free samples of the ring buffer
+   */
+  uint8_t getFreeSpace() const noexcept {
+    return static_cast<uint8_t>(tail - head - 1) & BUFFER_MASK;
+  }
+
+  /**
+   * Method to start the output. The first sample of the ring buffer is output at the next period boundary.
+   */
+  void start() noexcept {
+    periodsUntilSample = 1;
+    running = true;
+    Timer<0>::getTimer().callAtNextPeriod(&periodElapsed, this);
+  }
+
+  /**
+   * Method to stop the output. The last sample is held, and the samples left in the ring buffer are kept.
+   */
+  void stop() noexcept {
+    running = false;
+  }
+
+  /**
+   * Method to get the number of samples that were due while the ring buffer was empty
+   * @return The number of underruns
+   */
+  uint16_t getUnderruns() const noexcept {
+    return underruns;
+  }
+
+private:
+  /**
+   * Called by the CCR0 interruption when the timer counts back to 0
+   */
+  static void periodElapsed(void* context) {
+    DacStream* const stream = static_cast<DacStream*>(context);
+    if (!stream->running) {
+      return;
+    }
+    Timer<0>::getTimer().callAtNextPeriod(&periodElapsed, context);
+    if (--stream->periodsUntilSample != 0) {
+      return;
+    }
+    stream->periodsUntilSample = stream->periodsPerSample;
+
+    const uint8_t currentTail = stream->tail;
+    if (currentTail == stream->head) {
+      stream->underruns++;
+      LowPower::requestWakeUp();
+      return;
+    }
+    TA0CCR2 = stream->buffer[currentTail];
+    stream->tail = (currentTail + 1) & BUFFER_MASK;
+    // Wakes up the main loop once per half of the ring buffer, instead of after every sample
+    if (((stream->head - stream->tail) & BUFFER_MASK) == BUFFER_SIZE / 2) {
+      LowPower::requestWakeUp();
+    }
+  }
+
+  const Pwm& pwm;                     ///< Pwm that scales the samples to compare values
+  const uint8_t periodsPerSample;     ///< Number of PWM periods each sample is output for
+  uint8_t periodsUntilSample = 1;     ///< Periods left until the next sample is output
+  volatile bool running = false;      ///< If the interruption outputs the samples
+  uint16_t buffer[BUFFER_SIZE] = {};  ///< Compare values of CCR2 of the samples
+  volatile uint8_t head = 0;          ///< Index where the next sample will be added
+  volatile uint8_t tail = 0;          ///< Index of the next sample to be output
+  volatile uint16_t underruns = 0;    ///< Samples that were due while the ring buffer was empty
+};
+}  // namespace Microtech
+
+#endif  // MICROTECH_DACSTREAM_HPP
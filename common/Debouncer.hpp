@@ -52,6 +52,144 @@ private:
   CLASS_TYPE& objRef;
   FuncPointer funcPtr = nullptr;
 };
+
+/**
+ * Debouncer of up to 8 inputs at once, like the pins of a port or the PBs of the shift register.
+ *
+ * Each input has a 2 bit counter, but the counters are stored "vertically": bit 0 of every counter is in one byte
+ * and bit 1 in another. So every input is debounced in parallel with a few bitwise operations per tick,
+ * no matter how many inputs there are.
+ *
+ * A counter runs while its input differs from the debounced state and restarts whenever they are equal again,
+ * so an input only changes after 4 consecutive equal samples.
+ *  @code
+ *      PortDebouncer pbDebouncer;
+ *      // Every 20ms, so an input changes after being stable for 80ms
+ *      pbDebouncer.update(pb1to4.getPBValues());
+ *      if (pbDebouncer.getPressed() & BIT0) { ... }
+ *  @endcode
+ */
+class PortDebouncer {
+public:
+  /**
+   * Constructor
+   * @param initialState Debounced state of the inputs before the first sample
+   */
+  constexpr explicit PortDebouncer(const uint8_t initialState = 0) : state(initialState) {}
+
+  /**
+   * Debounces a new sample of the inputs. It should be called periodically.
+   * @param samples Sample of the inputs, where a set bit means pressed. Active low inputs have to be inverted.
+   * @return Mask of the inputs whose debounced state changed with this sample
+   */
+  uint8_t update(const uint8_t samples) noexcept {
+    const uint8_t delta = samples ^ state;
+    // Increments the counters of the inputs that differ from the state, and clears the others.
+    counterHigh = (counterHigh ^ counterLow) & delta;
+    counterLow = ~counterLow & delta;
+    // The counter overflows back to 0 on the 4th consecutive sample, which changes the state.
+    const uint8_t changed = delta & ~(counterHigh | counterLow);
+    state ^= changed;
+    pressed = changed & state;
+    released = changed & ~state;
+    return changed;
+  }
+
+  /**
+   * Method to get the debounced state of the inputs
+   * @return Mask of the inputs that are pressed
+   */
+  uint8_t getState() const noexcept {
+    return state;
+  }
+
+  /**
+   * Method to get the inputs that were pressed in the last update
+   * @return Mask of the inputs that changed to pressed
+   */
+  uint8_t getPressed() const noexcept {
+    return pressed;
+  }
+
+  /**
+   * Method to get the inputs that were released in the last update
+   * @return Mask of the inputs that changed to released
+   */
+  uint8_t getReleased() const noexcept {
+    return released;
+  }
+
+  /**
+   * Method to know if any input differs from its debounced state, so its counter is still running
+   * @return true if the next samples may still change the state
+   */
+  bool isSettling() const noexcept {
+    return (counterLow | counterHigh) != 0;
+  }
+
+private:
+  uint8_t state;            ///< Debounced state of each input
+  uint8_t counterLow = 0;   ///< Bit 0 of the counter of each input
+  uint8_t counterHigh = 0;  ///< Bit 1 of the counter of each input
+  uint8_t pressed = 0;      ///< Inputs that changed to pressed in the last update
+  uint8_t released = 0;     ///< Inputs that changed to released in the last update
+};
+
+/**
+ * Result of a tick of the PBScanner
+ */
+struct PBScan {
+  uint8_t raw;       ///< PBs pressed in the last sample, before debouncing
+  uint8_t state;     ///< Debounced PBs that are pressed
+  uint8_t pressed;   ///< PBs that changed to pressed in this tick
+  uint8_t released;  ///< PBs that changed to released in this tick
+};
+
+/**
+ * Class that only reads the PB shift register when it is needed. While the PBs are stable, they are sampled every
+ * idleTicks ticks, and once any of them differs from its debounced state, at every tick until the PortDebouncer
+ * settles again. So a press is seen after at most idleTicks ticks, and then debounced at the tick rate.
+ *  @code
+ *      // Ticks every 20ms, and samples every 160ms while idle
+ *      PBScanner<ShiftRegisterPB> pbScanner(pb1to4, 8);
+ *      const PBScan scan = pbScanner.tick();
+ *      if (scan.pressed & BIT0) { ... }
+ *  @endcode
+ * @tparam SHIFT_REGISTER Class of the shift register, ShiftRegisterPB or SpiShiftRegisterPB
+ */
+template<class SHIFT_REGISTER>
+class PBScanner {
+public:
+  /**
+   * Constructor
+   * @param shiftRegister Shift register of the PBs, which must already be initialized when tick is called
+   * @param idleTicks Ticks between two samples while the PBs are stable, at least 1
+   */
+  constexpr PBScanner(const SHIFT_REGISTER& shiftRegister, const uint8_t idleTicks)
+    : shiftRegister(shiftRegister), idleTicks((idleTicks == 0) ? 1 : idleTicks) {}
+
+  /**
+   * Method to be called periodically, at the rate the PBs are debounced
+   * @return The last sample and the debounced state, with the edges of this tick. The edges are 0 if the PBs
+   *         were not sampled.
+   */
+  PBScan tick() noexcept {
+    if (--ticksUntilSample != 0) {
+      return {raw, debouncer.getState(), 0, 0};
+    }
+    raw = shiftRegister.getPBValues();
+    debouncer.update(raw);
+    ticksUntilSample = debouncer.isSettling() ? 1 : idleTicks;
+    return {raw, debouncer.getState(), debouncer.getPressed(), debouncer.getReleased()};
+  }
+
+private:
+  const SHIFT_REGISTER& shiftRegister;  ///< Shift register of the PBs
+  const uint8_t idleTicks;              ///< Ticks between two samples while the PBs are stable
+  uint8_t ticksUntilSample = 1;         ///< Ticks left until the next sample, so the first tick samples
+  uint8_t raw = 0;                      ///< Last sample of the PBs
+  PortDebouncer debouncer;              ///< Debounces the samples
+};
 }
 
 #endif  // MICROTECH_DEBOUNCER_HPP
@@ -0,0 +1,147 @@
+/******************************************************************************
+ * @file                    EventQueue.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains a queue to defer work from the interruptions to the main loop
+ *
+ * Description: Interruptions should be short, so the latency of the other interruptions
+ *              stays bounded (e.g. the PWM update is never delayed by a serial print).
+ *              Instead of doing the work, an interruption posts an event, and the main
+ *              loop processes the events before going to sleep:
+ *
+ *                while (true) {
+ *                  eventQueue.process();
+ *                  idle();
+ *                }
+ *
+ *              The queue is lock-free for a single producer and a single consumer.
+ *              Interruptions don't nest on the MSP430, so every interruption together
+ *              is the single producer, and the main loop is the single consumer. Posting
+ *              from the main loop is therefore not allowed.
+ ******************************************************************************/
+#ifndef MICROTECH_EVENTQUEUE_HPP
+#define MICROTECH_EVENTQUEUE_HPP
+
+#include "LowPower.hpp"
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Single producer, single consumer queue of events.
+ * @tparam SIZE Number of entries of the queue. It has to be a power of two. One entry is always kept free,
+ *              to tell a full queue from an empty one.
+ */
+template<uint8_t SIZE>
+class EventQueue {
+  static_assert(SIZE > 1 && (SIZE & (SIZE - 1)) == 0, "The size of the queue has to be a power of two");
+
+public:
+  typedef void (*EventHandler)(void* context, uint16_t payload);  ///< Type definition of the handler of an event
+
+  /**
+   * Posts an event that calls a function with a payload.
+   * @tparam CALLBACK Function called by the main loop
+   * @param payload Value passed to the function
+   * @return true if the event was posted, false if the queue is full
+   */
+  template<void (*CALLBACK)(uint16_t)>
+  bool post(const uint16_t payload = 0) noexcept {
+    return post(&invokeFunction<CALLBACK>, nullptr, payload);
+  }
+
+  /**
+   * Posts an event that calls a method of an object, like the callbacks of the Debouncer.
+   * @tparam CLASS_TYPE Class of the object
+   * @tparam METHOD Method called by the main loop
+   * @param object Object whose method is called. It must exist until the event is processed.
+   * @return true if the event was posted, false if the queue is full
+   */
+  template<class CLASS_TYPE, void (CLASS_TYPE::*METHOD)()>
+  bool post(CLASS_TYPE& object) noexcept {
+    return post(&invokeMethod<CLASS_TYPE, METHOD>, &object, 0);
+  }
+
+  /**
+   * Posts an event. It also requests the main loop to wake up, so the event is processed.
+   * @param handler Function called by the main loop
+   * @param context Pointer passed to the handler
+   * @param payload Value passed to the handler
+   * @return true if the event was posted, false if the queue is full
+   */
+  bool post(const EventHandler handler, void* const context, const uint16_t payload) noexcept {
+    const uint8_t currentHead = head;
+    const uint8_t nextHead = (currentHead + 1) & MASK;
+    if (nextHead == tail) {
+      droppedEvents++;
+      return false;
+    }
+    // The entries and the indexes are volatile, so the compiler keeps the order of the accesses: the head is only
+    // moved after the event was written, so the consumer never reads a half written event.
+    volatile Event& slot = events[currentHead];
+    slot.handler = handler;
+    slot.context = context;
+    slot.payload = payload;
+    head = nextHead;
+    LowPower::requestWakeUp();
+    return true;
+  }
+
+  /**
+   * Processes every pending event. It has to be called from the main loop.
+   * @return Number of processed events
+   */
+  uint8_t process() noexcept {
+    uint8_t processedEvents = 0;
+    uint8_t currentTail = tail;
+    while (currentTail != head) {
+      // The event is copied before the entry is freed, since the producer may overwrite it right after. The entry
+      // is volatile, so it is only read after the head.
+      const volatile Event& slot = events[currentTail];
+      const Event event = {slot.handler, slot.context, slot.payload};
+      currentTail = (currentTail + 1) & MASK;
+      tail = currentTail;
+      event.handler(event.context, event.payload);
+      processedEvents++;
+    }
+    return processedEvents;
+  }
+
+  /**
+   * Method to get the number of events dropped because the queue was full
+   * @return The number of dropped events
+   */
+  uint16_t getDroppedEvents() const noexcept {
+    return droppedEvents;
+  }
+
+private:
+  static constexpr uint8_t MASK = SIZE - 1;
+
+  struct Event {
+    EventHandler handler;  ///< Function called by the main loop
+    void* context;         ///< Pointer passed to the handler
+    uint16_t payload;      ///< Value passed to the handler
+  };
+
+  template<void (*CALLBACK)(uint16_t)>
+  static void invokeFunction(void* /*context*/, const uint16_t payload) {
+    CALLBACK(payload);
+  }
+
+  template<class CLASS_TYPE, void (CLASS_TYPE::*METHOD)()>
+  static void invokeMethod(void* context, const uint16_t /*payload*/) {
+    (static_cast<CLASS_TYPE*>(context)->*METHOD)();
+  }
+
+  volatile Event events[SIZE] = {};     ///< Ring buffer with the events, volatile to order them with the indexes
+  volatile uint8_t head = 0;            ///< Index where the next event is posted. Only written by the producer.
+  volatile uint8_t tail = 0;            ///< Index of the next event to be processed. Only written by the consumer.
+  volatile uint16_t droppedEvents = 0;  ///< Number of events dropped because the queue was full
+};
+}  // namespace Microtech
+
+#endif  // MICROTECH_EVENTQUEUE_HPP
@@ -0,0 +1,459 @@
+/******************************************************************************
+ * @file                    FlashLogger.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains a logger of ADC blocks to the flash
+ *
+ * Description: The RAM of the G2553 only fits a few hundred samples and the
+ *              serial link only sends around 480 samples per second. The
+ *              FlashLogger copies the blocks of the ADC block capture to segments
+ *              of the main flash, so a burst is captured at the rate of the ADC
+ *              and sent afterwards, even after a reset.
+ *
+ *              The segments have to be reserved for the logger, e.g. by removing
+ *              them from the FLASH memory range of the linker command file, and
+ *              aligned to the 512 bytes of a segment:
+ *                FlashLogger<8> flashLogger(reinterpret_cast<uint16_t*>(0xE000));
+ *                std::array<uint16_t, 2 * 32> adcBlocks;
+ *                void blockCompleted(const uint16_t* samples, uint8_t numberOfSamples) {
+ *                  flashLogger.blockCompleted(samples, numberOfSamples);
+ *                }
+ *                ...
+ *                flashLogger.init();
+ *                flashLogger.start(1000, FlashLoggerMode::ONE_SHOT);
+ *                Adc::getInstance().initBlockCapture<0, 32>(adcBlocks, &blockCompleted, AdcTrigger::TIMER0_OUT1);
+ *                ...
+ *                while (true) {
+ *                  flashLogger.process();
+ *                  idle(ClockRequirement::SMCLK);
+ *                }
+ *
+ *              The interruption only takes the completed block. The main loop
+ *              writes it word by word, and each word holds the CPU for around
+ *              30 cycles of the flash clock (90us at 1 MHz), so the ADC10
+ *              interruption is never delayed by more than one word. A segment is
+ *              erased with the erase interruptions enabled, so the interruptions
+ *              keep running during the 10 to 15 ms of the erase. The main loop
+ *              must write one block before the next one is completed, otherwise
+ *              the block is dropped and counted. The DTC writes a taken block
+ *              again after the next one is completed, so if that happens while
+ *              it is copied, e.g. during an erase, it is counted as overwritten.
+ *
+ *              Segment format (words are little endian):
+ *                magic               0x4C47
+ *                sequence            Number of the segment since start, to order the wrap-around
+ *                first sample        Index of the first sample since start (4 bytes), so its time is
+ *                                    first sample / sample rate
+ *                sample rate         Samples per second
+ *                dropped blocks      Blocks dropped while the segment was written, 0xFFFF if the
+ *                                    capture stopped before the segment was closed
+ *                overwritten blocks  Blocks of the segment that may hold samples of a later block,
+ *                                    0xFFFF like the dropped blocks
+ *                reserved            1 word
+ *                samples             Until the end of the segment or the first 0xFFFF
+ *
+ *              The dump sends every segment from the oldest one as a frame:
+ *                0xA5 0xC3           Sync
+ *                header              The 8 words of the segment header
+ *                number of samples   2 bytes
+ *                samples             2 bytes each
+ *                crc                 CRC-8 (polynomial 0x07) of every byte after the sync
+ *
+ *              The decoder is example/flashlogger/decode_flash_log.py
+ ******************************************************************************/
+#ifndef MICROTECH_FLASHLOGGER_HPP
+#define MICROTECH_FLASHLOGGER_HPP
+
+#include "ClockSystem.hpp"
+#include "Serial.hpp"
+#include "helpers.hpp"
+#include <msp430g2553.h>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Enum to choose what happens when every segment was written
+ */
+enum class FlashLoggerMode : uint8_t {
+  ONE_SHOT = 0,  ///< The capture stops, so the beginning of the burst is kept
+  WRAP_AROUND,   ///< The oldest segment is erased and written again, so the end of the burst is kept
+};
+
+/**
+ * Class that logs the blocks of the ADC to segments of the main flash.
+ * @tparam NUMBER_OF_SEGMENTS Number of segments of 512 bytes reserved for the logger
+ */
+template<uint8_t NUMBER_OF_SEGMENTS>
+class FlashLogger {
+  static_assert(NUMBER_OF_SEGMENTS >= 2, "The logger needs at least two segments");
+
+public:
+  static constexpr uint16_t SEGMENT_SIZE = 512;                                      ///< Bytes of a main flash segment
+  static constexpr uint16_t WORDS_PER_SEGMENT = SEGMENT_SIZE / 2;                    ///< Words of a segment
+  static constexpr uint16_t HEADER_WORDS = 8;                                        ///< Words of the segment header
+  static constexpr uint16_t SAMPLES_PER_SEGMENT = WORDS_PER_SEGMENT - HEADER_WORDS;  ///< Samples of a segment
+  static constexpr uint16_t MAGIC = 0x4C47;                                          ///< First word of a segment in use
+  static constexpr uint16_t ERASED_WORD = 0xFFFF;                                    ///< Value of an erased word
+
+  /**
+   * Constructor
+   * @param storage First word of the reserved segments
+   */
+  explicit FlashLogger(uint16_t* storage) : storage(storage) {}
+
+  /**
+   * Method to configure the clock of the flash controller. The flash clock has to be between 257 and 476 kHz, so
+   * MCLK of the SystemClock is divided in compile time to the fastest clock in that range.
+   */
+  void init() const noexcept {
+    FCTL2 = FWKEY | FSSEL_1 | (FLASH_CLOCK_DIVIDER - 1);
+  }
+
+  /**
+   * Method to start a new capture. Every segment is erased, so it should be called before the ADC starts.
+   * @param sampleRateHz Samples per second of the ADC, written to the header of every segment
+   * @param mode What happens when every segment was written
+   */
+  void start(const uint16_t sampleRateHz, const FlashLoggerMode mode) noexcept {
+    for (uint8_t segment = 0; segment < NUMBER_OF_SEGMENTS; segment++) {
+      eraseSegment(getSegment(segment));
+    }
+    sampleRate = sampleRateHz;
+    loggerMode = mode;
+    currentSegment = 0;
+    nextWord = WORDS_PER_SEGMENT;  // No segment is open yet
+    sequence = 0;
+    writtenSamples = 0;
+    blockSize = 0;
+    totalDroppedBlocks = 0;
+    segmentFirstDroppedBlock = 0;
+    totalOverwrittenBlocks = 0;
+    segmentFirstOverwrittenBlock = 0;
+    pendingBlock = nullptr;
+    dumping = false;
+    capturing = true;
+  }
+
+  /**
+   * Method to stop the capture. The blocks that were not written yet are discarded.
+   */
+  void stop() noexcept {
+    capturing = false;
+    pendingBlock = nullptr;
+    closeSegment();
+  }
+
+  /**
+   * Method to be called by the callback of the ADC block capture, from the interruption
+   * @param samples Block that was completed
+   * @param numberOfSamples Number of samples of the block
+   */
+  void blockCompleted(const uint16_t* samples, const uint8_t numberOfSamples) noexcept {
+    if (!capturing) {
+      return;
+    }
+    completedBlocks++;
+    if (pendingBlock != nullptr) {
+      // The main loop didn't take the previous block, which the DTC is writing again now.
+      totalDroppedBlocks++;
+    }
+    pendingSize = numberOfSamples;
+    pendingBlock = samples;
+  }
+
+  /**
+   * Method to be called by the main loop. It writes the pending block to the flash or, if a dump was requested,
+   * sends the next bytes that fit in the buffer of the Serial.
+   * @return true if there is still a block to be written or a dump to be sent
+   */
+  bool process() noexcept {
+    if (capturing) {
+      writePendingBlock();
+      return pendingBlock != nullptr;
+    }
+    if (dumping) {
+      sendDump();
+    }
+    return dumping;
+  }
+
+  /**
+   * Method to start sending the written segments over the serial link, from the oldest one. It is sent by process.
+   * @return false if it can't be started because the capture is running
+   */
+  bool requestDump() noexcept {
+    if (capturing) {
+      return false;
+    }
+    dumpSegmentOffset = findOldestSegment();
+    dumpedSegments = 0;
+    dumpWord = 0;
+    dumping = true;
+    return true;
+  }
+
+  /**
+   * Method to know if the capture is running. In FlashLoggerMode::ONE_SHOT, it stops by itself when every segment
+   * was written.
+   */
+  bool isCapturing() const noexcept {
+    return capturing;
+  }
+
+  /**
+   * Method to get the number of blocks dropped since the start
+   */
+  uint16_t getDroppedBlocks() const noexcept {
+    return totalDroppedBlocks;
+  }
+
+  /**
+   * Method to get the number of blocks written since the start while the DTC was already writing them again
+   */
+  uint16_t getOverwrittenBlocks() const noexcept {
+    return totalOverwrittenBlocks;
+  }
+
+private:
+  /**
+   * Offsets of the words of the segment header
+   */
+  enum HeaderWord : uint8_t {
+    HEADER_MAGIC = 0,
+    HEADER_SEQUENCE,
+    HEADER_FIRST_SAMPLE_LOW,
+    HEADER_FIRST_SAMPLE_HIGH,
+    HEADER_SAMPLE_RATE,
+    HEADER_DROPPED_BLOCKS,
+    HEADER_OVERWRITTEN_BLOCKS,
+  };
+
+  static constexpr uint32_t MAX_FLASH_CLOCK_FREQUENCY_HZ = 476000;
+  static constexpr uint32_t MIN_FLASH_CLOCK_FREQUENCY_HZ = 257000;
+  static constexpr uint16_t FLASH_CLOCK_DIVIDER = static_cast<uint16_t>(
+    (SystemClock::MCLK_FREQUENCY_HZ + MAX_FLASH_CLOCK_FREQUENCY_HZ - 1) / MAX_FLASH_CLOCK_FREQUENCY_HZ);
+  static_assert((FLASH_CLOCK_DIVIDER <= 64) &&
+                  (SystemClock::MCLK_FREQUENCY_HZ / FLASH_CLOCK_DIVIDER >= MIN_FLASH_CLOCK_FREQUENCY_HZ),
+                "MCLK cannot be divided to the range of the flash clock");
+
+  static constexpr uint8_t SYNC_FIRST_BYTE = 0xA5;
+  static constexpr uint8_t SYNC_SECOND_BYTE = 0xC3;
+  static constexpr uint16_t FRAME_HEADER_WORDS = HEADER_WORDS + 1;  ///< Segment header and number of samples
+
+  uint16_t* getSegment(const uint8_t segment) const noexcept {
+    return storage + static_cast<uint16_t>(segment) * WORDS_PER_SEGMENT;
+  }
+
+  /**
+   * Erases a segment with a dummy write. The erase interruptions are enabled, so the interruptions are serviced
+   * while the flash controller erases the segment.
+   */
+  static void eraseSegment(uint16_t* segment) noexcept {
+    FCTL3 = FWKEY;
+    FCTL1 = FWKEY | ERASE | EEI;
+    *segment = 0;
+    while ((FCTL3 & BUSY) != 0) {
+    }
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY | LOCK;
+  }
+
+  static void writeWord(uint16_t* address, const uint16_t value) noexcept {
+    FCTL3 = FWKEY;
+    FCTL1 = FWKEY | WRT;
+    *address = value;
+    while ((FCTL3 & BUSY) != 0) {
+    }
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY | LOCK;
+  }
+
+  /**
+   * Method to write the pending block. It is taken with the interruptions disabled, since the interruption can
+   * replace it, and their state is restored afterwards, so the main loop can also call it with them disabled.
+   * The DTC only writes the block again after the next one is completed, so it is only valid until then. If a block
+   * is completed during the copy, the copied block is counted as overwritten in the current segment.
+   */
+  void writePendingBlock() noexcept {
+    const unsigned short interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    const uint16_t* const block = pendingBlock;
+    blockSize = pendingSize;
+    pendingBlock = nullptr;
+    const uint16_t completedBeforeCopy = completedBlocks;
+    __set_interrupt_state(interruptState);
+    if (block == nullptr) {
+      return;
+    }
+
+    for (uint8_t sample = 0; sample < blockSize; sample++) {
+      if ((nextWord >= WORDS_PER_SEGMENT) && !openNextSegment()) {
+        return;
+      }
+      writeWord(getSegment(currentSegment) + nextWord, block[sample]);
+      nextWord++;
+      writtenSamples++;
+    }
+    if (completedBlocks != completedBeforeCopy) {
+      totalOverwrittenBlocks++;
+    }
+  }
+
+  /**
+   * Method to close the current segment and write the header of the next one
+   * @return false if there is no segment left
+   */
+  bool openNextSegment() noexcept {
+    if (sequence > 0) {
+      closeSegment();
+      const uint8_t nextSegment = static_cast<uint8_t>(currentSegment + 1);
+      if (nextSegment < NUMBER_OF_SEGMENTS) {
+        currentSegment = nextSegment;
+      } else if (loggerMode == FlashLoggerMode::WRAP_AROUND) {
+        currentSegment = 0;
+      } else {
+        capturing = false;
+        pendingBlock = nullptr;
+        return false;
+      }
+      if (sequence >= NUMBER_OF_SEGMENTS) {
+        // The segment was already written, since the logger wrapped around.
+        eraseSegment(getSegment(currentSegment));
+      }
+    }
+    // The dropped blocks are only counted by the interruption, so their samples are added to the index here.
+    segmentFirstDroppedBlock = totalDroppedBlocks;
+    segmentFirstOverwrittenBlock = totalOverwrittenBlocks;
+    const uint32_t firstSample = writtenSamples + static_cast<uint32_t>(segmentFirstDroppedBlock) * blockSize;
+    uint16_t* const segment = getSegment(currentSegment);
+    writeWord(segment + HEADER_MAGIC, MAGIC);
+    writeWord(segment + HEADER_SEQUENCE, sequence);
+    writeWord(segment + HEADER_FIRST_SAMPLE_LOW, static_cast<uint16_t>(firstSample));
+    writeWord(segment + HEADER_FIRST_SAMPLE_HIGH, static_cast<uint16_t>(firstSample >> 16));
+    writeWord(segment + HEADER_SAMPLE_RATE, sampleRate);
+    sequence++;
+    nextWord = HEADER_WORDS;
+    return true;
+  }
+
+  /**
+   * Method to write the number of dropped and overwritten blocks of the current segment, which are only known at
+   * its end
+   */
+  void closeSegment() noexcept {
+    if ((sequence == 0) || (getSegment(currentSegment)[HEADER_DROPPED_BLOCKS] != ERASED_WORD)) {
+      return;
+    }
+    writeWord(getSegment(currentSegment) + HEADER_DROPPED_BLOCKS,
+              static_cast<uint16_t>(totalDroppedBlocks - segmentFirstDroppedBlock));
+    writeWord(getSegment(currentSegment) + HEADER_OVERWRITTEN_BLOCKS,
+              static_cast<uint16_t>(totalOverwrittenBlocks - segmentFirstOverwrittenBlock));
+  }
+
+  /**
+   * Method to find the written segment with the lowest sequence. The segments are written in a ring, so the
+   * dump continues from it to the next ones.
+   */
+  uint8_t findOldestSegment() const noexcept {
+    uint8_t oldestSegment = 0;
+    uint16_t oldestSequence = 0xFFFF;
+    for (uint8_t segment = 0; segment < NUMBER_OF_SEGMENTS; segment++) {
+      const uint16_t* const header = getSegment(segment);
+      if ((header[HEADER_MAGIC] == MAGIC) && (header[HEADER_SEQUENCE] < oldestSequence)) {
+        oldestSequence = header[HEADER_SEQUENCE];
+        oldestSegment = segment;
+      }
+    }
+    return oldestSegment;
+  }
+
+  /**
+   * Method to get the number of samples of a segment, which end at the first erased word
+   */
+  uint16_t countSamples(const uint16_t* segment) const noexcept {
+    uint16_t numberOfSamples = 0;
+    while ((numberOfSamples < SAMPLES_PER_SEGMENT) && (segment[HEADER_WORDS + numberOfSamples] != ERASED_WORD)) {
+      numberOfSamples++;
+    }
+    return numberOfSamples;
+  }
+
+  /**
+   * Method to send the words of the dump that fit in the buffer of the Serial, so no byte is dropped
+   */
+  void sendDump() noexcept {
+    Serial& serial = Serial::getInstance();
+    while (serial.getFreeSpace() >= 2 * sizeof(uint16_t)) {
+      if (dumpedSegments >= NUMBER_OF_SEGMENTS) {
+        dumping = false;
+        return;
+      }
+      const uint8_t segmentIndex = static_cast<uint8_t>((dumpSegmentOffset + dumpedSegments) % NUMBER_OF_SEGMENTS);
+      const uint16_t* const segment = getSegment(segmentIndex);
+      if (segment[HEADER_MAGIC] != MAGIC) {
+        dumpedSegments++;
+        continue;
+      }
+      if (dumpWord == 0) {
+        dumpSamples = countSamples(segment);
+        serial.write(static_cast<char>(SYNC_FIRST_BYTE));
+        serial.write(static_cast<char>(SYNC_SECOND_BYTE));
+        crc = 0;
+      }
+      if (dumpWord < HEADER_WORDS) {
+        writeDumpWord(segment[dumpWord]);
+      } else if (dumpWord == HEADER_WORDS) {
+        writeDumpWord(dumpSamples);
+      } else {
+        writeDumpWord(segment[dumpWord - 1]);
+      }
+      dumpWord++;
+      if (dumpWord == FRAME_HEADER_WORDS + dumpSamples) {
+        serial.write(static_cast<char>(crc));
+        dumpWord = 0;
+        dumpedSegments++;
+      }
+    }
+  }
+
+  /**
+   * Sends a word and updates the CRC
+   */
+  void writeDumpWord(const uint16_t word) noexcept {
+    const uint8_t bytes[] = {static_cast<uint8_t>(word), static_cast<uint8_t>(word >> 8)};
+    for (const uint8_t byte : bytes) {
+      Serial::getInstance().write(static_cast<char>(byte));
+      crc = crc8Update(crc, byte);
+    }
+  }
+
+  uint16_t* const storage;                                 ///< First word of the reserved segments
+  uint16_t sampleRate = 0;                                 ///< Samples per second of the capture
+  FlashLoggerMode loggerMode = FlashLoggerMode::ONE_SHOT;  ///< What happens when every segment was written
+  uint8_t currentSegment = 0;                              ///< Segment being written
+  uint16_t nextWord = WORDS_PER_SEGMENT;                   ///< Next word of the current segment to be written
+  uint16_t sequence = 0;                                   ///< Sequence of the next segment to be opened
+  uint32_t writtenSamples = 0;                             ///< Samples written since the start
+  uint8_t blockSize = 0;                                   ///< Number of samples of the last block taken
+  volatile uint16_t totalDroppedBlocks = 0;                ///< Blocks dropped since the start
+  uint16_t segmentFirstDroppedBlock = 0;                   ///< Blocks dropped before the current segment was opened
+  volatile uint16_t completedBlocks = 0;                   ///< Blocks completed since the start, by the interruption
+  uint16_t totalOverwrittenBlocks = 0;                     ///< Blocks overwritten by the DTC while they were copied
+  uint16_t segmentFirstOverwrittenBlock = 0;               ///< Blocks overwritten before the current segment
+  const uint16_t* volatile pendingBlock = nullptr;         ///< Block waiting to be written, set by the interruption
+  volatile uint8_t pendingSize = 0;                        ///< Number of samples of the pending block
+  volatile bool capturing = false;                         ///< If the blocks are written to the flash
+  bool dumping = false;                                    ///< If the dump is being sent
+  uint8_t dumpSegmentOffset = 0;                           ///< Oldest segment, where the dump starts
+  uint8_t dumpedSegments = 0;                              ///< Number of segments already sent
+  uint16_t dumpWord = 0;                                   ///< Next word of the frame of the current segment
+  uint16_t dumpSamples = 0;                                ///< Number of samples of the current segment
+  uint8_t crc = 0;                                         ///< CRC of the current frame
+};
+}  // namespace Microtech
+
+#endif  // MICROTECH_FLASHLOGGER_HPP
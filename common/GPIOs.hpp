@@ -20,6 +20,7 @@
 #ifndef COMMON_GPIOS_HPP_
 #define COMMON_GPIOS_HPP_
 
+#include "LowPower.hpp"
 #include "helpers.hpp"
 
 #include <msp430g2553.h>
@@ -51,10 +52,19 @@ enum class IOResistor {
   PULL_UP
 };
 
+/**
+ * Enum representing the edge of the pin that triggers the interruption
+ */
+enum class IOEdge {
+  RISING = 0,  ///< Interruption when the pin goes from LOW to HIGH
+  FALLING,     ///< Interruption when the pin goes from HIGH to LOW
+};
+
 enum class IOFunctionality {
   GPIO = 0,
   TA0_COMPARE_OUT1,
   TA0_COMPARE_OUT2,
+  TIMER_CAPTURE_INPUT,  ///< CCIxA or CCIxB input of a timer: P1.1, P1.2 and P2.0 to P2.5
 };
 
 /**
@@ -77,6 +87,10 @@ enum class IOFunctionality {
  */
 class GPIORegisters {
   friend class IoHandleBase;
+  template<IOPort port, uint8_t... pins>
+  friend class PinGroup;
+  template<IOPort port>
+  friend class PortInterrupts;
 
 protected:
   constexpr GPIORegisters() {}
@@ -89,7 +103,7 @@ protected:
    *
    * @returns The reference to the respective PxDir register
    */
-  static constexpr volatile uint8_t& getPxDir(IOPort port) noexcept {
+  static constexpr volatile RegisterType<uint8_t>& getPxDir(IOPort port) noexcept {
     switch (port) {
       case IOPort::PORT_1: return P1DIR;
       case IOPort::PORT_2: return P2DIR;
@@ -105,7 +119,7 @@ protected:
    *
    * @returns The reference to the respective PxSel register
    */
-  static constexpr volatile uint8_t& getPxSel(IOPort port) noexcept {
+  static constexpr volatile RegisterType<uint8_t>& getPxSel(IOPort port) noexcept {
     switch (port) {
       case IOPort::PORT_1: return P1SEL;
       case IOPort::PORT_2: return P2SEL;
@@ -121,7 +135,7 @@ protected:
    *
    * @returns The reference to the respective PxSel2 register
    */
-  static constexpr volatile uint8_t& getPxSel2(IOPort port) noexcept {
+  static constexpr volatile RegisterType<uint8_t>& getPxSel2(IOPort port) noexcept {
     switch (port) {
       case IOPort::PORT_1: return P1SEL2;
       case IOPort::PORT_2: return P2SEL2;
@@ -137,7 +151,7 @@ protected:
    *
    * @returns The reference to the respective PxRen register
    */
-  static constexpr volatile uint8_t& getPxRen(IOPort port) noexcept {
+  static constexpr volatile RegisterType<uint8_t>& getPxRen(IOPort port) noexcept {
     switch (port) {
       case IOPort::PORT_1: return P1REN;
       case IOPort::PORT_2: return P2REN;
@@ -153,7 +167,7 @@ protected:
    *
    * @returns The reference to the respective PxIn register
    */
-  static constexpr volatile uint8_t& getPxIn(IOPort port) noexcept {
+  static constexpr volatile RegisterType<uint8_t>& getPxIn(IOPort port) noexcept {
     switch (port) {
       case IOPort::PORT_1: return P1IN;
       case IOPort::PORT_2: return P2IN;
@@ -169,7 +183,7 @@ protected:
    *
    * @returns The reference to the respective PxOut register
    */
-  static constexpr volatile uint8_t& getPxOut(IOPort port) noexcept {
+  static constexpr volatile RegisterType<uint8_t>& getPxOut(IOPort port) noexcept {
     switch (port) {
       case IOPort::PORT_1: return P1OUT;
       case IOPort::PORT_2: return P2OUT;
@@ -185,7 +199,7 @@ protected:
    *
    * @returns The reference to the respective PxIe register
    */
-  static constexpr volatile uint8_t& getPxIe(IOPort port) noexcept {
+  static constexpr volatile RegisterType<uint8_t>& getPxIe(IOPort port) noexcept {
     switch (port) {
       case IOPort::PORT_1: return P1IE;
       case IOPort::PORT_2: return P2IE;
@@ -203,7 +217,7 @@ protected:
    *
    * @returns The reference to the respective PxIes register
    */
-  static constexpr volatile uint8_t& getPxIes(IOPort port) noexcept {
+  static constexpr volatile RegisterType<uint8_t>& getPxIes(IOPort port) noexcept {
     switch (port) {
       case IOPort::PORT_1: return P1IES;
       case IOPort::PORT_2: return P2IES;
@@ -221,7 +235,7 @@ protected:
    *
    * @returns The reference to the respective PxIfg register
    */
-  static constexpr volatile uint8_t& getPxIfg(IOPort port) noexcept {
+  static constexpr volatile RegisterType<uint8_t>& getPxIfg(IOPort port) noexcept {
     switch (port) {
       case IOPort::PORT_1: return P1IFG;
       case IOPort::PORT_2: return P2IFG;
@@ -267,18 +281,19 @@ public:
 
   /**
    * Method to enable an interrupt at the pin.
-   * At the moment hard-coded to be High/Low edge
+   * The interruption calls the handler of the pin registered in the PortInterrupts table of the port,
+   * or, if the application doesn't use the table, its own interruption of the port.
    *
-   * @note it can be improved in the future to take the edge as a parameter.
+   * @param edge Edge of the pin that triggers the interruption
    */
-  void enableInterrupt() const noexcept {
-    // somehow I need to find a way to wrap the pin interrupt here and
-    // add a callback. But for now we just enable the pin interrupt and
-    // the rest has to be handled from the outside
-    setRegisterBits(PxIes, mBitMask);    // High /Low - Edge
+  void enableInterrupt(const IOEdge edge = IOEdge::FALLING) const noexcept {
+    if (edge == IOEdge::FALLING) {
+      setRegisterBits(PxIes, mBitMask);  // High /Low - Edge
+    } else {
+      resetRegisterBits(PxIes, mBitMask);  // Low /High - Edge
+    }
     resetRegisterBits(PxIfg, mBitMask);  // Clear interrupt flag
     setRegisterBits(PxIe, mBitMask);     // Enable interrupt
-
   }
 
   void disableInterrupt() const noexcept {
@@ -324,12 +339,20 @@ public:
           return true;
         }
         return false;
+      case IOFunctionality::TIMER_CAPTURE_INPUT:
+        // The pin must also be an input, which is done by the init of the InputHandle.
+        if ((port == IOPort::PORT_1 && (mPin == 1 || mPin == 2)) || (port == IOPort::PORT_2 && mPin <= 5)) {
+          setRegisterBits(PxSel, mBitMask);
+          resetRegisterBits(PxSel2, mBitMask);
+          return true;
+        }
+        return false;
     };
 
     return false;
   }
 protected:
-  using RegisterRef = volatile uint8_t&;
+  using RegisterRef = volatile RegisterType<uint8_t>&;
   // Constructor is protected, so it cannot be constructed by anyone else other than its
   // child
   explicit constexpr IoHandleBase(IOPort desiredPort, uint8_t desiredPin)
@@ -438,6 +461,25 @@ public:
   constexpr void toggle() const noexcept {
     toggleRegisterBits(PxOut, mBitMask);
   }
+
+  /**
+   * Sets the state of this pin and of another output at once.
+   * If both are on the same port, there is a single write to PxOut instead of one read-modify-write per pin.
+   *
+   * @param state Desired state of this pin.
+   * @param other The other output.
+   * @param otherState Desired state of the other output.
+   */
+  constexpr void setStates(const bool state, const OutputHandle& other, const bool otherState) const noexcept {
+    if (other.port != port) {
+      setState(state);
+      other.setState(otherState);
+      return;
+    }
+    const uint8_t mask = mBitMask | other.mBitMask;
+    const uint8_t value = (state ? mBitMask : 0) | (otherState ? other.mBitMask : 0);
+    PxOut = (PxOut & ~mask) | value;
+  }
 };
 
 /**
@@ -477,6 +519,130 @@ public:
   // also has that functionality
 };
 
+/**
+ * Class that drives several output pins of the same port at once.
+ * The masks of the pins are merged in compile time, so setting, clearing or writing every pin of the group
+ * is a single access to PxOut, instead of one read-modify-write per pin.
+ *  @code
+ *      using Leds = PinGroup<IOPort::PORT_3, 0, 1, 2>;
+ *      Leds::init();
+ *      Leds::set();
+ *      Leds::write(BIT0 + BIT2);  // P3.0 and P3.2 HIGH, P3.1 LOW
+ *  @endcode
+ *
+ * @tparam port IOPort of every pin of the group
+ * @tparam pins Pins of the group
+ */
+template<IOPort port, uint8_t... pins>
+class PinGroup {
+  /**
+   * Merges the masks of the pins
+   */
+  static constexpr uint8_t mergeMasks() noexcept {
+    uint8_t mask = 0;
+    using Expander = uint8_t[];
+    (void)Expander{0, (mask |= static_cast<uint8_t>(0x01 << pins))...};
+    return mask;
+  }
+
+  /**
+   * Counts the pins set in the mask
+   */
+  static constexpr uint8_t countPins(const uint8_t mask) noexcept {
+    return mask == 0 ? 0 : (mask & 0x01) + countPins(mask >> 1);
+  }
+
+  /**
+   * Checks if every pin exists in a port
+   */
+  static constexpr bool arePinsValid() noexcept {
+    bool valid = true;
+    using Expander = bool[];
+    (void)Expander{true, (valid = valid && (pins <= 7))...};
+    return valid;
+  }
+
+public:
+  static_assert(sizeof...(pins) > 0, "A pin group must have at least one pin");
+  static_assert(arePinsValid(), "Cannot add a pin higher than 7 to the group");
+  static_assert(countPins(mergeMasks()) == sizeof...(pins), "A pin cannot be more than once in the group");
+
+  static constexpr uint8_t MASK = mergeMasks();  ///< Mask of every pin of the group
+
+  PinGroup() = delete;
+
+  /**
+   * Sets every pin of the group as an output GPIO
+   */
+  static constexpr void init() noexcept {
+    setRegisterBits(GPIORegisters::getPxDir(port), MASK);
+    resetRegisterBits(GPIORegisters::getPxSel(port), MASK);
+    resetRegisterBits(GPIORegisters::getPxSel2(port), MASK);
+  }
+
+  /**
+   * Sets every pin of the group to IOState::HIGH
+   */
+  static constexpr void set() noexcept {
+    setRegisterBits(GPIORegisters::getPxOut(port), MASK);
+  }
+
+  /**
+   * Sets every pin of the group to IOState::LOW
+   */
+  static constexpr void clear() noexcept {
+    resetRegisterBits(GPIORegisters::getPxOut(port), MASK);
+  }
+
+  /**
+   * Toggles every pin of the group
+   */
+  static constexpr void toggle() noexcept {
+    toggleRegisterBits(GPIORegisters::getPxOut(port), MASK);
+  }
+
+  /**
+   * Writes the pins of the group. The other pins of the port are not changed.
+   * @param value Value with the bits at the positions of the pins, like BIT0 for pin 0.
+   */
+  static constexpr void write(const uint8_t value) noexcept {
+    volatile RegisterType<uint8_t>& PxOut = GPIORegisters::getPxOut(port);
+    PxOut = (PxOut & ~MASK) | (value & MASK);
+  }
+};
+
+/**
+ * Identifies a pin in compile time, so the pins can be merged in a PinGroup with
+ * PinGroupOf<GpioPin<IOPort::PORT_2, 2>, GpioPin<IOPort::PORT_2, 3>>.
+ */
+template<IOPort pinPort, uint8_t pinNumber>
+struct GpioPin {
+  static constexpr IOPort port = pinPort;
+  static constexpr uint8_t pin = pinNumber;
+};
+
+/**
+ * Helper to create a PinGroup from several GpioPin. Pins from different ports cannot be merged.
+ */
+template<class FIRST_PIN, class... OTHER_PINS>
+struct PinGroupMerger {
+  /**
+   * Checks if every pin is on the port of the first pin
+   */
+  static constexpr bool isSamePort() noexcept {
+    bool samePort = true;
+    using Expander = bool[];
+    (void)Expander{true, (samePort = samePort && (OTHER_PINS::port == FIRST_PIN::port))...};
+    return samePort;
+  }
+  static_assert(isSamePort(), "Every pin of a PinGroup must be on the same port");
+
+  using Type = PinGroup<FIRST_PIN::port, FIRST_PIN::pin, OTHER_PINS::pin...>;
+};
+
+template<class... PINS>
+using PinGroupOf = typename PinGroupMerger<PINS...>::Type;
+
 /**
  * This is a actually serves as a namespace to keep some GPIO classes together
  * and hides away some non-public types.
@@ -510,5 +676,134 @@ public:
     return handle;
   }
 };
+
+/**
+ * Entry of the interruption table of a port. Entries can be created with makePinInterruptHandler.
+ */
+struct PinInterruptHandler {
+  void (*callback)(void* context);  ///< Function called when the pin triggers the interruption
+  void* context;                    ///< Pointer passed to the callback
+};
+
+template<void (*CALLBACK)()>
+void invokePinFunction(void* /*context*/) {
+  CALLBACK();
+}
+
+template<class CLASS_TYPE, void (CLASS_TYPE::*METHOD)()>
+void invokePinMethod(void* context) {
+  (static_cast<CLASS_TYPE*>(context)->*METHOD)();
+}
+
+/**
+ * Creates the entry of the interruption table that calls a function.
+ * @tparam CALLBACK Function called from the interruption
+ */
+template<void (*CALLBACK)()>
+constexpr PinInterruptHandler makePinInterruptHandler() noexcept {
+  return {&invokePinFunction<CALLBACK>, nullptr};
+}
+
+/**
+ * Creates the entry of the interruption table that calls a method of an object.
+ * @tparam CLASS_TYPE Class of the object
+ * @tparam METHOD Method called from the interruption
+ * @param object Object whose method is called. For the table to be constant, it has to be a global object.
+ */
+template<class CLASS_TYPE, void (CLASS_TYPE::*METHOD)()>
+constexpr PinInterruptHandler makePinInterruptHandler(CLASS_TYPE& object) noexcept {
+  return {&invokePinMethod<CLASS_TYPE, METHOD>, &object};
+}
+
+/**
+ * Dispatches the interruption of a port to the handlers of the pins.
+ *
+ * Instead of writing its own interruption and decoding PxIFG, the application defines the table of the port,
+ * which is constant, so it stays in the flash, and defines MICROTECH_PORT1_INTERRUPTS or
+ * MICROTECH_PORT2_INTERRUPTS before including any header, so this header defines the interruption of the port:
+ *  @code
+ *      #define MICROTECH_PORT1_INTERRUPTS
+ *      #include "GPIOs.hpp"
+ *      ...
+ *      template<>
+ *      const PinInterruptHandler PortInterrupts<IOPort::PORT_1>::HANDLERS[8] = {
+ *          {}, {}, {}, makePinInterruptHandler<&buttonPressed>(), {}, {}, {}, {}};
+ *  @endcode
+ *
+ * The index of the table is the pin. Several pins can share the same handler, and the interruptions of pins
+ * without handler are only acknowledged.
+ *
+ * @tparam port IOPort of the table. Only PORT_1 and PORT_2 support interruptions.
+ */
+template<IOPort port>
+class PortInterrupts {
+  static_assert(port == IOPort::PORT_1 || port == IOPort::PORT_2, "Only Port 1 and 2 support interruptions");
+
+public:
+  PortInterrupts() = delete;
+
+  static const PinInterruptHandler HANDLERS[8];  ///< Handler of each pin. It has to be defined by the application.
+
+  /**
+   * Calls the handlers of the pending pins, from the lowest pin to the highest.
+   * The flag of each pin is cleared right before its handler is called, so an edge that happens while the
+   * handler runs triggers the interruption again. Flags of pins whose interruption is disabled are kept.
+   */
+  static void dispatch() noexcept {
+    volatile RegisterType<uint8_t>& PxIfg = GPIORegisters::getPxIfg(port);
+    uint8_t pending = PxIfg & GPIORegisters::getPxIe(port);
+    while (pending != 0) {
+      // Priority encoder: a lookup of the lowest pending pin in the lower nibble, or else in the upper nibble.
+      const uint8_t pin = (pending & 0x0F) ? LOWEST_PIN[pending & 0x0F] : (4 + LOWEST_PIN[pending >> 4]);
+      const uint8_t bitMask = static_cast<uint8_t>(0x01 << pin);
+      pending &= ~bitMask;
+      resetRegisterBits(PxIfg, bitMask);
+      const PinInterruptHandler& handler = HANDLERS[pin];
+      if (handler.callback != nullptr) {
+        handler.callback(handler.context);
+      }
+    }
+  }
+
+private:
+  /**
+   * Lowest set bit of each nibble. The entry 0 is never used.
+   */
+  static constexpr uint8_t LOWEST_PIN[16] = {0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0};
+};
+
+template<IOPort port>
+constexpr uint8_t PortInterrupts<port>::LOWEST_PIN[16];
 } /* namespace Microtech */
+
+#ifdef MICROTECH_PORT1_INTERRUPTS
+// Declares the table defined by the application, so it can be used by the interruption before being defined.
+template<>
+const Microtech::PinInterruptHandler Microtech::PortInterrupts<Microtech::IOPort::PORT_1>::HANDLERS[8];
+
+// Port 1 interrupt vector
+#pragma vector = PORT1_VECTOR
+__interrupt void PORT1_ISR(void) {
+  Microtech::PortInterrupts<Microtech::IOPort::PORT_1>::dispatch();
+  if (Microtech::LowPower::isWakeUpRequested()) {
+    __bic_SR_register_on_exit(LPM4_bits);
+  }
+}
+#endif
+
+#ifdef MICROTECH_PORT2_INTERRUPTS
+// Declares the table defined by the application, so it can be used by the interruption before being defined.
+template<>
+const Microtech::PinInterruptHandler Microtech::PortInterrupts<Microtech::IOPort::PORT_2>::HANDLERS[8];
+
+// Port 2 interrupt vector
+#pragma vector = PORT2_VECTOR
+__interrupt void PORT2_ISR(void) {
+  Microtech::PortInterrupts<Microtech::IOPort::PORT_2>::dispatch();
+  if (Microtech::LowPower::isWakeUpRequested()) {
+    __bic_SR_register_on_exit(LPM4_bits);
+  }
+}
+#endif
+
 #endif /* COMMON_GPIOS_HPP_ */
@@ -0,0 +1,263 @@
+/******************************************************************************
+ * @file                    Jukebox.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains the playback engine of songs with the PWM
+ *
+ * Description: Each note of a song is a single byte in the flash: the lowest
+ *              5 bits are the index of the note and the highest 3 bits are its
+ *              duration minus 1, in ticks of the playback. The periods of the
+ *              notes come from a table calculated in compile time from the
+ *              frequencies of the equal temperament, so there is nothing else
+ *              to store per note.
+ *
+ *              Usage:
+ *                constexpr PackedNote JINGLE_BELLS[] = {
+ *                    packNote(Note::A4, 2), packNote(Note::A4, 2), packNote(Note::A4, 4), ...};
+ *                constexpr Song PLAYLIST[] = {makeSong(JINGLE_BELLS)};
+ *                Jukebox jukebox(pwm, PLAYLIST);
+ *                ...
+ *                jukebox.play(0);
+ *                ...
+ *                jukebox.tick();  // From a periodic task, e.g. every 125ms
+ ******************************************************************************/
+#ifndef MICROTECH_JUKEBOX_HPP
+#define MICROTECH_JUKEBOX_HPP
+
+#include "Pwm.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Notes that can be played, from C4 to F#6. S means sharp, so the flats are the sharp of the previous note,
+ * e.g. Bb4 is AS4.
+ */
+enum class Note : uint8_t {
+  REST = 0,  ///< Silence
+  C4,
+  CS4,
+  D4,
+  DS4,
+  E4,
+  F4,
+  FS4,
+  G4,
+  GS4,
+  A4,
+  AS4,
+  B4,
+  C5,
+  CS5,
+  D5,
+  DS5,
+  E5,
+  F5,
+  FS5,
+  G5,
+  GS5,
+  A5,
+  AS5,
+  B5,
+  C6,
+  CS6,
+  D6,
+  DS6,
+  E6,
+  F6,
+  FS6,
+};
+
+using PackedNote = uint8_t;  ///< Note and duration packed in a single byte
+
+static constexpr uint8_t NOTE_INDEX_BITS = 5;
+static constexpr uint8_t NOTE_INDEX_MASK = (1U << NOTE_INDEX_BITS) - 1;
+static constexpr uint8_t NUMBER_OF_NOTES = NOTE_INDEX_MASK + 1;
+static constexpr uint8_t MAX_NOTE_TICKS = 8;  ///< Longest duration of a single note. Longer notes can be repeated.
+
+/**
+ * Packs a note and its duration in a single byte
+ * @param note Note to be played
+ * @param ticks Duration of the note in ticks of the playback, from 1 to MAX_NOTE_TICKS
+ * @return The packed note
+ */
+constexpr PackedNote packNote(const Note note, const uint8_t ticks) noexcept {
+  return static_cast<PackedNote>(((ticks - 1) << NOTE_INDEX_BITS) | static_cast<uint8_t>(note));
+}
+
+/**
+ * Song stored in the flash
+ */
+struct Song {
+  const PackedNote* notes;  ///< Notes of the song
+  uint16_t numberOfNotes;   ///< Number of notes of the song
+};
+
+/**
+ * Creates a song from an array of packed notes, so the number of notes is deduced.
+ */
+template<size_t NUMBER_OF_NOTES_IN_SONG>
+constexpr Song makeSong(const PackedNote (&notes)[NUMBER_OF_NOTES_IN_SONG]) noexcept {
+  static_assert(NUMBER_OF_NOTES_IN_SONG <= 0xFFFF, "The song has too many notes");
+  return {&notes[0], static_cast<uint16_t>(NUMBER_OF_NOTES_IN_SONG)};
+}
+
+/**
+ * Table with the compare values of the timer for the period of each note. It is calculated in compile time.
+ * @tparam CLK_DIV Divider of the clock of the timer
+ * @tparam SOURCE_CLK_FREQUENCY_HZ Frequency of the source clock of the timer
+ */
+template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ>
+class NotePeriodTable {
+public:
+  constexpr NotePeriodTable() : compareValues() {
+    constexpr double C4_FREQUENCY_HZ = 261.6255653;
+    constexpr double SEMITONE_RATIO = 1.0594630943592953;  // 2^(1/12)
+    constexpr double TIMER_FREQUENCY_HZ = static_cast<double>(SOURCE_CLK_FREQUENCY_HZ) / CLK_DIV;
+    double frequency = C4_FREQUENCY_HZ;
+    compareValues[static_cast<uint8_t>(Note::REST)] = 0;  // Stops the PWM
+    for (uint8_t index = static_cast<uint8_t>(Note::C4); index < NUMBER_OF_NOTES; index++) {
+      const double timerCounts = TIMER_FREQUENCY_HZ / frequency;
+      compareValues[index] = static_cast<uint16_t>(timerCounts + 0.5) - 1;
+      frequency *= SEMITONE_RATIO;
+    }
+  }
+
+  /**
+   * Gets the compare value of the period of a packed note
+   */
+  constexpr uint16_t getCompareValue(const PackedNote packedNote) const noexcept {
+    return compareValues[packedNote & NOTE_INDEX_MASK];
+  }
+
+private:
+  uint16_t compareValues[NUMBER_OF_NOTES];
+};
+
+/**
+ * Class that plays the songs of a playlist with the PWM.
+ * Setting a note is only a lookup in the table and a write of CCR0, so there is no template instantiation and no
+ * heap allocation per note.
+ */
+class Jukebox {
+public:
+  /**
+   * Constructor
+   * @param pwmOutput PWM connected to the piezo. Its duty cycle is kept while playing.
+   * @param songs Playlist in the flash
+   */
+  template<size_t PLAYLIST_SIZE>
+  constexpr Jukebox(Pwm& pwmOutput, const Song (&songs)[PLAYLIST_SIZE])
+    : pwm(pwmOutput), playlist(&songs[0]), playlistSize(static_cast<uint8_t>(PLAYLIST_SIZE)) {
+    static_assert(PLAYLIST_SIZE <= 0xFF, "The playlist has too many songs");
+  }
+
+  /**
+   * Starts to play a song from its beginning. The first note is played at the next tick.
+   * @param songIndex Index of the song in the playlist
+   * @return false if the song doesn't exist
+   */
+  bool play(const uint8_t songIndex) noexcept {
+    if (songIndex >= playlistSize) {
+      return false;
+    }
+    currentSong = &playlist[songIndex];
+    nextNoteIndex = 0;
+    remainingTicks = 0;
+    playing = true;
+    return true;
+  }
+
+  /**
+   * Pauses the song. The PWM is stopped until resume is called.
+   */
+  void pause() noexcept {
+    if (playing) {
+      playing = false;
+      pwm.stop();
+    }
+  }
+
+  /**
+   * Resumes a paused song from the note where it was paused
+   */
+  void resume() noexcept {
+    if (!playing && currentSong != nullptr) {
+      playing = true;
+      pwm.setPeriodCompareValue(currentCompareValue);
+    }
+  }
+
+  /**
+   * Stops the song. It can only be resumed by playing it again.
+   */
+  void stop() noexcept {
+    playing = false;
+    currentSong = nullptr;
+    pwm.stop();
+  }
+
+  /**
+   * Advances the playback by one tick. It has to be called periodically, e.g. by a task of the timer.
+   * @return true if the song is still playing
+   */
+  bool tick() noexcept {
+    if (!playing) {
+      return false;
+    }
+    if (remainingTicks == 0) {
+      if (nextNoteIndex >= currentSong->numberOfNotes) {
+        stop();
+        return false;
+      }
+      const PackedNote packedNote = currentSong->notes[nextNoteIndex++];
+      currentCompareValue = getNoteCompareValue(packedNote);
+      pwm.setPeriodCompareValue(currentCompareValue);
+      remainingTicks = static_cast<uint8_t>((packedNote >> NOTE_INDEX_BITS) + 1);
+    }
+    remainingTicks--;
+    return true;
+  }
+
+  /**
+   * Method to know if a song is being played
+   * @return true if a song is being played and not paused
+   */
+  bool isPlaying() const noexcept {
+    return playing;
+  }
+
+  /**
+   * Method to get the size of the playlist
+   * @return Number of songs in the playlist
+   */
+  uint8_t getPlaylistSize() const noexcept {
+    return playlistSize;
+  }
+
+private:
+  /**
+   * Gets the compare value of the period of a packed note for the timer of the Pwm.
+   * The table is a constant, so it is stored in the flash and has no initialization at runtime.
+   */
+  static uint16_t getNoteCompareValue(const PackedNote packedNote) noexcept {
+    static constexpr NotePeriodTable<Pwm::TIMER_CLK_DIV, Pwm::TIMER_SOURCE_CLK_FREQUENCY_HZ> NOTE_PERIODS{};
+    return NOTE_PERIODS.getCompareValue(packedNote);
+  }
+
+  Pwm& pwm;                           ///< PWM connected to the piezo
+  const Song* const playlist;         ///< Songs that can be played
+  const uint8_t playlistSize;         ///< Number of songs of the playlist
+  const Song* currentSong = nullptr;  ///< Song being played, nullptr if stopped
+  uint16_t nextNoteIndex = 0;         ///< Index of the next note of the song
+  uint8_t remainingTicks = 0;         ///< Ticks until the next note
+  uint16_t currentCompareValue = 0;   ///< Compare value of the note being played, used to resume
+  bool playing = false;               ///< If a song is being played and not paused
+};
+}  // namespace Microtech
+
+#endif  // MICROTECH_JUKEBOX_HPP
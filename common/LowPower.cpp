@@ -0,0 +1,7 @@
+#include "LowPower.hpp"
+
+namespace Microtech {
+
+volatile bool LowPower::wakeUpRequested = false;
+
+}  // namespace Microtech
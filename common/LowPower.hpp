@@ -0,0 +1,112 @@
+/******************************************************************************
+ * @file                    LowPower.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains abstraction of the low power modes
+ *
+ * Description: Instead of having the CPU busy waiting in the main loop for the next
+ *              interruption, the main loop can call the idle hook of the scheduler
+ *              (see Timer.hpp) which uses this header to sleep in the deepest low power
+ *              mode that still keeps the clocks needed by the peripherals running.
+ *
+ *              Interruptions can request the main loop to wake up, so it can perform
+ *              some work before going back to sleep.
+ ******************************************************************************/
+#ifndef MICROTECH_LOWPOWER_HPP
+#define MICROTECH_LOWPOWER_HPP
+
+#include <msp430g2553.h>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Enum representing which clock has to keep running while the CPU is sleeping.
+ * The values are ordered, so a higher value also keeps the clocks of the lower ones running:
+ * in LPM0 (needed by SMCLK) the ACLK also keeps running.
+ */
+enum class ClockRequirement : uint8_t {
+  NONE = 0,  ///< No clock needed. Only external events can wake up the CPU (LPM4).
+  ACLK,      ///< ACLK is needed (LPM3).
+  SMCLK,     ///< SMCLK is needed (LPM0).
+};
+
+/**
+ * Helper function to combine two clock requirements.
+ * @return the requirement that needs more clocks running.
+ */
+constexpr ClockRequirement combineClockRequirements(const ClockRequirement first,
+                                                    const ClockRequirement second) noexcept {
+  return first > second ? first : second;
+}
+
+/**
+ * Class to enter and leave the low power modes of the MSP430.
+ */
+class LowPower {
+public:
+  LowPower() = delete;
+
+  /**
+   * Method to get the status register bits of the deepest low power mode that keeps the required clock running.
+   * It is evaluated in compile time when the requirement is known.
+   */
+  static constexpr uint16_t getLowPowerModeBits(const ClockRequirement requirement) noexcept {
+    switch (requirement) {
+      case ClockRequirement::SMCLK: return LPM0_bits;
+      case ClockRequirement::ACLK: return LPM3_bits;
+      case ClockRequirement::NONE: return LPM4_bits;
+    }
+    return LPM0_bits;  // It will actually never get here. But it is needed due to the compiler warning
+  }
+
+  /**
+   * Method to put the CPU to sleep. The interruptions are globally enabled, since otherwise
+   * the CPU would never wake up.
+   * The method only returns after an interruption requested to wake up the main loop.
+   * If the request already happened before calling this method, it returns immediately.
+   *
+   * @param requirement The clock that has to keep running while sleeping.
+   */
+  static void enter(const ClockRequirement requirement) noexcept {
+    // Interruptions are disabled while checking the flag, otherwise a request could happen between
+    // the check and going to sleep, and then it would only be handled after the next interruption.
+    __disable_interrupt();
+    if (!wakeUpRequested) {
+      // Enables the interruptions and goes to sleep in the same instruction.
+      __bis_SR_register(getLowPowerModeBits(requirement) + GIE);
+    } else {
+      __enable_interrupt();
+    }
+    wakeUpRequested = false;
+  }
+
+  /**
+   * Method to be called from within an interruption (e.g. a task callback) so the main loop
+   * is woken up when the interruption returns.
+   */
+  static void requestWakeUp() noexcept {
+    wakeUpRequested = true;
+  }
+
+  /**
+   * Method called by the interruption service routines to know if the main loop must be woken up.
+   * If so, the ISR has to call __bic_SR_register_on_exit(LPM4_bits), since it only works from within
+   * the interruption function itself.
+   *
+   * @return If the ISR has to clear the low power mode bits when returning.
+   */
+  static bool isWakeUpRequested() noexcept {
+    return wakeUpRequested;
+  }
+
+private:
+  static volatile bool wakeUpRequested;  ///< If an interruption requested that the main loop wakes up
+};
+
+}  // namespace Microtech
+
+#endif  // MICROTECH_LOWPOWER_HPP
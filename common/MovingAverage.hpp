@@ -2,15 +2,87 @@
 #define MICROTECH_MOVINGAVERAGE_HPP
 
 #include <cstdint>
+#include <type_traits>
 
 namespace Microtech {
 
+/**
+ * Divides the sum of a moving average by the number of samples, resolved in compile time.
+ * The MSP430G2553 has no hardware divider, so a division of the sum is a software routine of hundreds of cycles.
+ * When the number of samples is a power of two, the division is a shift. Otherwise it is a multiplication by the
+ * reciprocal, which is exact for every sum of numSamples inputs.
+ * There is no hardware multiplier either, so the product is kept as small as the inputs allow: if it fits in 32 bits,
+ * e.g. for the 10 bits of the ADC10 and less than 32 samples, it is a software multiplication of 32 bits, about 160
+ * cycles against about 420 of the division of 32 bits. Otherwise it is a widening multiplication of 32 by 32 bits to
+ * 64 bits, never one of 64 by 64 bits, which would cost more than the division.
+ * @tparam numSamples Number of samples of the average, the divisor
+ * @tparam INPUT_TYPE Type of the inputs
+ * @tparam SUM_TYPE Type of the sum
+ * @tparam INPUT_BITS Number of bits used by the inputs, used to know the biggest possible sum
+ */
+template<uint8_t numSamples, class INPUT_TYPE, class SUM_TYPE, uint8_t INPUT_BITS = 8 * sizeof(INPUT_TYPE),
+         bool IS_POWER_OF_TWO = ((numSamples & (numSamples - 1)) == 0)>
+class AverageDivider {
+  /**
+   * Calculates the number of bits needed to represent values up to value - 1.
+   */
+  static constexpr uint8_t ceilLog2(uint64_t value, uint8_t bits = 0) {
+    return (uint64_t(1) << bits) >= value ? bits : ceilLog2(value, bits + 1);
+  }
+
+  static constexpr uint8_t SAMPLES_BITS = ceilLog2(numSamples);
+  /// Every sum is smaller than 2^SUM_BITS, since it is at most numSamples times the maximum input.
+  static constexpr uint8_t SUM_BITS = INPUT_BITS + SAMPLES_BITS;
+  static constexpr uint8_t SHIFT = SUM_BITS + SAMPLES_BITS;
+  /// Reciprocal of the number of samples, rounded up, multiplied by 2^SHIFT
+  static constexpr uint64_t RECIPROCAL = ((uint64_t(1) << SHIFT) + numSamples - 1) / numSamples;
+  static constexpr uint8_t PRODUCT_BITS = SUM_BITS + ceilLog2(RECIPROCAL + 1);
+  static_assert(SUM_BITS <= 32 && RECIPROCAL <= UINT32_MAX,
+                "Error: the multiplication by the reciprocal does not fit in 32 by 32 bits.");
+  /// Both factors have 32 bits, so a product of 64 bits is a widening multiplication, not one of 64 by 64 bits.
+  using ProductType = typename std::conditional<(PRODUCT_BITS <= 32), uint32_t, uint64_t>::type;
+
+public:
+  /**
+   * Divides the sum by the number of samples
+   * @param sum the sum to be divided, smaller than 2^SUM_BITS
+   * @return sum / numSamples, rounded down
+   */
+  static constexpr SUM_TYPE divide(const SUM_TYPE sum) noexcept {
+    return static_cast<SUM_TYPE>((static_cast<ProductType>(static_cast<uint32_t>(sum)) *
+                                  static_cast<uint32_t>(RECIPROCAL)) >> SHIFT);
+  }
+};
+
+/**
+ * Specialization for a number of samples that is a power of two, where the division is a shift.
+ */
+template<uint8_t numSamples, class INPUT_TYPE, class SUM_TYPE, uint8_t INPUT_BITS>
+class AverageDivider<numSamples, INPUT_TYPE, SUM_TYPE, INPUT_BITS, true> {
+  static constexpr uint8_t log2(uint16_t value) {
+    return value <= 1 ? 0 : 1 + log2(value >> 1);
+  }
+
+public:
+  /**
+   * Divides the sum by the number of samples
+   * @param sum the sum to be divided
+   * @return sum / numSamples, rounded down
+   */
+  static constexpr SUM_TYPE divide(const SUM_TYPE sum) noexcept {
+    return sum >> log2(numSamples);
+  }
+};
+
 /**
  * Class implements a simple moving average. of the equation:
  * N = number of samples
  * average[n+1] = average[n] + input[n+1] - input[n+1-N]
+ * @tparam INPUT_BITS Number of bits used by the inputs, e.g. 10 for the ADC10. Fewer bits make the division cheaper
+ *                    when the number of samples is not a power of two, see AverageDivider.
  */
-template<uint8_t numSamples, class INPUT_TYPE = uint16_t, class SUM_TYPE = uint32_t>
+template<uint8_t numSamples, class INPUT_TYPE = uint16_t, class SUM_TYPE = uint32_t,
+         uint8_t INPUT_BITS = 8 * sizeof(INPUT_TYPE)>
 class SimpleMovingAverage {
   static_assert(SUM_TYPE(0) < SUM_TYPE(-1),
                 "Error: sum data type should be unsigned.");  // Check that `sum_t` is an unsigned type
@@ -41,7 +113,7 @@ public:
     // but if it is 234.6, when adding 0,5 it is 235.1 and it will be 235.
     constexpr SUM_TYPE halfNumSamples = (numSamples / 2);
 
-    SUM_TYPE retVal = (sum + halfNumSamples) / numSamples;
+    SUM_TYPE retVal = AverageDivider<numSamples, INPUT_TYPE, SUM_TYPE, INPUT_BITS>::divide(sum + halfNumSamples);
     return static_cast<INPUT_TYPE>(retVal);
   }
 
@@ -50,5 +122,95 @@ private:
   INPUT_TYPE previousInputs[numSamples] = {};  ///< Holds the last numSamples to perform the moving average
   SUM_TYPE sum = 0;                            ///< Holds the current sum of the previousInputs.
 };
+
+/**
+ * Class implements an exponential moving average (first order IIR) filter of the equation:
+ * average[n+1] = average[n] + (input[n+1] - average[n]) / 2^SHIFT
+ *
+ * The division by a power of two is a shift, so no multiplication or division is needed.
+ * The average is kept with SHIFT extra fractional bits, so small input changes are not lost.
+ * @tparam SHIFT Defines the weight of a new sample (1/2^SHIFT).
+ */
+template<uint8_t SHIFT, class INPUT_TYPE = uint16_t, class SUM_TYPE = uint32_t>
+class ExponentialMovingAverage {
+  static_assert(SUM_TYPE(0) < SUM_TYPE(-1),
+                "Error: sum data type should be unsigned.");  // Check that `sum_t` is an unsigned type
+  static_assert(SHIFT > 0 && SHIFT < 8 * sizeof(SUM_TYPE) - 8 * sizeof(INPUT_TYPE),
+                "Error: shift does not fit in the sum data type.");
+
+public:
+  /**
+   * Triggers the filter to filter a new sample
+   * @param input new sample
+   * @return Returns the filtered value
+   */
+  INPUT_TYPE filterNewSample(INPUT_TYPE input) noexcept {
+    // sum holds average * 2^SHIFT, so sum += input - average is the same as the equation above.
+    sum = sum - (sum >> SHIFT) + input;
+
+    // Adds a 1/2 to the average before the shift, so it is rounded, as in the SimpleMovingAverage.
+    constexpr SUM_TYPE half = SUM_TYPE(1) << (SHIFT - 1);
+    return static_cast<INPUT_TYPE>((sum + half) >> SHIFT);
+  }
+
+private:
+  SUM_TYPE sum = 0;  ///< Holds the current average multiplied by 2^SHIFT.
+};
+
+/**
+ * Bank of simple moving averages that filters several channels at once, for example all the channels of an ADC
+ * sweep. All the channels share the same ring buffer index, and the samples are stored as struct of arrays,
+ * so one sweep is filtered in a single loop.
+ * Keep in mind that the bank uses channels * numSamples inputs of RAM.
+ * @tparam channels Number of channels
+ * @tparam numSamples Number of samples of each average. A power of two avoids the multiplication.
+ * @tparam INPUT_BITS Number of bits used by the inputs, as in the SimpleMovingAverage
+ */
+template<uint8_t channels, uint8_t numSamples, class INPUT_TYPE = uint16_t, class SUM_TYPE = uint32_t,
+         uint8_t INPUT_BITS = 8 * sizeof(INPUT_TYPE)>
+class MovingAverageBank {
+  static_assert(SUM_TYPE(0) < SUM_TYPE(-1),
+                "Error: sum data type should be unsigned.");  // Check that `sum_t` is an unsigned type
+public:
+  /**
+   * Filters a new sample of every channel
+   * @param inputs array with one new sample of each channel
+   */
+  void filterNewSamples(const INPUT_TYPE (&inputs)[channels]) noexcept {
+    INPUT_TYPE* const oldestInputs = previousInputs[index];
+    constexpr SUM_TYPE halfNumSamples = (numSamples / 2);
+    for (uint8_t channel = 0; channel < channels; channel++) {
+      // The subtraction and the addition are separate, since the difference of two inputs is only promoted to the
+      // 16 bits of an int on the target, and a negative one would be added as a big positive number.
+      sums[channel] -= oldestInputs[channel];
+      sums[channel] += inputs[channel];
+      oldestInputs[channel] = inputs[channel];
+      const SUM_TYPE average =
+          AverageDivider<numSamples, INPUT_TYPE, SUM_TYPE, INPUT_BITS>::divide(sums[channel] + halfNumSamples);
+      averages[channel] = static_cast<INPUT_TYPE>(average);
+    }
+
+    // Set index to 0 if it is the last value of the array to guarantee
+    // circular buffer
+    if (++index == numSamples) {
+      index = 0;
+    }
+  }
+
+  /**
+   * Gets the latest average of a channel
+   * @param channel The channel
+   * @return The filtered value of the channel
+   */
+  INPUT_TYPE getFilteredValue(const uint8_t channel) const noexcept {
+    return averages[channel];
+  }
+
+private:
+  uint8_t index = 0;                                     ///< Holds the current index of the ring buffer
+  INPUT_TYPE previousInputs[numSamples][channels] = {};  ///< Holds the last numSamples of every channel
+  SUM_TYPE sums[channels] = {};                          ///< Holds the current sum of each channel
+  INPUT_TYPE averages[channels] = {};                    ///< Holds the latest average of each channel
+};
 }  // namespace Microtech
 #endif
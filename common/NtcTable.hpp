@@ -0,0 +1,129 @@
+/******************************************************************************
+ * @file                    NtcTable.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains a lookup table from ADC values to temperatures
+ *
+ * Description: The temperature of an NTC follows the beta equation
+ *                1/T = 1/T25 + ln(R/R25)/beta
+ *              which needs a logarithm and divisions of floating point numbers,
+ *              far too expensive for the MSP430. The NtcTable evaluates it in
+ *              compile time at evenly spaced ADC values, so the table goes to the
+ *              flash and the firmware only interpolates between two points of it:
+ *                // 10 kOhm NTC with beta 3435 and a 10 kOhm resistor to ground
+ *                constexpr NtcTable<5> NTC_TABLE(10000.0, 3435.0, 10000.0, NtcPosition::HIGH_SIDE);
+ *                ...
+ *                const int16_t temperature = NTC_TABLE.getDeciCelsius(ntcInput.getRawValue());
+ *
+ *              The spacing of the points is a power of two, so the segment of an
+ *              ADC value is found by a shift instead of a search, and the
+ *              evaluation has no branches.
+ ******************************************************************************/
+#ifndef MICROTECH_NTCTABLE_HPP
+#define MICROTECH_NTCTABLE_HPP
+
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * @brief Natural logarithm that can be evaluated in compile time.
+ * It is only intended to generate look up tables, since it uses a series with doubles.
+ * @param[in] value Positive value
+ * @return logarithm of the value
+ */
+constexpr double constexprLogarithm(double value) {
+  constexpr double LN_2 = 0.6931471805599453;
+  // Brings the value to the range of 1 to 2, where the series converges fast. ln(value * 2^n) = ln(value) + n ln(2)
+  double powersOfTwo = 0;
+  while (value >= 2.0) {
+    value /= 2.0;
+    powersOfTwo++;
+  }
+  while (value < 1.0) {
+    value *= 2.0;
+    powersOfTwo--;
+  }
+  // ln(value) = 2 atanh(z), with z = (value - 1) / (value + 1) <= 1/3
+  const double z = (value - 1.0) / (value + 1.0);
+  double term = z;
+  double result = 0;
+  for (uint8_t i = 0; i < 12; i++) {
+    result += term / (2 * i + 1);
+    term *= z * z;
+  }
+  return 2.0 * result + powersOfTwo * LN_2;
+}
+
+/**
+ * Where the NTC is in the voltage divider connected to the ADC
+ */
+enum class NtcPosition : uint8_t {
+  HIGH_SIDE = 0,  ///< The NTC is connected to Vcc, so the ADC value rises with the temperature
+  LOW_SIDE,       ///< The NTC is connected to ground, so the ADC value falls with the temperature
+};
+
+/**
+ * Piecewise linear table of the temperature of an NTC for every value of the 10 bit ADC, calculated in compile time.
+ * @tparam SEGMENT_BITS The points are 2^SEGMENT_BITS ADC values apart. 5 gives 33 points, so 66 bytes of flash.
+ */
+template<uint8_t SEGMENT_BITS>
+class NtcTable {
+  static_assert((SEGMENT_BITS >= 1) && (SEGMENT_BITS <= 9), "The table needs between 3 and 513 points");
+
+public:
+  static constexpr uint16_t ADC_RANGE = 1024;                                   ///< Values of the 10 bit ADC
+  static constexpr uint16_t SEGMENT_LENGTH = 1U << SEGMENT_BITS;                ///< ADC values between two points
+  static constexpr uint16_t NUMBER_OF_POINTS = ADC_RANGE / SEGMENT_LENGTH + 1;  ///< Both ends are included
+
+  /**
+   * Constructor, that calculates the table
+   * @param r25Ohm Resistance of the NTC at 25 degrees Celsius
+   * @param beta Beta coefficient of the NTC, in Kelvin
+   * @param dividerOhm Resistor in series with the NTC
+   * @param position Where the NTC is in the divider
+   */
+  constexpr NtcTable(const double r25Ohm, const double beta, const double dividerOhm, const NtcPosition position)
+    : points() {
+    constexpr double KELVIN_AT_0_CELSIUS = 273.15;
+    constexpr double KELVIN_AT_25_CELSIUS = KELVIN_AT_0_CELSIUS + 25.0;
+    for (uint16_t index = 0; index < NUMBER_OF_POINTS; index++) {
+      // The ends would be an open or a shorted NTC, so they are moved to the closest value the ADC can convert.
+      double adcValue = static_cast<double>(index) * SEGMENT_LENGTH;
+      adcValue = (adcValue < 1.0) ? 1.0 : (adcValue > ADC_RANGE - 1.0) ? ADC_RANGE - 1.0 : adcValue;
+      const double resistance = (position == NtcPosition::HIGH_SIDE)
+                                  ? dividerOhm * (ADC_RANGE - adcValue) / adcValue
+                                  : dividerOhm * adcValue / (ADC_RANGE - adcValue);
+      const double kelvin = 1.0 / (1.0 / KELVIN_AT_25_CELSIUS + constexprLogarithm(resistance / r25Ohm) / beta);
+      points[index] = roundToDeciCelsius((kelvin - KELVIN_AT_0_CELSIUS) * 10.0);
+    }
+  }
+
+  /**
+   * Method to get the temperature of an ADC value, interpolated between the two closest points of the table
+   * @param adcValue Value of the 10 bit ADC, e.g. from AdcHandle::getRawValue
+   * @return Temperature in tenths of degrees Celsius
+   */
+  constexpr int16_t getDeciCelsius(const uint16_t adcValue) const noexcept {
+    // The mask only keeps a wrong value within the table, the ADC10 never converts more than 10 bits.
+    const uint16_t index = (adcValue & (ADC_RANGE - 1)) >> SEGMENT_BITS;
+    const uint16_t offset = adcValue & (SEGMENT_LENGTH - 1);
+    const int32_t difference = static_cast<int32_t>(points[index + 1]) - points[index];
+    return static_cast<int16_t>(points[index] + difference * offset / SEGMENT_LENGTH);
+  }
+
+private:
+  static constexpr int16_t roundToDeciCelsius(const double deciCelsius) {
+    return (deciCelsius >= INT16_MAX) ? INT16_MAX
+           : (deciCelsius <= INT16_MIN) ? INT16_MIN
+           : static_cast<int16_t>((deciCelsius < 0) ? deciCelsius - 0.5 : deciCelsius + 0.5);
+  }
+
+  int16_t points[NUMBER_OF_POINTS];  ///< Temperature at every SEGMENT_LENGTH ADC values, in tenths of degrees Celsius
+};
+}  // namespace Microtech
+
+#endif  // MICROTECH_NTCTABLE_HPP
@@ -0,0 +1,265 @@
+/******************************************************************************
+ * @file                    Oscilloscope.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains a triggered capture engine for the oscilloscope
+ *
+ * Description: Instead of sending every sample through the serial, the oscilloscope
+ *              works like the acquisition memory of a real scope: the samples of the
+ *              ADC block capture are stored in a ring buffer until the trigger
+ *              condition happens, then the samples after the trigger are captured and
+ *              only the complete capture is sent. So high rate bursts fit through a slow
+ *              serial.
+ *
+ *              For long time bases, the samples can be decimated keeping the minimum
+ *              and the maximum of each group of samples, so short peaks are not lost.
+ *
+ *              Usage:
+ *                Oscilloscope<64, 16> scope;
+ *                void blockCompleted(const uint16_t* samples, uint8_t numberOfSamples) {
+ *                  scope.processSamples(samples, numberOfSamples);  // From the ADC interruption
+ *                }
+ *                ...
+ *                Adc::getInstance().initBlockCapture<0, 8>(adcBlocks, &blockCompleted, AdcTrigger::TIMER0_OUT1);
+ *                ...
+ *                if (scope.isCaptureComplete()) {  // In the main loop
+ *                  scope.sendCapture(scopeStream);
+ *                }
+ *
+ *              A capture doesn't fit in the transmit buffer of the Serial, so every call
+ *              only sends the frames that fit, until the whole capture was sent. The
+ *              Serial doesn't wake up the main loop, so something else has to, e.g. a
+ *              timer task. The frame with the trigger has its index, and the frames of
+ *              a decimated capture are marked as minimum and maximum pairs.
+ ******************************************************************************/
+#ifndef MICROTECH_OSCILLOSCOPE_HPP
+#define MICROTECH_OSCILLOSCOPE_HPP
+
+#include <msp430g2553.h>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Edge of the signal that triggers the capture
+ */
+enum class TriggerEdge : uint8_t {
+  RISING,   ///< Triggers when the signal goes from below to above the level
+  FALLING,  ///< Triggers when the signal goes from above to below the level
+};
+
+/**
+ * Class that captures the samples around a trigger.
+ *
+ * processSamples is called from the interruption, and the main loop sends the capture once it is complete.
+ * While a capture is complete and not sent yet, new samples are ignored.
+ *
+ * @tparam CAPTURE_DEPTH Number of samples of a capture
+ * @tparam PRE_TRIGGER_DEPTH Number of samples of the capture before the trigger
+ */
+template<uint8_t CAPTURE_DEPTH, uint8_t PRE_TRIGGER_DEPTH>
+class Oscilloscope {
+  static_assert(CAPTURE_DEPTH > 0, "The capture must have at least one sample");
+  static_assert(PRE_TRIGGER_DEPTH < CAPTURE_DEPTH, "The pre-trigger must be smaller than the capture");
+
+public:
+  /**
+   * Sets the trigger condition and arms the oscilloscope again.
+   * @param level ADC value that the signal has to cross
+   * @param edge Edge of the signal that triggers the capture
+   */
+  void setTrigger(const uint16_t level, const TriggerEdge edge) noexcept {
+    triggerLevel = level;
+    triggerEdge = edge;
+    arm();
+  }
+
+  /**
+   * Sets the decimation and arms the oscilloscope again.
+   * @param factor Number of samples reduced to a minimum and maximum pair. 1 stores every sample.
+   */
+  void setDecimation(const uint8_t factor) noexcept {
+    decimationFactor = (factor == 0) ? 1 : factor;
+    arm();
+  }
+
+  /**
+   * Discards the current capture and waits for the next trigger.
+   * The interruption of the ADC processes the samples meanwhile, so it is disabled until every index was reset,
+   * and the interrupt state is restored afterwards.
+   */
+  void arm() noexcept {
+    const unsigned short interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    writeIndex = 0;
+    storedEntries = 0;
+    groupSamples = 0;
+    sentEntries = 0;
+    // The level itself is never a crossing in either edge, so a stale sample can't trigger the capture.
+    previousSample = triggerLevel;
+    // Without pre-trigger samples, the trigger can happen right away.
+    state = (PRE_TRIGGER_DEPTH == 0) ? State::ARMED : State::ARMING;
+    __set_interrupt_state(interruptState);
+  }
+
+  /**
+   * Processes new samples of the signal. It should be called from the completion of the ADC blocks.
+   * @param samples New samples
+   * @param numberOfSamples Number of new samples
+   */
+  void processSamples(const uint16_t* samples, const uint8_t numberOfSamples) noexcept {
+    for (uint8_t i = 0; i < numberOfSamples; i++) {
+      if (state == State::COMPLETE) {
+        return;
+      }
+      const uint16_t sample = samples[i];
+      if (state == State::ARMED && isTriggered(sample)) {
+        state = State::TRIGGERED;
+        triggerIndex = writeIndex;
+        remainingEntries = CAPTURE_DEPTH - PRE_TRIGGER_DEPTH;
+      }
+      previousSample = sample;
+      decimate(sample);
+    }
+  }
+
+  /**
+   * Method to know if a capture is complete and can be sent
+   * @return true if the capture is complete
+   */
+  bool isCaptureComplete() const noexcept {
+    return state == State::COMPLETE;
+  }
+
+  /**
+   * Gets a sample of the complete capture.
+   * @param index Index of the sample, where 0 is the oldest. The trigger is at PRE_TRIGGER_DEPTH.
+   * @return The sample. When decimating, the minimum and the maximum of each group are consecutive samples.
+   */
+  uint16_t getSample(const uint8_t index) const noexcept {
+    return captureBuffer[wrapIndex(captureStart + index)];
+  }
+
+  /**
+   * Sends the part of the complete capture that fits in the transmit buffer of the Serial. Once the whole capture
+   * was sent, the oscilloscope is armed again.
+   * @tparam STREAM Type of the stream, like the ScopeStream of a single channel.
+   * @param stream Stream where the samples are added.
+   * @return true if there is still a part of the capture to be sent
+   */
+  template<class STREAM>
+  bool sendCapture(STREAM& stream) noexcept {
+    static_assert(STREAM::NUMBER_OF_CHANNELS == 1, "The capture has a single channel");
+    static_assert(CAPTURE_DEPTH % STREAM::FRAME_LENGTH == 0, "The capture must end with a complete frame");
+    if (!isCaptureComplete()) {
+      return false;
+    }
+    if (sentEntries == 0) {
+      stream.setDecimation(decimationFactor);
+    }
+    while (stream.canAddSamples()) {
+      if (sentEntries == PRE_TRIGGER_DEPTH) {
+        stream.markTrigger();
+      }
+      const uint16_t sample[] = {getSample(sentEntries)};
+      stream.addSamples(sample);
+      if (++sentEntries == CAPTURE_DEPTH) {
+        arm();
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  enum class State : uint8_t {
+    ARMING,     ///< Filling the pre-trigger samples
+    ARMED,      ///< Waiting for the trigger
+    TRIGGERED,  ///< Capturing the samples after the trigger
+    COMPLETE,   ///< Capture can be sent
+  };
+
+  /**
+   * Checks if the sample and the previous one cross the trigger level in the trigger edge.
+   */
+  bool isTriggered(const uint16_t sample) const noexcept {
+    if (triggerEdge == TriggerEdge::RISING) {
+      return previousSample < triggerLevel && sample >= triggerLevel;
+    }
+    return previousSample > triggerLevel && sample <= triggerLevel;
+  }
+
+  /**
+   * Keeps the minimum and maximum of the group. When the group is complete, they are stored.
+   * Without decimation, the sample is stored directly.
+   */
+  void decimate(const uint16_t sample) noexcept {
+    if (decimationFactor == 1) {
+      store(sample);
+      return;
+    }
+    if (groupSamples == 0 || sample < groupMinimum) {
+      groupMinimum = sample;
+    }
+    if (groupSamples == 0 || sample > groupMaximum) {
+      groupMaximum = sample;
+    }
+    if (++groupSamples == decimationFactor) {
+      groupSamples = 0;
+      store(groupMinimum);
+      store(groupMaximum);
+    }
+  }
+
+  /**
+   * Stores an entry in the ring buffer and updates the state of the capture.
+   */
+  void store(const uint16_t entry) noexcept {
+    if (state == State::COMPLETE) {
+      return;
+    }
+    captureBuffer[writeIndex] = entry;
+    writeIndex = wrapIndex(writeIndex + 1);
+
+    if (state == State::ARMING) {
+      if (++storedEntries >= PRE_TRIGGER_DEPTH) {
+        state = State::ARMED;
+      }
+    } else if (state == State::TRIGGERED) {
+      if (--remainingEntries == 0) {
+        captureStart = wrapIndex(triggerIndex + CAPTURE_DEPTH - PRE_TRIGGER_DEPTH);
+        state = State::COMPLETE;
+      }
+    }
+  }
+
+  /**
+   * Wraps an index of the ring buffer. It is never bigger than two times the capture depth,
+   * so a subtraction replaces the modulo.
+   */
+  static constexpr uint8_t wrapIndex(const uint16_t index) noexcept {
+    return static_cast<uint8_t>(index >= CAPTURE_DEPTH ? index - CAPTURE_DEPTH : index);
+  }
+
+  uint16_t captureBuffer[CAPTURE_DEPTH] = {};     ///< Ring buffer with the samples
+  volatile State state = State::ARMING;           ///< State of the capture
+  uint8_t writeIndex = 0;                         ///< Index where the next entry is stored
+  uint8_t storedEntries = 0;                      ///< Entries stored while arming
+  uint8_t triggerIndex = 0;                       ///< Index of the first entry after the trigger
+  uint8_t remainingEntries = 0;                   ///< Entries still to be stored after the trigger
+  uint8_t captureStart = 0;                       ///< Index of the oldest entry of the complete capture
+  uint8_t sentEntries = 0;                        ///< Entries of the complete capture already sent
+  uint16_t triggerLevel = 512;                    ///< Level of the trigger. Initialized to the middle of the ADC.
+  TriggerEdge triggerEdge = TriggerEdge::RISING;  ///< Edge of the trigger
+  uint16_t previousSample = 512;                  ///< Last processed sample, used to detect the edge
+  uint8_t decimationFactor = 1;                   ///< Number of samples of each decimation group
+  uint8_t groupSamples = 0;                       ///< Samples of the current decimation group
+  uint16_t groupMinimum = 0;                      ///< Minimum of the current decimation group
+  uint16_t groupMaximum = 0;                      ///< Maximum of the current decimation group
+};
+}  // namespace Microtech
+
+#endif  // MICROTECH_OSCILLOSCOPE_HPP
@@ -14,15 +14,23 @@
 #ifndef MICROTECH_PWM_HPP
 #define MICROTECH_PWM_HPP
 
+#include "ClockSystem.hpp"
 #include "Timer.hpp"
 #include "GPIOs.hpp"
 
 #include "IQmathLib.h"
 #include <msp430g2553.h>
 #include <chrono>
-#include <memory>
 
 namespace Microtech {
+/**
+ * Enum to choose when a new duty cycle reaches the output of the PWM
+ */
+enum class PwmUpdateMode {
+  IMMEDIATE = 0,  ///< The comparator is written right away, which can cut the pulse of the current period
+  NEXT_PERIOD,    ///< The comparator is written at the next period boundary by the CCR0 interruption
+};
+
 /**
  * Class to abstract the PWM.
  */
@@ -31,6 +39,11 @@ public:
   Pwm() = delete;
   explicit Pwm(const OutputHandle& outputPin) : pwmOutput(outputPin), TIMER_CONFIG(TimerClockSource::Option::SMCLK){}
 
+  static constexpr int64_t TIMER_CLK_DIV = 8;            ///< Divider of the clock of the PWM timer
+  static constexpr _iq15 MAX_DUTY_CYCLE = _IQ15(100.0);  ///< Duty cycle of 100%, the maximum of setDutyCycle
+  /// Frequency of the source clock of the PWM timer
+  static constexpr int64_t TIMER_SOURCE_CLK_FREQUENCY_HZ = SystemClock::SMCLK_FREQUENCY_HZ;
+
   void init() const {
     Timer<0>::getTimer().init(TIMER_CONFIG);
     pwmOutput.init();
@@ -42,26 +55,44 @@ public:
   /**
    * Class to set the period of the PWM
    * At the moment we are using the timer 0 as the timer for the PWM.
-   * So this method basically registers a task in the timer, and
+   * So this method basically sets the period of the timer, and
    * since the init configured TA0CTTL2, the compar value of the timer will
    * be in the pwmOutput.
+   * No task is needed, since the PWM doesn't need the timer interruption. This way changing the period
+   * is only writing the CCR0 register, which value is calculated in compile time.
+   * A period of 0 stops the PWM.
    */
   template<uint64_t periodValue, typename Duration = std::chrono::microseconds>
   void setPwmPeriod() {
-    // Pointer of a newTask
-    std::unique_ptr<TaskHandler<periodValue, Duration>> newTask =
-      std::make_unique<TaskHandler<periodValue, Duration>>(nullptr, true);
-
-    if (currentTask) {  // if there is a task playing, deregister the task
-      Timer<0>::getTimer().deregisterTask(*currentTask);
-    }
-    // Register the newTask
-    Timer<0>::getTimer().registerTask(TIMER_CONFIG, *newTask);
+    Timer<0>::getTimer().setPeriod<periodValue, Duration>(TIMER_CONFIG);
 
+    // The scale depends on the period, so it is only calculated when the period changes.
+    updateDutyCycleScale();
     // Update dutycycle, since comparator value changed.
     updateDutyCycleRegister();
+  }
 
-    currentTask = std::move(newTask);  // Stores new task pointer.
+  /**
+   * Method to set the period of the PWM from a compare value calculated beforehand, e.g. from a table in the flash.
+   * Unlike setPwmPeriod, it is not a template, so there is a single copy of it no matter how many periods are used.
+   * A compare value of 0 stops the PWM.
+   * @param compareValue Value of CCR0, which is the number of timer counts of the period minus 1
+   */
+  void setPeriodCompareValue(const uint16_t compareValue) {
+    TA0CCR0 = compareValue;
+    setRegisterBits(TA0CTL, static_cast<uint16_t>(MC_1));
+    updateDutyCycleScale();
+    updateDutyCycleRegister();
+  }
+
+  /**
+   * Method to choose when a new duty cycle reaches the output.
+   * With PwmUpdateMode::NEXT_PERIOD, fast updates like the ones of a DAC never produce a runt pulse, but each new
+   * duty cycle costs one CCR0 interruption of Timer0.
+   * @param mode Update mode of the duty cycle
+   */
+  void setUpdateMode(const PwmUpdateMode mode) noexcept {
+    updateMode = mode;
   }
 
   /**
@@ -81,24 +112,56 @@ public:
     Timer<0>::getTimer().stop();
   }
 
+  /**
+   * Method to calculate the value of CCR2 of a duty cycle in the current period, e.g. to precompute samples.
+   * The scale is truncated to Q15, so the result is rounded instead of truncated to not lose a whole count.
+   * @param newDutyCycle Duty cycle, from 0 to 100
+   * @return The compare value
+   */
+  uint16_t getCompareValue(const _iq15 newDutyCycle) const noexcept {
+    return static_cast<uint16_t>(_IQ15int(_IQ15mpy(newDutyCycle, dutyCycleScale) + HALF_COUNT));
+  }
+
 private:
+  /**
+   * Method to calculate how many timer counts are one percent of the duty cycle in the current period.
+   * The division happens only here, so every duty cycle update is a single multiplication.
+   */
+  void updateDutyCycleScale() {
+    const _iq15 valueCCR0 = _IQ15(TA0CCR0);  // Reads current "period" register
+    dutyCycleScale = _IQ15div(valueCCR0, MAX_DUTY_CYCLE);
+  }
+
   /**
    * Method to configure the register responsible by the duty cycle.
    */
   void updateDutyCycleRegister() {
-    const _iq15 valueCCR0 = _IQ15(TACCR0);  // Reads current "period" register
     //  Calculates the value of the CCR2 based on the value of the current CCR0 value.
-    const _iq15 valueCCR1 = _IQ15div(_IQ15mpy(valueCCR0, dutyCycle), MAX_DUTY_CYCLE);
-    TA0CCR2 = _IQ15int(valueCCR1);
+    const uint16_t valueCCR2 = getCompareValue(dutyCycle);
+    if (updateMode == PwmUpdateMode::IMMEDIATE) {
+      TA0CCR2 = valueCCR2;
+      return;
+    }
+    pendingCCR2 = valueCCR2;
+    Timer<0>::getTimer().callAtNextPeriod(&latchDutyCycleRegister, this);
+  }
+
+  /**
+   * Called by the CCR0 interruption when the timer counts back to 0, so the new value is used by the whole period.
+   */
+  static void latchDutyCycleRegister(void* context) {
+    TA0CCR2 = static_cast<Pwm*>(context)->pendingCCR2;
   }
 
-  static constexpr _iq15 MAX_DUTY_CYCLE = _IQ15(100.0);
+  static constexpr _iq15 HALF_COUNT = _IQ15(0.5);
 
   const OutputHandle pwmOutput;
 
-  const TimerConfigBase<8, 1> TIMER_CONFIG;
-  std::unique_ptr<TaskHandlerBase> currentTask;
+  const TimerConfigBase<TIMER_CLK_DIV, TIMER_SOURCE_CLK_FREQUENCY_HZ> TIMER_CONFIG;
   _iq15 dutyCycle = 0;
+  _iq15 dutyCycleScale = 0;                             ///< Timer counts of one percent of the duty cycle
+  PwmUpdateMode updateMode = PwmUpdateMode::IMMEDIATE;  ///< When a new duty cycle reaches the output
+  uint16_t pendingCCR2 = 0;                             ///< CCR2 value written at the next period boundary
 };
 
 }  // namespace Microtech
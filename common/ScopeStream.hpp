@@ -0,0 +1,247 @@
+/******************************************************************************
+ * @file                    ScopeStream.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains a compact binary stream for the oscilloscope samples
+ *
+ * Description: Sending a 10 bit sample as decimal characters and a new line takes
+ *              5 to 6 bytes. The ScopeStream groups the samples of one or more ADC
+ *              channels in frames and packs them with 10 bits each, or, when enabled,
+ *              as zigzag encoded differences to the previous sample with the smallest
+ *              bit width that fits the whole frame.
+ *
+ *              Frame format (multi-byte values are little endian, bits are packed
+ *              starting from the least significant bit of each byte):
+ *                0xA5 0x5A           Sync
+ *                flags               Bit 0: samples are delta/zigzag encoded
+ *                channel mask        Bit n set means ADC channel An is in the frame
+ *                sample rate         Samples per second of each channel (2 bytes)
+ *                samples per frame   Samples of each channel
+ *                bit width           Bits of each packed value
+ *                decimation          Only with flag bit 1: number of samples reduced to each
+ *                                    minimum and maximum pair. The payload has the pairs, and
+ *                                    every pair covers this many periods of the sample rate.
+ *                trigger index       Only with flag bit 2: index in the frame of the sample of
+ *                                    the trigger, or of the minimum of its pair.
+ *                payload             Samples interleaved by channel, from the lowest channel.
+ *                                    In delta mode, the first sample of each channel has
+ *                                    10 bits and the next ones have the bit width.
+ *                crc                 CRC-8 (polynomial 0x07) of every byte after the sync
+ *
+ *              The decoder is example/scopestream/decode_scope_stream.py
+ ******************************************************************************/
+#ifndef MICROTECH_SCOPESTREAM_HPP
+#define MICROTECH_SCOPESTREAM_HPP
+
+#include "Serial.hpp"
+#include "helpers.hpp"
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Class that encodes the samples of the channels in CHANNEL_MASK and sends them through the Serial.
+ *
+ * Keep in mind that a whole frame should fit in the transmit buffer of the Serial, otherwise the end of the
+ * frame is dropped and the decoder discards it because of the CRC. Long sends from the main loop are paced
+ * with canAddSamples.
+ *
+ * @tparam CHANNEL_MASK Bit n set means ADC channel An is streamed
+ * @tparam SAMPLES_PER_FRAME Number of samples of each channel in a frame
+ * @tparam DELTA_ENCODING If the samples are sent as zigzag encoded differences
+ */
+template<uint8_t CHANNEL_MASK, uint8_t SAMPLES_PER_FRAME, bool DELTA_ENCODING = false>
+class ScopeStream {
+  /**
+   * Counts how many channels are set in the mask
+   */
+  static constexpr uint8_t countChannels(uint8_t mask) {
+    return mask == 0 ? 0 : (mask & 0x01) + countChannels(mask >> 1);
+  }
+
+public:
+  static constexpr uint8_t NUMBER_OF_CHANNELS = countChannels(CHANNEL_MASK);
+  static_assert(NUMBER_OF_CHANNELS > 0, "At least one channel must be streamed");
+  static_assert(SAMPLES_PER_FRAME > 0, "A frame must have at least one sample");
+
+  static constexpr uint8_t FRAME_LENGTH = SAMPLES_PER_FRAME;  ///< Samples of each channel in a frame
+
+  /**
+   * Constructor
+   * @param sampleRateHz Samples per second of each channel. It is only sent in the header.
+   */
+  explicit constexpr ScopeStream(uint16_t sampleRateHz) : sampleRate(sampleRateHz) {}
+
+  /**
+   * Adds one sample of every channel. When the frame is full, it is encoded and sent.
+   * @param samples One sample of each streamed channel, from the lowest channel to the highest.
+   */
+  void addSamples(const uint16_t (&samples)[NUMBER_OF_CHANNELS]) noexcept {
+    for (uint8_t channel = 0; channel < NUMBER_OF_CHANNELS; channel++) {
+      frameSamples[numberOfSamples][channel] = samples[channel] & SAMPLE_MASK;
+    }
+    if (++numberOfSamples == SAMPLES_PER_FRAME) {
+      sendFrame();
+      numberOfSamples = 0;
+      triggerPosition = NO_TRIGGER;
+    }
+  }
+
+  /**
+   * Method to know if the next samples can be added without dropping bytes: either they don't complete the
+   * frame, or the transmit buffer of the Serial has space for the whole frame.
+   * @return true if addSamples can be called now
+   */
+  bool canAddSamples() const noexcept {
+    static_assert(MAXIMUM_FRAME_SIZE <= Serial::getCapacity(), "A frame must fit in the transmit buffer");
+    return (numberOfSamples + 1 < SAMPLES_PER_FRAME) || (Serial::getInstance().getFreeSpace() >= MAXIMUM_FRAME_SIZE);
+  }
+
+  /**
+   * Marks the next samples added as the trigger of a capture. The frame that contains them has the trigger index.
+   */
+  void markTrigger() noexcept {
+    triggerPosition = numberOfSamples;
+  }
+
+  /**
+   * Sets if the samples are minimum and maximum pairs of a decimation. It applies to the frame being filled.
+   * @param factor Number of samples reduced to each pair, or 1 for plain samples
+   */
+  void setDecimation(const uint8_t factor) noexcept {
+    decimationFactor = factor;
+  }
+
+private:
+  static constexpr uint8_t SAMPLE_BITS = 10;
+  static constexpr uint16_t SAMPLE_MASK = (1U << SAMPLE_BITS) - 1;
+  static constexpr uint8_t FLAG_DELTA = 0x01;
+  static constexpr uint8_t FLAG_MIN_MAX = 0x02;
+  static constexpr uint8_t FLAG_TRIGGER = 0x04;
+  static constexpr uint8_t NO_TRIGGER = 0xFF;
+
+  /// Sync, header, optional bytes, payload without delta encoding and CRC
+  static constexpr uint16_t MAXIMUM_FRAME_SIZE =
+    2 + 6 + 2 + (static_cast<uint16_t>(SAMPLES_PER_FRAME) * NUMBER_OF_CHANNELS * SAMPLE_BITS + 7) / 8 + 1;
+
+  /**
+   * Gets the zigzag encoded difference between a sample and the previous sample of the same channel.
+   * Zigzag maps the signed difference to an unsigned one, so small negative differences also need few bits.
+   */
+  uint16_t getZigzagDelta(uint8_t sampleIndex, uint8_t channel) const noexcept {
+    const int16_t sample = static_cast<int16_t>(frameSamples[sampleIndex][channel]);
+    const int16_t previousSample = static_cast<int16_t>(frameSamples[sampleIndex - 1][channel]);
+    const int16_t delta = sample - previousSample;
+    return static_cast<uint16_t>(delta << 1) ^ static_cast<uint16_t>(delta >> 15);
+  }
+
+  /**
+   * Gets the smallest bit width that fits every zigzag difference of the frame
+   */
+  uint8_t getDeltaBitWidth() const noexcept {
+    uint16_t allDeltas = 0;
+    for (uint8_t sampleIndex = 1; sampleIndex < SAMPLES_PER_FRAME; sampleIndex++) {
+      for (uint8_t channel = 0; channel < NUMBER_OF_CHANNELS; channel++) {
+        allDeltas |= getZigzagDelta(sampleIndex, channel);
+      }
+    }
+    uint8_t bitWidth = 1;
+    while ((allDeltas >> bitWidth) != 0) {
+      bitWidth++;
+    }
+    return bitWidth;
+  }
+
+  /**
+   * Encodes and sends the frame
+   */
+  void sendFrame() noexcept {
+    uint8_t bitWidth = SAMPLE_BITS;
+    uint8_t flags = 0;
+    if (DELTA_ENCODING) {
+      const uint8_t deltaBitWidth = getDeltaBitWidth();
+      // The differences only save space if they are smaller than the samples.
+      if (deltaBitWidth < SAMPLE_BITS) {
+        bitWidth = deltaBitWidth;
+        flags = FLAG_DELTA;
+      }
+    }
+    if (decimationFactor > 1) {
+      flags |= FLAG_MIN_MAX;
+    }
+    if (triggerPosition != NO_TRIGGER) {
+      flags |= FLAG_TRIGGER;
+    }
+
+    Serial& serial = Serial::getInstance();
+    serial.write(static_cast<char>(0xA5));
+    serial.write(static_cast<char>(0x5A));
+    crc = 0;
+    writeByte(flags);
+    writeByte(CHANNEL_MASK);
+    writeByte(static_cast<uint8_t>(sampleRate));
+    writeByte(static_cast<uint8_t>(sampleRate >> 8));
+    writeByte(SAMPLES_PER_FRAME);
+    writeByte(bitWidth);
+    if (flags & FLAG_MIN_MAX) {
+      writeByte(decimationFactor);
+    }
+    if (flags & FLAG_TRIGGER) {
+      writeByte(triggerPosition);
+    }
+
+    for (uint8_t sampleIndex = 0; sampleIndex < SAMPLES_PER_FRAME; sampleIndex++) {
+      for (uint8_t channel = 0; channel < NUMBER_OF_CHANNELS; channel++) {
+        if ((flags & FLAG_DELTA) && sampleIndex > 0) {
+          writeBits(getZigzagDelta(sampleIndex, channel), bitWidth);
+        } else {
+          writeBits(frameSamples[sampleIndex][channel], SAMPLE_BITS);
+        }
+      }
+    }
+    // Sends the bits that didn't complete a byte
+    if (pendingBitCount > 0) {
+      writeByte(static_cast<uint8_t>(pendingBits));
+      pendingBits = 0;
+      pendingBitCount = 0;
+    }
+    serial.write(static_cast<char>(crc));
+  }
+
+  /**
+   * Packs the lowest bits of a value. Complete bytes are sent right away.
+   */
+  void writeBits(uint16_t value, uint8_t bitCount) noexcept {
+    // At most 7 bits are pending, so 7 + 10 bits always fit.
+    pendingBits |= static_cast<uint32_t>(value) << pendingBitCount;
+    pendingBitCount += bitCount;
+    while (pendingBitCount >= 8) {
+      writeByte(static_cast<uint8_t>(pendingBits));
+      pendingBits >>= 8;
+      pendingBitCount -= 8;
+    }
+  }
+
+  /**
+   * Sends a byte and updates the CRC
+   */
+  void writeByte(uint8_t byte) noexcept {
+    Serial::getInstance().write(static_cast<char>(byte));
+    crc = crc8Update(crc, byte);
+  }
+
+  const uint16_t sampleRate;                                          ///< Samples per second of each channel
+  uint16_t frameSamples[SAMPLES_PER_FRAME][NUMBER_OF_CHANNELS] = {};  ///< Samples of the current frame
+  uint8_t numberOfSamples = 0;                                        ///< Samples of each channel in the current frame
+  uint32_t pendingBits = 0;                                           ///< Packed bits that didn't complete a byte yet
+  uint8_t pendingBitCount = 0;                                        ///< Number of pending bits
+  uint8_t crc = 0;                                                    ///< CRC of the current frame
+  uint8_t decimationFactor = 1;                                       ///< Samples reduced to each pair, 1 if none
+  uint8_t triggerPosition = NO_TRIGGER;                               ///< Index of the trigger in the current frame
+};
+}  // namespace Microtech
+
+#endif  // MICROTECH_SCOPESTREAM_HPP
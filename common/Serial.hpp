@@ -0,0 +1,212 @@
+/******************************************************************************
+ * @file                    Serial.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains a non blocking serial transmitter
+ *
+ * Description: The print functions of the templateEMP wait until every byte was
+ *              sent, which at 9600 baud takes around 1 ms per character.
+ *              The Serial class only copies the characters to a ring buffer and
+ *              returns. The buffer is drained by the USCI_A0 transmit interruption.
+ *
+ *              If the buffer is full, the characters are dropped and counted, so
+ *              the caller never waits.
+ ******************************************************************************/
+#ifndef MICROTECH_SERIAL_HPP
+#define MICROTECH_SERIAL_HPP
+
+#include "ClockSystem.hpp"
+#include "LowPower.hpp"
+#include "helpers.hpp"
+#include <msp430g2553.h>
+#include <cstdint>
+
+namespace Microtech {
+
+class Serial {
+  friend struct SingletonInstance<Serial>;
+  constexpr Serial() = default;
+
+public:
+  // Deleted copy and move constructors
+  Serial(Serial&) = delete;
+  Serial(Serial&&) = delete;
+  ~Serial() = default;
+
+  /**
+   * Method that guarantees that there is only one instance of the Serial class in the software
+   * @return A reference to the instance
+   */
+  static Serial& getInstance() noexcept {
+    return SingletonInstance<Serial>::instance;
+  }
+
+  /**
+   * Method that initializes the USCI_A0 in UART mode with 9600 baud, 8 data bits, no parity and 1 stop bit.
+   * The divider of the baud rate is calculated in compile time from the SMCLK of the SystemClock.
+   */
+  void init() noexcept {
+    setRegisterBits(UCA0CTL1, static_cast<uint8_t>(UCSWRST));  // Holds the USCI in reset while configuring it
+    // P1.1 = RXD, P1.2 = TXD
+    setRegisterBits(P1SEL, static_cast<uint8_t>(BIT1 + BIT2));
+    setRegisterBits(P1SEL2, static_cast<uint8_t>(BIT1 + BIT2));
+    setRegisterBits(UCA0CTL1, static_cast<uint8_t>(UCSSEL_2));  // Clock source = SMCLK
+    // E.g. 1 MHz / 9600 = 104.17 => UCBRx = 104 and UCBRSx = round(0.17 * 8) = 1
+    UCA0BR0 = static_cast<uint8_t>(BAUD_RATE_DIVIDER);
+    UCA0BR1 = static_cast<uint8_t>(BAUD_RATE_DIVIDER >> 8);
+    UCA0MCTL = static_cast<uint8_t>(BAUD_RATE_MODULATION * UCBRS_1);
+    resetRegisterBits(UCA0CTL1, static_cast<uint8_t>(UCSWRST));
+  }
+
+  /**
+   * Method to send a single character
+   * @param character character to be sent
+   * @return true if the character was added to the buffer, false if it was dropped because the buffer is full
+   */
+  bool write(const char character) noexcept {
+    const uint8_t nextHead = (head + 1) & BUFFER_MASK;
+    if (nextHead == tail) {
+      droppedCharacters++;
+      return false;
+    }
+    buffer[head] = character;
+    head = nextHead;
+    // The interruption is triggered right away if the transmit buffer of the USCI is empty.
+    setRegisterBits(IE2, static_cast<uint8_t>(UCA0TXIE));
+    return true;
+  }
+
+  /**
+   * Method to send a string
+   * @param str null-terminated string to be sent
+   */
+  void print(const char* str) noexcept {
+    while (*str != '\0') {
+      write(*str++);
+    }
+  }
+
+  /**
+   * Method to send a string followed by a new line
+   * @param str null-terminated string to be sent
+   */
+  void println(const char* str = "") noexcept {
+    print(str);
+    print("\r\n");
+  }
+
+  /**
+   * Method to send an integer as decimal characters.
+   * The digits are calculated by subtracting powers of ten, since there is no hardware divider.
+   * @param value integer to be sent
+   */
+  void printInt(const int32_t value) noexcept {
+    uint32_t magnitude = static_cast<uint32_t>(value);
+    if (value < 0) {
+      write('-');
+      magnitude = 0U - magnitude;
+    }
+
+    static constexpr uint32_t POWERS_OF_TEN[] = {1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+                                                 10000UL,      1000UL,      100UL,      10UL,      1UL};
+    bool leadingZero = true;
+    for (const uint32_t powerOfTen : POWERS_OF_TEN) {
+      char digit = '0';
+      while (magnitude >= powerOfTen) {
+        magnitude -= powerOfTen;
+        digit++;
+      }
+      // The last digit is always printed, so 0 is printed as "0".
+      leadingZero = leadingZero && (digit == '0') && (powerOfTen != 1);
+      if (!leadingZero) {
+        write(digit);
+      }
+    }
+  }
+
+  /**
+   * Method to get the number of characters dropped because the buffer was full
+   * @return The number of dropped characters
+   */
+  uint16_t getDroppedCharacters() const noexcept {
+    return droppedCharacters;
+  }
+
+  /**
+   * Method to get how many characters can still be written without being dropped
+   * @return The number of free characters of the buffer
+   */
+  uint8_t getFreeSpace() const noexcept {
+    return static_cast<uint8_t>((tail - head - 1) & BUFFER_MASK);
+  }
+
+  /**
+   * Method to get how many characters fit in the buffer when it is empty
+   * @return The capacity of the buffer
+   */
+  static constexpr uint8_t getCapacity() noexcept {
+    return BUFFER_SIZE - 1;
+  }
+
+  /**
+   * Method to know if every character was already sent
+   * @return true if there is nothing left to be sent
+   */
+  bool isIdle() const noexcept {
+    return (head == tail) && !(UCA0STAT & UCBUSY);
+  }
+
+  /**
+   * Method to get which clock has to keep running while the CPU is sleeping.
+   * The USCI runs with SMCLK, so it has to keep running until every character was sent.
+   * @return The clock requirement of the serial
+   */
+  ClockRequirement getClockRequirement() const noexcept {
+    return isIdle() ? ClockRequirement::NONE : ClockRequirement::SMCLK;
+  }
+
+  /**
+   * Method called by the USCI_A0 transmit interruption. It sends the next character of the buffer.
+   */
+  void interruptionHappened() noexcept {
+    if (head == tail) {
+      // Nothing else to send, so the interruption is disabled until a new character is written.
+      resetRegisterBits(IE2, static_cast<uint8_t>(UCA0TXIE));
+      return;
+    }
+    UCA0TXBUF = buffer[tail];
+    tail = (tail + 1) & BUFFER_MASK;
+  }
+
+private:
+  static constexpr uint8_t BUFFER_SIZE = 64;  ///< Size of the ring buffer. It has to be a power of two.
+  static constexpr uint8_t BUFFER_MASK = BUFFER_SIZE - 1;
+  static_assert((BUFFER_SIZE & BUFFER_MASK) == 0, "The buffer size has to be a power of two");
+
+  static constexpr uint32_t BAUD_RATE = 9600;
+  /// SMCLK / baud rate rounded to 1/8, which is the resolution of the modulation in the low frequency mode
+  static constexpr uint32_t BAUD_RATE_DIVIDER_EIGHTHS =
+    (SystemClock::SMCLK_FREQUENCY_HZ * 8 + BAUD_RATE / 2) / BAUD_RATE;
+  static constexpr uint32_t BAUD_RATE_DIVIDER = BAUD_RATE_DIVIDER_EIGHTHS / 8;      ///< UCBRx
+  static constexpr uint32_t BAUD_RATE_MODULATION = BAUD_RATE_DIVIDER_EIGHTHS % 8;  ///< UCBRSx
+  static_assert((BAUD_RATE_DIVIDER >= 3) && (BAUD_RATE_DIVIDER <= 0xFFFF), "SMCLK doesn't fit the baud rate");
+
+  char buffer[BUFFER_SIZE] = {};            ///< Ring buffer with the characters to be sent
+  volatile uint8_t head = 0;                ///< Index where the next character will be written
+  volatile uint8_t tail = 0;                ///< Index of the next character to be sent
+  volatile uint16_t droppedCharacters = 0;  ///< Number of characters dropped because the buffer was full
+};
+}  // namespace Microtech
+
+// USCI_A0 and USCI_B0 transmit interruption
+#pragma vector = USCIAB0TX_VECTOR
+__interrupt void USCIAB0TX_ISR(void) {
+  if ((IFG2 & UCA0TXIFG) && (IE2 & UCA0TXIE)) {
+    Microtech::Serial::getInstance().interruptionHappened();
+  }
+}
+
+#endif  // MICROTECH_SERIAL_HPP
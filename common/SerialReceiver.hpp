@@ -0,0 +1,340 @@
+/******************************************************************************
+ * @file                    SerialReceiver.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains a receiver of text commands over the serial port
+ *
+ * Description: The serialAvailable and serialRead of the templateEMP have to be
+ *              polled, so the main loop can never sleep while waiting for a
+ *              command. The SerialReceiver stores the characters in a ring buffer
+ *              from the USCI_A0 receive interruption, and only wakes up the main
+ *              loop when a whole line arrived. The line is then parsed where it is
+ *              in the ring buffer, without being copied.
+ *
+ *              A line is a command name and its arguments, separated by spaces,
+ *              and ends with '\r' or '\n', e.g. "F 2.5". The commands are a
+ *              constant table, so it stays in the flash:
+ *                #include "SerialReceiver.hpp"
+ *                ...
+ *                bool setFrequency(SerialReceiver::Arguments& arguments) {
+ *                  _iq15 frequency;
+ *                  if (!arguments.readFixedPoint(frequency)) {
+ *                    return false;
+ *                  }
+ *                  signalGenerator.setNewFrequency(frequency);
+ *                  return true;
+ *                }
+ *                const SerialCommand COMMANDS[] = {{"F", &setFrequency}};
+ *                ...
+ *                SerialReceiver::getInstance().init();
+ *                while (true) {
+ *                  SerialReceiver::getInstance().process(COMMANDS);
+ *                  idle(ClockRequirement::SMCLK);
+ *                }
+ *
+ *              Every line is answered with "OK" or, if the command is unknown,
+ *              its handler failed or there are arguments left, with "ERR".
+ *
+ *              The receive interruption is shared with the USCI_B0 of the Spi, so
+ *              it is defined by Spi.hpp, which both headers include. This header
+ *              defines MICROTECH_SERIAL_RX, so the interruption dispatches the
+ *              receiver. Without it, init() would enable an interruption that
+ *              never reads UCA0RXBUF, so the first character would call it again
+ *              forever. If Spi.hpp was already included without the receiver, it
+ *              doesn't compile: define MICROTECH_SERIAL_RX before any header.
+ ******************************************************************************/
+#ifndef MICROTECH_SERIALRECEIVER_HPP
+#define MICROTECH_SERIALRECEIVER_HPP
+
+#if defined(MICROTECH_SPI_HPP) && !defined(MICROTECH_SERIAL_RX)
+#error "Spi.hpp defined the receive interruption without the SerialReceiver. Define MICROTECH_SERIAL_RX before it."
+#endif
+#ifndef MICROTECH_SERIAL_RX
+#define MICROTECH_SERIAL_RX
+#endif
+
+#include "LowPower.hpp"
+#include "Serial.hpp"
+#include "helpers.hpp"
+#include "IQmathLib.h"
+#include <msp430g2553.h>
+#include <cstdint>
+
+namespace Microtech {
+
+struct SerialCommand;
+
+class SerialReceiver {
+  friend struct SingletonInstance<SerialReceiver>;
+  constexpr SerialReceiver() = default;
+
+  static constexpr uint8_t BUFFER_SIZE = 32;  ///< Size of the ring buffer. It has to be a power of two.
+  static constexpr uint8_t BUFFER_MASK = BUFFER_SIZE - 1;
+  static_assert((BUFFER_SIZE & BUFFER_MASK) == 0, "The buffer size has to be a power of two");
+
+  static constexpr char LINE_END = '\n';  ///< Stored at the end of every line, whichever was received
+
+public:
+  // Deleted copy and move constructors
+  SerialReceiver(SerialReceiver&) = delete;
+  SerialReceiver(SerialReceiver&&) = delete;
+  ~SerialReceiver() = default;
+
+  /**
+   * Class that reads the arguments of a command directly from the ring buffer.
+   * Every read method skips the spaces before the argument, and only consumes it if it is valid.
+   */
+  class Arguments {
+  public:
+    /**
+     * Constructor
+     * @param buffer Ring buffer with the line
+     * @param index Index of the ring buffer where the line starts
+     */
+    constexpr Arguments(const char* const buffer, const uint8_t index) : buffer(buffer), index(index) {}
+
+    /**
+     * Method to read a word and compare it with a string, e.g. the name of a shape
+     * @param word null-terminated string to be compared
+     * @return true if the next argument is the word, false otherwise
+     */
+    bool readWord(const char* word) noexcept {
+      skipSpaces();
+      uint8_t position = index;
+      while (*word != '\0') {
+        if (buffer[position] != *word++) {
+          return false;
+        }
+        position = (position + 1) & BUFFER_MASK;
+      }
+      if (!isSeparator(buffer[position])) {
+        return false;
+      }
+      index = position;
+      return true;
+    }
+
+    /**
+     * Method to read a decimal number, e.g. "2.5", "-10" or "0.05".
+     * It only uses integer operations, and the digits after the 4th decimal are ignored.
+     * @param[out] value The number, only written if it is valid
+     * @return true if the next argument is a number between -65535 and 65535, false otherwise
+     */
+    bool readFixedPoint(_iq15& value) noexcept {
+      skipSpaces();
+      uint8_t position = index;
+      const bool negative = (buffer[position] == '-');
+      if (negative) {
+        position = (position + 1) & BUFFER_MASK;
+      }
+
+      uint32_t integer = 0;
+      uint32_t fraction = 0;
+      uint16_t fractionScale = 1;
+      bool hasDigits = false;
+      bool isFraction = false;
+      while (!isSeparator(buffer[position])) {
+        const char character = buffer[position];
+        if ((character == '.') && !isFraction) {
+          isFraction = true;
+        } else if ((character >= '0') && (character <= '9')) {
+          hasDigits = true;
+          if (!isFraction) {
+            integer = integer * 10 + static_cast<uint8_t>(character - '0');
+            if (integer > MAXIMUM_INTEGER) {
+              return false;
+            }
+          } else if (fractionScale < MAXIMUM_FRACTION_SCALE) {
+            fraction = fraction * 10 + static_cast<uint8_t>(character - '0');
+            fractionScale *= 10;
+          }
+        } else {
+          return false;
+        }
+        position = (position + 1) & BUFFER_MASK;
+      }
+      if (!hasDigits) {
+        return false;
+      }
+
+      // Rounded to the closest step of Q15
+      const _iq15 magnitude =
+        static_cast<_iq15>((integer << 15) + ((fraction << 15) + fractionScale / 2) / fractionScale);
+      value = negative ? -magnitude : magnitude;
+      index = position;
+      return true;
+    }
+
+    /**
+     * Method to know if every argument was read
+     * @return true if only spaces are left in the line
+     */
+    bool isEnd() noexcept {
+      skipSpaces();
+      return buffer[index] == LINE_END;
+    }
+
+  private:
+    friend class SerialReceiver;
+
+    static constexpr uint32_t MAXIMUM_INTEGER = 0xFFFF;        ///< Largest integer part that fits a _iq15
+    static constexpr uint16_t MAXIMUM_FRACTION_SCALE = 10000;  ///< 4 decimals are already finer than Q15
+
+    static bool isSeparator(const char character) noexcept {
+      return (character == ' ') || (character == LINE_END);
+    }
+
+    void skipSpaces() noexcept {
+      while (buffer[index] == ' ') {
+        index = (index + 1) & BUFFER_MASK;
+      }
+    }
+
+    /**
+     * Method to get the index after the end of the line, which is where the next line starts
+     */
+    uint8_t getNextLine() const noexcept {
+      uint8_t position = index;
+      while (buffer[position] != LINE_END) {
+        position = (position + 1) & BUFFER_MASK;
+      }
+      return (position + 1) & BUFFER_MASK;
+    }
+
+    const char* const buffer;  ///< Ring buffer with the line
+    uint8_t index;             ///< Index of the next character to be read
+  };
+
+  /**
+   * Method that guarantees that there is only one instance of the SerialReceiver class in the software
+   * @return A reference to the instance
+   */
+  static SerialReceiver& getInstance() noexcept {
+    return SingletonInstance<SerialReceiver>::instance;
+  }
+
+  /**
+   * Method that enables the receive interruption. The USCI_A0 must already be configured, either by Serial::init
+   * or by the initMSP of the templateEMP.
+   */
+  void init() noexcept {
+    setRegisterBits(P1SEL, static_cast<uint8_t>(BIT1));  // P1.1 = RXD
+    setRegisterBits(P1SEL2, static_cast<uint8_t>(BIT1));
+    setRegisterBits(IE2, static_cast<uint8_t>(UCA0RXIE));
+  }
+
+  /**
+   * Method to be called by the main loop. It executes every line received since the last call.
+   * @param commands Table with the commands
+   */
+  template<uint8_t NUMBER_OF_COMMANDS>
+  void process(const SerialCommand (&commands)[NUMBER_OF_COMMANDS]) noexcept;
+
+  /**
+   * Method to get the number of lines dropped because they didn't fit the buffer or had a reception error
+   * @return The number of dropped lines
+   */
+  uint16_t getDroppedLines() const noexcept {
+    return droppedLines;
+  }
+
+  /**
+   * Method to get which clock has to keep running while the CPU is sleeping.
+   * The USCI runs with SMCLK, so it has to keep running to receive a command at any time.
+   * @return The clock requirement of the receiver
+   */
+  ClockRequirement getClockRequirement() const noexcept {
+    return (IE2 & UCA0RXIE) ? ClockRequirement::SMCLK : ClockRequirement::NONE;
+  }
+
+  /**
+   * Method called by the USCI_A0 receive interruption. It stores the received character, and wakes up the main loop
+   * when a line is complete.
+   */
+  void interruptionHappened() noexcept {
+    // The status has to be read before the buffer, since reading the buffer clears the errors.
+    const bool receptionError = UCA0STAT & UCRXERR;
+    const char character = static_cast<char>(UCA0RXBUF);
+    if ((character == '\r') || (character == '\n')) {
+      if (discardingLine || (head == lineStart)) {
+        // The end of a dropped line, or of an empty one, e.g. the '\n' after a '\r'
+        discardingLine = false;
+        return;
+      }
+      buffer[head] = LINE_END;
+      head = (head + 1) & BUFFER_MASK;
+      lineStart = head;
+      receivedLines++;
+      LowPower::requestWakeUp();
+      return;
+    }
+
+    if (discardingLine) {
+      return;
+    }
+    // The character only fits if there is still space left for the end of the line.
+    const uint8_t freeSpace = static_cast<uint8_t>(tail - head - 1) & BUFFER_MASK;
+    if (receptionError || (freeSpace < 2)) {
+      head = lineStart;
+      discardingLine = true;
+      droppedLines++;
+      return;
+    }
+    buffer[head] = character;
+    head = (head + 1) & BUFFER_MASK;
+  }
+
+private:
+  char buffer[BUFFER_SIZE] = {};       ///< Ring buffer with the received lines
+  volatile uint8_t head = 0;           ///< Index where the next character will be written
+  volatile uint8_t tail = 0;           ///< Index where the oldest line not yet executed starts
+  uint8_t lineStart = 0;               ///< Index where the line being received starts
+  bool discardingLine = false;         ///< If the line being received is dropped until its end
+  volatile uint8_t receivedLines = 0;  ///< Lines completed by the interruption, wraps around
+  uint8_t processedLines = 0;          ///< Lines executed by the main loop, wraps around
+  volatile uint16_t droppedLines = 0;  ///< Lines dropped because they didn't fit the buffer or had an error
+};
+
+/**
+ * Entry of the table of commands
+ */
+struct SerialCommand {
+  /**
+   * Type definition of the function that executes a command
+   * @param arguments The arguments after the name of the command
+   * @return true if the arguments were valid and the command was executed, false otherwise
+   */
+  typedef bool (*Handler)(SerialReceiver::Arguments& arguments);
+
+  const char* name;  ///< First word of the line, e.g. "F"
+  Handler handler;   ///< Function that executes the command
+};
+
+template<uint8_t NUMBER_OF_COMMANDS>
+void SerialReceiver::process(const SerialCommand (&commands)[NUMBER_OF_COMMANDS]) noexcept {
+  // The interruption only increases receivedLines and the main loop only processedLines, so no lock is needed.
+  while (receivedLines != processedLines) {
+    Arguments arguments(buffer, tail);
+    bool executed = false;
+    for (const SerialCommand& command : commands) {
+      if (arguments.readWord(command.name)) {
+        executed = command.handler(arguments) && arguments.isEnd();
+        break;
+      }
+    }
+    Serial::getInstance().println(executed ? "OK" : "ERR");
+
+    // Releases the line, so the interruption can write over it.
+    tail = arguments.getNextLine();
+    processedLines++;
+  }
+}
+}  // namespace Microtech
+
+// Defines the receive interruption, which also dispatches the SPI
+#include "Spi.hpp"
+
+#endif  // MICROTECH_SERIALRECEIVER_HPP
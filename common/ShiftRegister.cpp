@@ -3,23 +3,12 @@
 namespace Microtech {
 
 void ShiftRegisterBase::setMode(const Mode mode) const noexcept {
+  // S0 and S1 are set together, so when they are on the same port it is a single write.
   switch (mode) {
-    case ShiftRegisterBase::Mode::PAUSE:
-      s0.setState(IOState::LOW);
-      s1.setState(IOState::LOW);
-      break;
-    case ShiftRegisterBase::Mode::SHIFT_RIGHT:
-      s0.setState(IOState::HIGH);
-      s1.setState(IOState::LOW);
-      break;
-    case ShiftRegisterBase::Mode::SHIFT_LEFT:
-      s0.setState(IOState::LOW);
-      s1.setState(IOState::HIGH);
-      break;
-    case ShiftRegisterBase::Mode::MIRROR_PARALLEL:
-      s0.setState(IOState::HIGH);
-      s1.setState(IOState::HIGH);
-      break;
+    case ShiftRegisterBase::Mode::PAUSE: s0.setStates(false, s1, false); break;
+    case ShiftRegisterBase::Mode::SHIFT_RIGHT: s0.setStates(true, s1, false); break;
+    case ShiftRegisterBase::Mode::SHIFT_LEFT: s0.setStates(false, s1, true); break;
+    case ShiftRegisterBase::Mode::MIRROR_PARALLEL: s0.setStates(true, s1, true); break;
   };
 }
 
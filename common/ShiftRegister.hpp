@@ -155,24 +155,28 @@ public:
     inputQD.init();
   }
 
+  /**
+   * Reads the PBs. The parallel load overwrites every output, so the register doesn't need to be cleared before,
+   * and only input D to B have to be shifted to QD.
+   * @return The state of the PBs, with input A in bit 0 and input D in bit 3
+   */
   uint8_t getPBValues() const noexcept {
-      constexpr uint8_t NUM_SHIFTS_TO_READ = 5;  // Since its 4 bits, we need to have 4 shifts + 1.
-
-      uint8_t returnValue = 0;
-      reset();  // clears the register
-      setMode(Mode::MIRROR_PARALLEL);
-      for (uint8_t i = 0; i < NUM_SHIFTS_TO_READ; i++) {
-        const IOState currentState = inputQD.getState();
-        if (currentState == IOState::HIGH) {
-            returnValue |= 0x1;
-        }
-        returnValue <<= 0x01;
-        ShiftRegisterBase::clockOneCycle();
-        setMode(ShiftRegisterBase::Mode::SHIFT_RIGHT);
+    constexpr uint8_t NUM_SHIFTS_TO_READ = 3;  // QD already has input D after the load, so 3 shifts read C to A.
+
+    start();  // Makes sure the register is not held cleared
+    setMode(Mode::MIRROR_PARALLEL);
+    ShiftRegisterBase::clockOneCycle();
+    setMode(Mode::SHIFT_RIGHT);
+    uint8_t returnValue = (inputQD.getState() == IOState::HIGH) ? 0x1 : 0x0;
+    for (uint8_t i = 0; i < NUM_SHIFTS_TO_READ; i++) {
+      ShiftRegisterBase::clockOneCycle();
+      returnValue <<= 0x01;
+      if (inputQD.getState() == IOState::HIGH) {
+        returnValue |= 0x1;
       }
-      returnValue >>= 0x01;
-      setMode(Mode::PAUSE);
-      return returnValue;
+    }
+    setMode(Mode::PAUSE);
+    return returnValue;
   }
 
   /**
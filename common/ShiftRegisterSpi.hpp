@@ -0,0 +1,191 @@
+/******************************************************************************
+ * @file                    ShiftRegisterSpi.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains the shift registers of the LEDs and PBs driven by the SPI
+ *
+ * Description: The classes have the same interface as ShiftRegisterLED and
+ *              ShiftRegisterPB, but the bits are shifted by the USCI_B0 instead of
+ *              toggling the clock pin for each bit. So the application selects
+ *              the backend only by the type of the shift register.
+ *
+ *              It can only be used when the shift register is wired to the pins of
+ *              the USCI_B0: CLK to P1.5, the serial input (SR) of the LED shift
+ *              register to P1.7 and the output QD of the PB shift register to P1.6.
+ *              CLR, S0 and S1 are still controlled by any GPIO, since the mode of the
+ *              shift register changes between the bytes.
+ *
+ *              A whole byte is always shifted, so 8 clock cycles are sent, but only
+ *              the last 4 bits stay in the shift register.
+ ******************************************************************************/
+#ifndef MICROTECH_SHIFTREGISTERSPI_HPP
+#define MICROTECH_SHIFTREGISTERSPI_HPP
+
+#include "GPIOs.hpp"
+#include "ShiftRegister.hpp"
+#include "Spi.hpp"
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Base of the shift registers driven by the SPI. The clock is always the UCB0CLK pin.
+ */
+class SpiShiftRegisterBase : public ShiftRegisterBase {
+public:
+  constexpr SpiShiftRegisterBase(const OutputHandle& clearHandle, const OutputHandle& s0Handle,
+                                 const OutputHandle& s1Handle)
+    : ShiftRegisterBase(GPIOs::getOutputHandle<IOPort::PORT_1, static_cast<uint8_t>(5)>(), clearHandle, s0Handle,
+                        s1Handle) {}
+
+  /**
+   * Initializes the shift register like the ShiftRegisterBase, and then gives the clock pin to the SPI.
+   * @param clockDivider Divider of SMCLK that generates the clock of the shift register
+   */
+  void init(const uint16_t clockDivider = 1) const noexcept {
+    ShiftRegisterBase::init();
+    Spi::getInstance().init(clockDivider);
+  }
+
+  /**
+   * Method to know if a write or read started without waiting is still running
+   * @return true if it is still running
+   */
+  bool isBusy() const noexcept {
+    return Spi::getInstance().isBusy();
+  }
+};
+
+/**
+ * Class that represents the Shift register connected to the LED, driven by the SPI
+ */
+class SpiShiftRegisterLED : public SpiShiftRegisterBase {
+public:
+  constexpr SpiShiftRegisterLED(const OutputHandle& clearHandle, const OutputHandle& s0Handle,
+                                const OutputHandle& s1Handle)
+    : SpiShiftRegisterBase(clearHandle, s0Handle, s1Handle) {}
+
+  /**
+   * Writes the value and waits until it was shifted.
+   * @param value Value from 0x0 to 0xF. QA shows bit 0 and QD shows bit 3.
+   */
+  void writeValue(const uint8_t value) noexcept {
+    if (!prepareWrite(value)) {
+      return;
+    }
+    Spi::getInstance().transfer(value);
+    setMode(Mode::PAUSE);
+  }
+
+  /**
+   * Starts to write the value without waiting. The shift register is paused again by the SPI interruption.
+   * @param value Value from 0x0 to 0xF. QA shows bit 0 and QD shows bit 3.
+   * @return false if the SPI is still busy, so the value was not written
+   */
+  bool startWriteValue(const uint8_t value) noexcept {
+    if (isBusy()) {
+      return false;
+    }
+    if (prepareWrite(value)) {
+      Spi::getInstance().startTransfer(value, &writeCompleted, this);
+    }
+    return true;
+  }
+
+private:
+  /**
+   * Clears the register and sets it to shift right, unless the value is invalid or already shown.
+   * @return true if the value has to be shifted
+   */
+  bool prepareWrite(const uint8_t value) noexcept {
+    // Cannot print a value more than 0xF, since it is more than 4 bits.
+    constexpr uint8_t MAX_PRINT_VAL = 0xF;
+    if (value > MAX_PRINT_VAL || value == currentValue) {
+      return false;
+    }
+    currentValue = value;
+    reset();  // clears the register
+    setMode(Mode::SHIFT_RIGHT);
+    return true;
+  }
+
+  static void writeCompleted(void* context, const uint8_t /*received*/) {
+    static_cast<SpiShiftRegisterLED*>(context)->setMode(Mode::PAUSE);
+  }
+
+  uint8_t currentValue = 0;  ///< Value shown by the LEDs
+};
+
+/**
+ * Class that represents the Shift register connected to the PB, driven by the SPI
+ */
+class SpiShiftRegisterPB : public SpiShiftRegisterBase {
+public:
+  typedef void (*ReadCallback)(uint8_t pbValues);  ///< Type definition of the callback of a read without waiting
+
+  constexpr SpiShiftRegisterPB(const OutputHandle& clearHandle, const OutputHandle& s0Handle,
+                               const OutputHandle& s1Handle)
+    : SpiShiftRegisterBase(clearHandle, s0Handle, s1Handle) {}
+
+  /**
+   * Reads the PBs and waits until they were shifted.
+   * @return The state of the PBs, with input A in bit 0 and input D in bit 3, like ShiftRegisterPB.
+   */
+  uint8_t getPBValues() const noexcept {
+    Spi& spi = Spi::getInstance();
+    reset();  // clears the register
+    setMode(Mode::MIRROR_PARALLEL);
+    spi.transfer(0);
+    setMode(Mode::SHIFT_RIGHT);
+    const uint8_t received = spi.transfer(0);
+    setMode(Mode::PAUSE);
+    return toPBValues(received);
+  }
+
+  /**
+   * Starts to read the PBs without waiting. The callback is called from the SPI interruption.
+   * @param callback Function called with the state of the PBs
+   * @return false if the SPI is still busy, so the read was not started
+   */
+  bool startReadPBValues(const ReadCallback callback) noexcept {
+    if (isBusy()) {
+      return false;
+    }
+    readCallback = callback;
+    reset();  // clears the register
+    setMode(Mode::MIRROR_PARALLEL);
+    Spi::getInstance().startTransfer(0, &loadCompleted, this);
+    return true;
+  }
+
+private:
+  /**
+   * The SPI samples QD on each rising edge before the shift, so the first received bit, which is the MSB, is input D.
+   * The lowest 4 bits shifted the serial input, so they are discarded.
+   */
+  static constexpr uint8_t toPBValues(const uint8_t received) noexcept {
+    return static_cast<uint8_t>(received >> 4);
+  }
+
+  static void loadCompleted(void* context, const uint8_t /*received*/) {
+    SpiShiftRegisterPB* const shiftRegister = static_cast<SpiShiftRegisterPB*>(context);
+    shiftRegister->setMode(Mode::SHIFT_RIGHT);
+    Spi::getInstance().startTransfer(0, &shiftCompleted, context);
+  }
+
+  static void shiftCompleted(void* context, const uint8_t received) {
+    SpiShiftRegisterPB* const shiftRegister = static_cast<SpiShiftRegisterPB*>(context);
+    shiftRegister->setMode(Mode::PAUSE);
+    if (shiftRegister->readCallback != nullptr) {
+      shiftRegister->readCallback(toPBValues(received));
+    }
+  }
+
+  ReadCallback readCallback = nullptr;  ///< Function called when the read without waiting is complete
+};
+}  // namespace Microtech
+
+#endif  // MICROTECH_SHIFTREGISTERSPI_HPP
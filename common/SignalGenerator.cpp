@@ -0,0 +1,12 @@
+#include "SignalGenerator.hpp"
+
+namespace Microtech {
+
+constexpr Sinusoidal::Table Sinusoidal::SINE_TABLE;
+constexpr Trapezoidal::IntervalPhases Trapezoidal::PHASE_1;
+constexpr Trapezoidal::IntervalPhases Trapezoidal::PHASE_2;
+constexpr Trapezoidal::IntervalPhases Trapezoidal::PHASE_3;
+constexpr Trapezoidal::IntervalPhases Trapezoidal::PHASE_4;
+const uint16_t WaveformTable::SILENCE[1] = {0};
+
+}  // namespace Microtech
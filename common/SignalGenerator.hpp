@@ -8,13 +8,40 @@ namespace Microtech {
 
 #define PI 3.1415926536
 
+/**
+ * @brief Sine function that can be evaluated in compile time.
+ * It is only intended to generate look up tables, since it uses a Taylor series with doubles.
+ * @param[in] angle Angle in radians
+ * @return sine of the angle
+ */
+constexpr double constexprSin(double angle) {
+  // Brings the angle to the range of -pi to pi, where the series converges fast.
+  while (angle > PI) {
+    angle -= 2 * PI;
+  }
+  while (angle < -PI) {
+    angle += 2 * PI;
+  }
+  double term = angle;
+  double result = angle;
+  for (uint8_t i = 1; i < 12; i++) {
+    term *= -angle * angle / ((2 * i) * (2 * i + 1));
+    result += term;
+  }
+  return result;
+}
+
 /**
  * @class SignalProperties
  * @brief Class for storing properties of the signal
+ *
+ * The phase of the signal is a direct digital synthesis (DDS) phase accumulator. The full range of the
+ * accumulator (2^32) represents 2pi, so increasing the phase is a single addition, and it wraps naturally
+ * back to 0 at 2pi.
  */
 class SignalProperties {
 public:
-  using PhaseType = _iq15;
+  using PhaseType = uint32_t;
   /**
    * @brief deleted default constructor
    */
@@ -32,25 +59,25 @@ public:
   /**
    * @brief set the new frequency of the signal
    * @param[in] newFrequency new frequency of the signal
+   *
+   * The phase step is 2^32 * currentFrequency/samplingFreqHz. It is only calculated when the frequency changes.
    */
   void setNewFrequency(const _iq15 newFrequency) {
     currentFrequency = newFrequency;
-    // 2*pi*currentFrequency/samplingFreqHz
-    const _iq15 freqInCyclesPerSecond = _IQ15mpy(_IQ15(2 * PI), currentFrequency);
-    phaseStep = _IQ15div(freqInCyclesPerSecond, _IQ15(samplingFreqHz));
+    phaseStep = static_cast<PhaseType>(_IQ15toF(currentFrequency) * (PHASE_RANGE / samplingFreqHz));
   }
 
   /**
    * @brief increase the phase of the signal
    */
   void increasePhase() noexcept {
-    // calculate new phase and keep it within 0 and 2pi.
-    currentPhase = std::fmod((currentPhase + phaseStep), _IQ15(2 * PI));
+    // The accumulator overflow keeps the phase within 0 and 2pi.
+    currentPhase += phaseStep;
   }
 
   /**
    * @brief get the current phase of the signal
-   * @return current phase of the signal
+   * @return current phase of the signal, where 2^32 represents 2pi
    */
   PhaseType getCurrentPhase() const noexcept {
     return currentPhase;
@@ -60,6 +87,8 @@ public:
     return currentFrequency;
   }
 
+  static constexpr float PHASE_RANGE = 4294967296.0f;  ///< Value that represents 2pi in the phase accumulator
+
 private:
   const uint16_t samplingFreqHz;  ///< Sampling frequency of the signal
   _iq15 currentFrequency = 0;     ///< Current frequency of the signal
@@ -69,27 +98,69 @@ private:
 };
 
 /**
- * @class iSignalType
- * @brief Interface for the different types of signals
+ * @class SineTable
+ * @brief Look up table of one period of the sine, scaled from 0 to 100.
+ *
+ * The table is generated in compile time and, since it is constant, it is stored in flash.
+ * It is indexed by the top bits of the phase accumulator.
+ *
+ * @tparam INDEX_BITS Number of bits of the phase used as index. The table has 2^INDEX_BITS entries.
  */
-class iSignalType {
+template<uint8_t INDEX_BITS>
+class SineTable {
 public:
+  static constexpr uint16_t NUM_ENTRIES = 1U << INDEX_BITS;  ///< Number of entries of the table
+
   /**
-   * @brief default constructor
+   * @brief constructor evaluated in compile time that fills the table
    */
-  iSignalType() = default;
+  constexpr SineTable() : values() {
+    for (uint16_t i = 0; i <= NUM_ENTRIES; i++) {
+      // sin gives value from -1 to 1, so we add 1 and multiply by 50 so the output goes from 0 to 100.
+      values[i] = _IQ15(50.0 + 50.0 * constexprSin(2 * PI * i / NUM_ENTRIES));
+    }
+  }
 
   /**
-   * @brief default destructor
+   * @brief get the table value closest to the phase
+   * @param[in] phase Phase of the signal, where 2^32 represents 2pi
+   * @return sine value, from 0 to 100
    */
-  virtual ~iSignalType() = default;
+  constexpr _iq15 getValue(const SignalProperties::PhaseType phase) const noexcept {
+    return values[phase >> PHASE_SHIFT];
+  }
 
   /**
-   * @brief pure virtual function to get the next point of the signal
-   * @param[in] signal Signal properties
-   * @return next point of the signal
+   * @brief get the sine value linearly interpolated between the two closest table entries
+   * @param[in] phase Phase of the signal, where 2^32 represents 2pi
+   * @return sine value, from 0 to 100
    */
-  virtual _iq15 getNextPoint(SignalProperties& signal) noexcept = 0;
+  constexpr _iq15 getInterpolatedValue(const SignalProperties::PhaseType phase) const noexcept {
+    const uint16_t index = phase >> PHASE_SHIFT;
+    // The next 8 bits after the index are the fraction between two entries.
+    const int16_t fraction = (phase >> (PHASE_SHIFT - 8)) & 0xFF;
+    // The table has one entry more than the period, so the index + 1 never needs to wrap.
+    return values[index] + (values[index + 1] - values[index]) * fraction / 256;
+  }
+
+private:
+  static constexpr uint8_t PHASE_SHIFT = 32 - INDEX_BITS;  ///< Shift to get the index from the phase
+  _iq15 values[NUM_ENTRIES + 1];  ///< One period of the sine. The last entry repeats the first one.
+};
+
+/**
+ * @class SignalShapeBase
+ * @brief Base of the different types of signals
+ *
+ * The shapes only have static functions and constants, so they don't need instances in RAM, and the signal
+ * generator calls them directly, which lets the compiler inline them.
+ */
+class SignalShapeBase {
+public:
+  /**
+   * @brief deleted default constructor, since the shapes are never instantiated
+   */
+  SignalShapeBase() = delete;
 
 protected:
   static constexpr _iq15 MAXIMUM_AMPLITUDE = _IQ15(100.0);
@@ -97,156 +168,202 @@ protected:
 
 /**
  * @brief Class representing a Sinusoidal signal
+ * The sine is read from a look up table in flash, so the cost of a point is only a table load.
  */
-class Sinusoidal : public iSignalType {
+class Sinusoidal : public SignalShapeBase {
 public:
   /**
-   * @brief default constructor
+   * @brief get the next point of the Sinusoidal signal
+   * @param[in] phase Current phase of the signal
+   * @return next point of the Sinusoidal signal
    */
-  Sinusoidal() = default;
+  static _iq15 getNextPoint(const SignalProperties::PhaseType phase) noexcept {
+    return SINE_TABLE.getValue(phase);
+  }
 
   /**
-   * @brief get the next point of the Sinusoidal signal
-   * @param[in] signal Signal properties
+   * @brief get the next point of the Sinusoidal signal, linearly interpolated between the table entries
+   * @param[in] phase Current phase of the signal
    * @return next point of the Sinusoidal signal
    */
-  _iq15 getNextPoint(SignalProperties& signal) noexcept override {
-    // sin gives value from -1 to 1, so we add 1 to get the output from 0 to 2
-    const _iq15 sineValue = _IQ15sin(signal.getCurrentPhase()) + _IQ15(1);
-    const _iq15 HALF_OF_MAX_AMPLITUDE = _IQ15div(MAXIMUM_AMPLITUDE, _IQ15(2.0));
-
-    // Multiply by 50.0 since our maximum value is 100.0 and the maximum from the sine is 2.
-    const _iq15 sineScaled = _IQ15mpy(sineValue, HALF_OF_MAX_AMPLITUDE);
-    return sineScaled;
+  static _iq15 getNextInterpolatedPoint(const SignalProperties::PhaseType phase) noexcept {
+    return SINE_TABLE.getInterpolatedValue(phase);
   }
+
+private:
+  using Table = SineTable<8>;  ///< 256 entries, so the top 8 bits of the phase are the index
+  static constexpr Table SINE_TABLE{};
 };
 
 /**
  * @brief Class representing Trapezoidal signal
  */
-class Trapezoidal : public iSignalType {
+class Trapezoidal : public SignalShapeBase {
 public:
-  /**
-   * @brief default constructor
-   */
-  Trapezoidal() = default;
-
   /**
    * @brief get the next point of the Trapezoidal signal
-   * @param[in] signal Signal properties
+   * @param[in] phase Current phase of the signal
    * @return next point of the Trapezoidal signal
    */
-  _iq15 getNextPoint(SignalProperties& signal) noexcept override {
-    const _iq15 currentPhase = signal.getCurrentPhase();
-    const _iq15 slope = getSlope();
-    const _iq15 yIntercept = getYIntercept();
-
-    // Use a switch case to check for the current phase
-    switch (getCurrentPhase(currentPhase)) {
-      case Phase::PHASE_1: return _IQ15mpy(slope, currentPhase) + yIntercept;
-      case Phase::PHASE_2: return MAXIMUM_AMPLITUDE;
-      case Phase::PHASE_3:
-        // The last constant value has to be added to compensate since the angle is higher
-        return _IQ15mpy(_IQ15(-1),_IQ15mpy(currentPhase,slope)) + yIntercept + _IQ15(300.0);
-      case Phase::PHASE_4: return _IQ15(0.0);
-      case Phase::PHASE_5: return _IQ15mpy(slope, currentPhase) + yIntercept - _IQ15(600.0);
-      default: return _IQ15(0.0);
+  static _iq15 getNextPoint(const SignalProperties::PhaseType phase) noexcept {
+    if (phase < PHASE_1.end) {
+      return getYIntercept() + getRamp(phase - PHASE_1.start);
+    } else if (phase < PHASE_2.end) {
+      return MAXIMUM_AMPLITUDE;
+    } else if (phase < PHASE_3.end) {
+      return MAXIMUM_AMPLITUDE - getRamp(phase - PHASE_3.start);
+    } else if (phase < PHASE_4.end) {
+      return _IQ15(0.0);
+    } else {
+      // The last phase goes until the accumulator wraps.
+      return getRamp(phase - PHASE_5_START);
     }
   }
 
 private:
   /**
-   * @brief Get the slope of the Trapezoidal signal
-   * @return The slope of the Trapezoidal signal
+   * @brief Get the value the signal increased since the beginning of a ramp.
+   * The ramp goes from 0 to 100 in 60 degrees.
+   * @param[in] phaseSinceRampStart Phase since the ramp started
+   * @return The value of the ramp
    */
-  _iq15 getSlope() const noexcept {
-    return _IQ15div(MAXIMUM_AMPLITUDE, DEG60_IN_RAD);
+  static _iq15 getRamp(const SignalProperties::PhaseType phaseSinceRampStart) noexcept {
+    // Only the top 16 bits of the phase are used, so the multiplication doesn't overflow.
+    return static_cast<int32_t>(phaseSinceRampStart >> 16) * SLOPE_PER_PHASE_STEP;
   }
 
   /**
    * @brief Get the y-intercept of the Trapezoidal signal
    * @return The y-intercept of the Trapezoidal signal
    */
-  constexpr _iq15 getYIntercept() const noexcept {
+  static constexpr _iq15 getYIntercept() noexcept {
     return _IQ15(50.0);
   }
 
   // define a struct to store the phase intervals
   struct IntervalPhases {
-    _iq15 start;
-    _iq15 end;
+    SignalProperties::PhaseType start;
+    SignalProperties::PhaseType end;
   };
 
-  enum class Phase {
-      PHASE_1,
-      PHASE_2,
-      PHASE_3,
-      PHASE_4,
-      PHASE_5
-  };
-  const IntervalPhases PHASE_1 = {DEG0_IN_RAD, DEG30_IN_RAD};
-  const IntervalPhases PHASE_2 = {DEG30_IN_RAD, DEG150_IN_RAD};
-  const IntervalPhases PHASE_3 = {DEG150_IN_RAD, DEG210_IN_RAD};
-  const IntervalPhases PHASE_4 = {DEG210_IN_RAD, DEG330_IN_RAD};
-  const IntervalPhases PHASE_5 = {DEG330_IN_RAD, DEG360_IN_RAD};
-
-  /**
-   * @brief Get the current phase of the signal
-   * @param[in] currentPhase The current phase of the signal
-   * @return The current phase of the signal
-   */
-  Phase getCurrentPhase(const _iq15 currentPhase) const {
-    if (currentPhase >= PHASE_1.start && currentPhase < PHASE_1.end) {
-      return Phase::PHASE_1;
-    } else if (currentPhase >= PHASE_2.start && currentPhase < PHASE_2.end) {
-      return Phase::PHASE_2;
-    } else if (currentPhase >= PHASE_3.start && currentPhase < PHASE_3.end) {
-      return Phase::PHASE_3;
-    } else if (currentPhase >= PHASE_4.start && currentPhase < PHASE_4.end) {
-      return Phase::PHASE_4;
-    } else if (currentPhase >= PHASE_5.start && currentPhase < PHASE_5.end) {
-      return Phase::PHASE_5;
-    } else {
-      return Phase::PHASE_1;
-    }
+  // Phases in the phase accumulator scale, where 2^32 represents 360 degrees.
+  static constexpr SignalProperties::PhaseType DEG0 = 0;
+  static constexpr SignalProperties::PhaseType DEG30 = 0x100000000ULL / 12;
+  static constexpr SignalProperties::PhaseType DEG60 = 0x100000000ULL / 6;
+  static constexpr SignalProperties::PhaseType DEG120 = 0x100000000ULL / 3;
+  static constexpr SignalProperties::PhaseType DEG150 = DEG30 + DEG120;
+  static constexpr SignalProperties::PhaseType DEG210 = DEG150 + DEG60;
+  static constexpr SignalProperties::PhaseType DEG330 = DEG210 + DEG120;
+
+  /// Increase of the ramp for each step of the top 16 bits of the phase. 100 in 60 degrees.
+  static constexpr _iq15 SLOPE_PER_PHASE_STEP = _IQ15(100.0 * 6 / 65536);
+
+  static constexpr IntervalPhases PHASE_1 = {DEG0, DEG30};
+  static constexpr IntervalPhases PHASE_2 = {DEG30, DEG150};
+  static constexpr IntervalPhases PHASE_3 = {DEG150, DEG210};
+  static constexpr IntervalPhases PHASE_4 = {DEG210, DEG330};
+  static constexpr SignalProperties::PhaseType PHASE_5_START = DEG330;
+};
+
+/**
+ * @brief Class representing Rectangular signal
+ */
+class Rectangular : public SignalShapeBase {
+public:
+  /**
+   * @brief get the next point of the Rectangular signal
+   * @param[in] phase Current phase of the signal
+   * @return next point of the Rectangular signal
+   */
+  static _iq15 getNextPoint(const SignalProperties::PhaseType phase) noexcept {
+    // Half of the accumulator range is pi.
+    return phase < HALF_PERIOD ? MAXIMUM_AMPLITUDE : _IQ15(0.0);
   }
 
-  static constexpr _iq15 DEG0_IN_RAD = _IQ15(0);
-  static constexpr _iq15 DEG30_IN_RAD = _IQ15(PI / 6);
-  static constexpr _iq15 DEG60_IN_RAD = _IQ15(PI / 3);
-  static constexpr _iq15 DEG120_IN_RAD = _IQ15(2 * PI / 3);
-  static constexpr _iq15 DEG150_IN_RAD = DEG30_IN_RAD + DEG120_IN_RAD;
-  static constexpr _iq15 DEG210_IN_RAD = DEG150_IN_RAD + DEG60_IN_RAD;
-  static constexpr _iq15 DEG330_IN_RAD = DEG210_IN_RAD + DEG120_IN_RAD;
-  static constexpr _iq15 DEG360_IN_RAD = _IQ15(2 * PI);
+private:
+  static constexpr SignalProperties::PhaseType HALF_PERIOD = 0x80000000UL;
 };
 
 /**
- * @brief Class representing Rectangular signal
+ * @class WaveformTable
+ * @brief One period of an arbitrary waveform, played by the phase accumulator like the sine table.
+ *
+ * The samples go from 0 (0%) to 65535 (100%) and can be in flash, e.g. a constant table, or in RAM, e.g. uploaded
+ * over the serial port. The table only points to them, so RAM samples can be changed while the signal is played.
+ *
+ * The number of samples is a power of two up to 256, so the index and the fraction between two samples come from
+ * the top 16 bits of the phase with a single shift. The last sample is followed again by the first one.
+ *  @code
+ *      constexpr uint16_t SAWTOOTH[] = {0, 8192, 16384, 24576, 32768, 40960, 49152, 57344};
+ *      signalGenerator.setArbitraryWaveform(makeWaveformTable(SAWTOOTH, true));
+ *      signalGenerator.setActiveSignalShape(SignalGenerator::Shape::ARBITRARY);
+ *  @endcode
  */
-class Rectangular : public iSignalType {
+class WaveformTable {
 public:
+  static constexpr uint16_t MAX_NUM_SAMPLES = 256;  ///< The index has to fit the top 8 bits of the shifted phase
+
   /**
-   * @brief default constructor
+   * @brief constructor of a table with a single sample of 0, so the output stays at 0 until a table is set
    */
-  Rectangular() = default;
+  constexpr WaveformTable() : WaveformTable(SILENCE, 0, false) {}
 
   /**
-   * @brief get the next point of the Rectangular signal
-   * @param[in] signal Signal properties
-   * @return next point of the Rectangular signal
+   * @brief constructor
+   * @param[in] samples First of the 2^indexBits samples. They are not copied.
+   * @param[in] indexBits Number of bits of the phase used as index, from 0 to 8
+   * @param[in] interpolated If the output is linearly interpolated between two samples
    */
-  _iq15 getNextPoint(SignalProperties& signal) noexcept override {
-    _iq15 retVal = 0;
-    if (signal.getCurrentPhase() < _IQ15(PI)) {
-      retVal = MAXIMUM_AMPLITUDE;
-    } else {
-      retVal = _IQ15(0);
+  constexpr WaveformTable(const uint16_t* samples, const uint8_t indexBits, const bool interpolated)
+    : samples(samples),
+      indexMask(static_cast<uint8_t>((1U << indexBits) - 1)),
+      fractionShift(static_cast<uint8_t>(8 - indexBits)),
+      interpolated(interpolated) {}
+
+  /**
+   * @brief get the point of the waveform at the phase
+   * @param[in] phase Phase of the signal, where 2^32 represents 2pi
+   * @return point of the waveform, from 0 to 100
+   */
+  _iq15 getValue(const SignalProperties::PhaseType phase) const noexcept {
+    // The index is the high byte and the fraction between two samples the low byte.
+    const uint16_t position = static_cast<uint16_t>(phase >> 16) >> fractionShift;
+    const uint8_t index = static_cast<uint8_t>(position >> 8);
+    int32_t sample = samples[index];
+    if (interpolated) {
+      const int32_t nextSample = samples[(index + 1) & indexMask];
+      sample += (nextSample - sample) * static_cast<uint8_t>(position) / 256;
     }
-    return retVal;
+    // 65536 is 100, so the Q15 of a sample is 100 * 2^15 / 2^16 = 50 times it.
+    return static_cast<_iq15>(sample * 50);
   }
+
+private:
+  static const uint16_t SILENCE[1];  ///< Sample of the default table
+
+  const uint16_t* samples;  ///< First sample of the period
+  uint8_t indexMask;        ///< Number of samples - 1
+  uint8_t fractionShift;    ///< Shift of the top 16 bits of the phase to get the index in the high byte
+  bool interpolated;        ///< If the output is interpolated between two samples
 };
 
+/**
+ * @brief create a waveform table of an array of samples
+ * @param[in] samples Array of samples, from 0 (0%) to 65535 (100%). Its size has to be a power of two up to 256.
+ * @param[in] interpolated If the output is linearly interpolated between two samples
+ * @return the table pointing to the samples
+ */
+template<uint16_t NUM_SAMPLES>
+constexpr WaveformTable makeWaveformTable(const uint16_t (&samples)[NUM_SAMPLES], const bool interpolated) {
+  static_assert((NUM_SAMPLES & (NUM_SAMPLES - 1)) == 0, "The number of samples has to be a power of two");
+  static_assert(NUM_SAMPLES <= WaveformTable::MAX_NUM_SAMPLES, "The table can have up to 256 samples");
+  uint8_t indexBits = 0;
+  while ((1U << indexBits) < NUM_SAMPLES) {
+    indexBits++;
+  }
+  return WaveformTable(samples, indexBits, interpolated);
+}
+
 /**
  * @brief Generates different types of signals (sinusoidal, trapezoidal, and rectangular) and switch between them.
  */
@@ -260,6 +377,7 @@ public:
     SINUSOIDAL,   ///< Signal shape representing sinusoidal signal
     TRAPEZOIDAL,  ///< Signal shape representing trapezoidal signal
     RECTANGULAR,  ///< Signal shape representing rectangular signal
+    ARBITRARY,    ///< Signal shape of the waveform table set by setArbitraryWaveform
   };
 
   /**
@@ -267,7 +385,7 @@ public:
    * It sets the active signal to a sinusoidal signal and sets the signalProperties using the given sampling frequency.
    * @param[in] samplingFreqHz Sampling frequency in Hz
    */
-  explicit SignalGenerator(uint16_t samplingFreqHz) : activeSignal(&sinusoidal), signalProperties(samplingFreqHz) {}
+  explicit SignalGenerator(uint16_t samplingFreqHz) : signalProperties(samplingFreqHz) {}
 
   /**
    * @brief get the next data point of the active signal
@@ -275,8 +393,38 @@ public:
    */
   _iq15 getNextDatapoint() noexcept {
     signalProperties.increasePhase();
-    return _IQ15mpy(activeSignal->getNextPoint(signalProperties), outputAmplitudePercentage)
-           + _IQ15mpy(_IQ15(1.0) - outputAmplitudePercentage, _IQ15(100.0));
+    return _IQ15mpy(getNextPoint(signalProperties.getCurrentPhase()), outputAmplitudePercentage) + amplitudeOffset;
+  }
+
+  /**
+   * @brief write the next data points of the active signal into a buffer
+   * This lets the samples be generated in the main loop, so an interruption only has to copy them to the output.
+   * @param[out] buffer Buffer where the data points are written
+   * @param[in] numberOfSamples Number of data points to be written
+   */
+  void fill(_iq15* buffer, const uint16_t numberOfSamples) noexcept {
+    for (uint16_t i = 0; i < numberOfSamples; i++) {
+      buffer[i] = getNextDatapoint();
+    }
+  }
+
+  /**
+   * @brief write the next data points of the active signal into a ring buffer
+   * @param[out] ringBuffer Ring buffer where the data points are written
+   * @param[in] ringBufferSize Number of entries of the ring buffer
+   * @param[in] writeIndex Index of the ring buffer where the first data point is written
+   * @param[in] numberOfSamples Number of data points to be written
+   * @return Index of the ring buffer after the last written data point
+   */
+  uint16_t fill(_iq15* ringBuffer, const uint16_t ringBufferSize, uint16_t writeIndex,
+                const uint16_t numberOfSamples) noexcept {
+    for (uint16_t i = 0; i < numberOfSamples; i++) {
+      ringBuffer[writeIndex] = getNextDatapoint();
+      if (++writeIndex >= ringBufferSize) {
+        writeIndex = 0;
+      }
+    }
+    return writeIndex;
   }
 
   /**
@@ -292,15 +440,31 @@ public:
    * @param[in] newShape new shape of the signal
    */
   void setActiveSignalShape(const Shape newShape) noexcept {
-    switch (newShape) {
-      case Shape::SINUSOIDAL: activeSignal = &sinusoidal; break;
-      case Shape::TRAPEZOIDAL: activeSignal = &trapezoidal; break;
-      case Shape::RECTANGULAR: activeSignal = &rectangular; break;
-    }
+    activeShape = newShape;
+    // Keeps the next and previous shapes relative to the new one
+    shapeIndex = static_cast<uint8_t>(newShape);
   }
 
   /**
-   * @brief This function changes the active signal shape to the next shape in the list of available shapes
+   * @brief set if the Shape::SINUSOIDAL is linearly interpolated between the entries of the sine table
+   * The interpolation removes the steps of the 256 entries at high frequencies, at the cost of a multiplication.
+   * @param[in] interpolated If the sine is interpolated. It is not by default.
+   */
+  void setSineInterpolation(const bool interpolated) noexcept {
+    interpolatedSine = interpolated;
+  }
+
+  /**
+   * @brief set the table played by the Shape::ARBITRARY
+   * @param[in] table new waveform table
+   */
+  void setArbitraryWaveform(const WaveformTable& table) noexcept {
+    arbitraryWaveform = table;
+  }
+
+  /**
+   * @brief This function changes the active signal shape to the next shape in the list of available shapes.
+   * The arbitrary waveform is not in the list, so it is only chosen by setActiveSignalShape.
    */
   void nextSignalShape() {
     if (shapeIndex < 2) {
@@ -346,6 +510,7 @@ public:
   void increaseAmplitude() {
     if (outputAmplitudePercentage < _IQ15(1.0)) {
       outputAmplitudePercentage += AMPLITUDE_STEP;
+      updateAmplitudeOffset();
     }
   }
 
@@ -355,23 +520,64 @@ public:
   void decreaseAmplitude() {
     if (outputAmplitudePercentage > _IQ15(0.0)) {
       outputAmplitudePercentage -= AMPLITUDE_STEP;
+      updateAmplitudeOffset();
     }
   }
 
+  /**
+   * @brief set the amplitude of the active signal
+   * @param[in] percentage new amplitude, from 0 to 100. Values outside of the range are limited to it.
+   */
+  void setAmplitude(const _iq15 percentage) noexcept {
+    if (percentage <= _IQ15(0.0)) {
+      outputAmplitudePercentage = _IQ15(0.0);
+    } else if (percentage >= _IQ15(100.0)) {
+      outputAmplitudePercentage = _IQ15(1.0);
+    } else {
+      outputAmplitudePercentage = _IQ15div(percentage, _IQ15(100.0));
+    }
+    updateAmplitudeOffset();
+  }
+
+  static constexpr _iq15 MAXIMUM_FREQUENCY =
+    _IQ15(5.0);  ///< Represents the maximum frequency that the signal generator can output. It is initialized to 5 Hz.
+  static constexpr _iq15 MINIMUM_FREQUENCY = _IQ15(
+    0.5);  ///< Represents the minimum frequency that the signal generator can output. It is initialized to 0.5 Hz.
+
 private:
-  Sinusoidal sinusoidal;              ///< Sinusoidal signal object
-  Trapezoidal trapezoidal;            ///< Trapezoidal signal object
-  Rectangular rectangular;            ///< Rectangular signal object
-  iSignalType* activeSignal;          ///< pointer to the active signal
+  /**
+   * @brief get the point of the active signal shape at the phase
+   * @param[in] phase Current phase of the signal
+   * @return point of the active signal
+   */
+  _iq15 getNextPoint(const SignalProperties::PhaseType phase) const noexcept {
+    switch (activeShape) {
+      case Shape::TRAPEZOIDAL: return Trapezoidal::getNextPoint(phase);
+      case Shape::RECTANGULAR: return Rectangular::getNextPoint(phase);
+      case Shape::ARBITRARY: return arbitraryWaveform.getValue(phase);
+      case Shape::SINUSOIDAL:
+      default:
+        return interpolatedSine ? Sinusoidal::getNextInterpolatedPoint(phase) : Sinusoidal::getNextPoint(phase);
+    }
+  }
+
+  /**
+   * @brief recalculate the offset of the output, so it is only calculated when the amplitude changes.
+   * The offset keeps the signal at the top of the output range when the amplitude is reduced.
+   */
+  void updateAmplitudeOffset() noexcept {
+    amplitudeOffset = _IQ15mpy(_IQ15(1.0) - outputAmplitudePercentage, _IQ15(100.0));
+  }
+
+  Shape activeShape = Shape::SINUSOIDAL;  ///< Active signal shape
+  bool interpolatedSine = false;          ///< If the sine is interpolated between the entries of its table
   SignalProperties signalProperties;  ///< Signal Properties object
+  WaveformTable arbitraryWaveform;    ///< Table played by Shape::ARBITRARY
   _iq15 outputAmplitudePercentage =
     _IQ15(1.0);  ///< Represents the amplitude of the output signal as a percentage. It is initialized to 100%.
+  _iq15 amplitudeOffset = _IQ15(0.0);  ///< Offset added to the scaled signal. It is 0 for 100% of amplitude.
   uint8_t shapeIndex = 0;  ///< Represents the current shape of the active signal. It is initialized to 0 = SINUSOIDAL.
 
-  static constexpr _iq15 MAXIMUM_FREQUENCY =
-    _IQ15(5.0);  ///< Represents the maximum frequency that the signal generator can output. It is initialized to 5 Hz.
-  static constexpr _iq15 MINIMUM_FREQUENCY = _IQ15(
-    0.5);  ///< Represents the minimum frequency that the signal generator can output. It is initialized to 0.5 Hz.
   static constexpr _iq15 FREQUENCY_STEP =
     _IQ15(0.5);  ///< Represents the step size for frequency changes. It is initialized to 0.5 Hz.
 
@@ -0,0 +1,169 @@
+/******************************************************************************
+ * @file                    Spi.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains a SPI master using the USCI_B0
+ *
+ * Description: The USCI_B0 shifts a whole byte out and in by hardware, while
+ *              bit-banging the same byte with the GPIOs takes dozens of
+ *              instructions per bit.
+ *
+ *              The SPI is configured as 3-pin master with the fixed pins of the
+ *              USCI_B0:
+ *                P1.5 = UCB0CLK
+ *                P1.6 = UCB0SOMI (on the LaunchPad, the jumper of LED2 has to be removed)
+ *                P1.7 = UCB0SIMO
+ *
+ *              A transfer can either wait until the byte was shifted, or return right
+ *              away and call a callback from the USCI_B0 receive interruption when
+ *              the byte was shifted.
+ ******************************************************************************/
+#ifndef MICROTECH_SPI_HPP
+#define MICROTECH_SPI_HPP
+
+#include "LowPower.hpp"
+#include "helpers.hpp"
+#include <msp430g2553.h>
+#include <cstdint>
+
+namespace Microtech {
+
+class Spi {
+  friend struct SingletonInstance<Spi>;
+  constexpr Spi() = default;
+
+public:
+  // Deleted copy and move constructors
+  Spi(Spi&) = delete;
+  Spi(Spi&&) = delete;
+  ~Spi() = default;
+
+  /**
+   * Type definition of the callback of a transfer that was started without waiting
+   * @param context Pointer given when the transfer was started
+   * @param received Byte received during the transfer
+   */
+  typedef void (*TransferCallback)(void* context, uint8_t received);
+
+  /**
+   * Method that guarantees that there is only one instance of the Spi class in the software
+   * @return A reference to the instance
+   */
+  static Spi& getInstance() noexcept {
+    return SingletonInstance<Spi>::instance;
+  }
+
+  /**
+   * Method that initializes the USCI_B0 as SPI master, MSB first, with the clock LOW while idle.
+   * The data is changed on the falling edge and captured on the rising edge of the clock.
+   * @param clockDivider Divider of SMCLK that generates the SPI clock
+   */
+  void init(const uint16_t clockDivider = 1) noexcept {
+    setRegisterBits(UCB0CTL1, static_cast<uint8_t>(UCSWRST));  // Holds the USCI in reset while configuring it
+    UCB0CTL0 = UCCKPH | UCMSB | UCMST | UCMODE_0 | UCSYNC;
+    setRegisterBits(UCB0CTL1, static_cast<uint8_t>(UCSSEL_2));  // Clock source = SMCLK
+    UCB0BR0 = static_cast<uint8_t>(clockDivider);
+    UCB0BR1 = static_cast<uint8_t>(clockDivider >> 8);
+    // P1.5 = UCB0CLK, P1.6 = UCB0SOMI, P1.7 = UCB0SIMO
+    setRegisterBits(P1SEL, static_cast<uint8_t>(BIT5 + BIT6 + BIT7));
+    setRegisterBits(P1SEL2, static_cast<uint8_t>(BIT5 + BIT6 + BIT7));
+    resetRegisterBits(UCB0CTL1, static_cast<uint8_t>(UCSWRST));
+  }
+
+  /**
+   * Method that sends a byte and waits until it was shifted.
+   * If a transfer without waiting is still running, it waits for it first.
+   * @param data Byte to be sent
+   * @return Byte received during the transfer
+   */
+  uint8_t transfer(const uint8_t data) noexcept {
+    while (pendingCallback != nullptr) {
+    }
+    UCB0TXBUF = data;
+    while (!(IFG2 & UCB0RXIFG)) {
+    }
+    return UCB0RXBUF;  // Reading the receive buffer clears the flag
+  }
+
+  /**
+   * Method that sends a byte without waiting. The callback is called from the interruption
+   * when the byte was shifted, so it can already start the next transfer.
+   * @param data Byte to be sent
+   * @param callback Function called when the transfer is complete
+   * @param context Pointer passed to the callback
+   * @return true if the transfer was started, false if another transfer is still running
+   */
+  bool startTransfer(const uint8_t data, const TransferCallback callback, void* const context) noexcept {
+    if (isBusy()) {
+      return false;
+    }
+    pendingContext = context;
+    pendingCallback = callback;
+    UCB0TXBUF = data;
+    setRegisterBits(IE2, static_cast<uint8_t>(UCB0RXIE));
+    return true;
+  }
+
+  /**
+   * Method to know if a transfer is running
+   * @return true if a byte is being shifted
+   */
+  bool isBusy() const noexcept {
+    return (pendingCallback != nullptr) || (UCB0STAT & UCBUSY);
+  }
+
+  /**
+   * Method to get which clock has to keep running while the CPU is sleeping.
+   * The USCI runs with SMCLK, so it has to keep running until the transfer is complete.
+   * @return The clock requirement of the SPI
+   */
+  ClockRequirement getClockRequirement() const noexcept {
+    return isBusy() ? ClockRequirement::SMCLK : ClockRequirement::NONE;
+  }
+
+  /**
+   * Method called by the USCI_B0 receive interruption. It completes the transfer started without waiting.
+   */
+  void interruptionHappened() noexcept {
+    const uint8_t received = UCB0RXBUF;
+    resetRegisterBits(IE2, static_cast<uint8_t>(UCB0RXIE));
+    // The transfer is marked as complete before calling the callback, so the callback can start a new one.
+    const TransferCallback callback = pendingCallback;
+    pendingCallback = nullptr;
+    if (callback != nullptr) {
+      callback(pendingContext, received);
+    }
+  }
+
+private:
+  volatile TransferCallback pendingCallback = nullptr;  ///< Callback of the running transfer, nullptr if none
+  void* pendingContext = nullptr;                       ///< Pointer passed to the callback of the running transfer
+};
+}  // namespace Microtech
+
+#ifdef MICROTECH_SERIAL_RX
+// The USCI_A0 receives in the same interruption, so both classes have to be defined before it.
+#include "SerialReceiver.hpp"
+#endif
+
+// USCI_A0 and USCI_B0 receive interruption. In SPI mode, the receive flag of the USCI_B0 means that the byte was
+// shifted.
+#pragma vector = USCIAB0RX_VECTOR
+__interrupt void USCIAB0RX_ISR(void) {
+  if ((IFG2 & UCB0RXIFG) && (IE2 & UCB0RXIE)) {
+    Microtech::Spi::getInstance().interruptionHappened();
+  }
+#ifdef MICROTECH_SERIAL_RX
+  if ((IFG2 & UCA0RXIFG) && (IE2 & UCA0RXIE)) {
+    Microtech::SerialReceiver::getInstance().interruptionHappened();
+  }
+#endif
+  if (Microtech::LowPower::isWakeUpRequested()) {
+    __bic_SR_register_on_exit(LPM4_bits);
+  }
+}
+
+#endif  // MICROTECH_SPI_HPP
@@ -0,0 +1,175 @@
+/******************************************************************************
+ * @file                    TaskProfiler.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains the report of the execution times of the tasks
+ *
+ * Description: When MICROTECH_TASK_PROFILING is defined for the whole
+ *              application, the timer reads its counter before and after the
+ *              callback of every task. Each task then keeps its number of calls,
+ *              the shortest, longest and mean execution time, the worst latency
+ *              from being due until its callback starts and how many times the
+ *              next tick happened before it returned (overrun).
+ *
+ *              The G2553 has no third timer to be used as a free running
+ *              reference, so the counter of the timer of the task is used. In up
+ *              mode, it restarts at every tick, so an execution is only measured
+ *              correctly if it is shorter than a tick. Longer ones are counted
+ *              as overrun. Timers sourced by ACLK are asynchronous to the CPU, so
+ *              a read of the counter can be off by one count.
+ *
+ *              The TaskProfiler sends the report over the serial link on request,
+ *              one line at a time from the main loop, so the buffer of the Serial
+ *              never overflows:
+ *                TaskProfiler<1> taskProfiler(TIMER_CONFIG);
+ *                ...
+ *                taskProfiler.requestReport();
+ *                ...
+ *                while (true) {
+ *                  taskProfiler.process();
+ *                  idle(ClockRequirement::SMCLK);
+ *                }
+ *
+ *              Without MICROTECH_TASK_PROFILING, the methods are empty and
+ *              neither the timer nor the tasks measure anything.
+ ******************************************************************************/
+#ifndef MICROTECH_TASKPROFILER_HPP
+#define MICROTECH_TASKPROFILER_HPP
+
+#include "Serial.hpp"
+#include "Timer.hpp"
+#include <msp430g2553.h>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Class that reports the execution times of the tasks of a timer.
+ * Each task takes two lines:
+ *   T1.0 calls=50 overruns=0 latency=16us
+ *     min=312us max=336us mean=320us
+ * @tparam TIMER_NUMBER The number of the timer
+ */
+template<uint8_t TIMER_NUMBER>
+class TaskProfiler {
+public:
+  /**
+   * Constructor
+   * @param config Configuration of the timer, used to convert the counts to microseconds. The input divider is
+   *               read from the timer, since it may have been chosen automatically.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ>
+  constexpr explicit TaskProfiler(const TimerConfigBase<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ>& /*config*/)
+    : sourceClockFrequencyHz(static_cast<uint32_t>(SOURCE_CLK_FREQUENCY_HZ)) {}
+
+  /**
+   * Method to start sending the report. It is sent by process.
+   */
+  void requestReport() noexcept {
+    nextLine = 0;
+    reporting = true;
+  }
+
+  /**
+   * Method to restart the measurement of every task of the timer
+   */
+  void resetProfiles() noexcept {
+#ifdef MICROTECH_TASK_PROFILING
+    const Timer<TIMER_NUMBER>& timer = Timer<TIMER_NUMBER>::getTimer();
+    for (uint8_t taskIndex = 0; taskIndex < timer.getNumberOfTasks(); taskIndex++) {
+      TaskHandlerBase* const task = timer.getTask(taskIndex);
+      if (task != nullptr) {
+        // The interrupt state is restored afterwards, so it can also be called with the interruptions disabled.
+        const unsigned short interruptState = __get_interrupt_state();
+        __disable_interrupt();
+        task->resetProfile();
+        __set_interrupt_state(interruptState);
+      }
+    }
+#endif
+  }
+
+  /**
+   * Method to be called by the main loop. If a report was requested and the Serial sent everything, the next
+   * line of the report is sent.
+   * @return true if the report is still being sent
+   */
+  bool process() noexcept {
+#ifdef MICROTECH_TASK_PROFILING
+    if (!reporting || !Serial::getInstance().isIdle()) {
+      return reporting;
+    }
+    const Timer<TIMER_NUMBER>& timer = Timer<TIMER_NUMBER>::getTimer();
+    const uint8_t taskIndex = nextLine >> 1;
+    if (taskIndex >= timer.getNumberOfTasks()) {
+      reporting = false;
+      return false;
+    }
+    const TaskHandlerBase* const task = timer.getTask(taskIndex);
+    if (task != nullptr) {
+      // The profile is updated by the interruption, so it is copied at once. The interrupt state is restored
+      // afterwards.
+      const unsigned short interruptState = __get_interrupt_state();
+      __disable_interrupt();
+      const TaskProfile profile = task->getProfile();
+      __set_interrupt_state(interruptState);
+      if ((nextLine & 0x01) == 0) {
+        printCalls(taskIndex, profile);
+      } else {
+        printExecutionTimes(profile);
+      }
+    }
+    nextLine++;
+    return true;
+#else
+    reporting = false;
+    return false;
+#endif
+  }
+
+private:
+#ifdef MICROTECH_TASK_PROFILING
+  void printCalls(const uint8_t taskIndex, const TaskProfile& profile) const noexcept {
+    Serial& serial = Serial::getInstance();
+    serial.print("T");
+    serial.printInt(TIMER_NUMBER);
+    serial.print(".");
+    serial.printInt(taskIndex);
+    serial.print(" calls=");
+    serial.printInt(profile.calls);
+    serial.print(" overruns=");
+    serial.printInt(profile.overruns);
+    serial.print(" latency=");
+    printMicroseconds(profile.worstLatencyCounts);
+    serial.println();
+  }
+
+  void printExecutionTimes(const TaskProfile& profile) const noexcept {
+    Serial& serial = Serial::getInstance();
+    serial.print("  min=");
+    printMicroseconds((profile.calls == 0) ? 0 : profile.minCounts);
+    serial.print(" max=");
+    printMicroseconds(profile.maxCounts);
+    serial.print(" mean=");
+    printMicroseconds(profile.getMeanCounts());
+    serial.println();
+  }
+
+  void printMicroseconds(const uint16_t counts) const noexcept {
+    // Only used by the report, so the 64 bit division doesn't cost any task time.
+    const uint64_t timerCounts = static_cast<uint64_t>(counts) * Timer<TIMER_NUMBER>::getTimer().getInputDivider();
+    Serial::getInstance().printInt(static_cast<int32_t>(timerCounts * 1000000UL / sourceClockFrequencyHz));
+    Serial::getInstance().print("us");
+  }
+#endif
+
+  const uint32_t sourceClockFrequencyHz;  ///< Frequency of the source clock of the timer
+  uint8_t nextLine = 0;                   ///< Next line of the report to be sent
+  bool reporting = false;                 ///< If the report is being sent
+};
+}  // namespace Microtech
+
+#endif  // MICROTECH_TASKPROFILER_HPP
@@ -21,15 +21,73 @@
 #ifndef COMMON_TIMER_HPP_
 #define COMMON_TIMER_HPP_
 
+#include "ClockSystem.hpp"
 #include "helpers.hpp"
+#include "LowPower.hpp"
 
+#include "IQmathLib.h"
 #include <msp430g2553.h>
 #include <array>
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <utility>
 
 namespace Microtech {
+/**
+ * Counts of a timer from one value of the counter to a later one.
+ * @param wrapCounts Counts of a period of the counter in up mode, or 0 if it is free running, since the
+ * differences of 16 bits already wrap around.
+ */
+constexpr uint16_t countsBetween(const uint16_t from, const uint16_t to, const uint16_t wrapCounts) noexcept {
+  return static_cast<uint16_t>((to >= from) ? to - from : to - from + wrapCounts);
+}
+
+#ifdef MICROTECH_TASK_PROFILING
+/**
+ * Execution times of a task, in counts of the timer that calls it. They are measured with the counter of
+ * the timer around the callback, so they are only updated when MICROTECH_TASK_PROFILING is defined.
+ */
+struct TaskProfile {
+  uint16_t calls = 0;               ///< Number of measured calls
+  uint16_t minCounts = 0xFFFF;      ///< Shortest execution time
+  uint16_t maxCounts = 0;           ///< Longest execution time
+  uint32_t totalCounts = 0;         ///< Sum of the execution times of the calls, for the mean
+  uint16_t worstLatencyCounts = 0;  ///< Longest time between the task being due and its callback starting
+  uint16_t overruns = 0;            ///< Calls that returned after the next tick of the timer already happened
+
+  /**
+   * Method called by the timer after each call of the task
+   * @param latencyCounts Counts between the task being due and its callback starting
+   * @param executionCounts Counts that the callback took
+   * @param overrun If the next tick of the timer happened before the callback returned
+   */
+  void addCall(const uint16_t latencyCounts, const uint16_t executionCounts, const bool overrun) noexcept {
+    if (calls == 0xFFFF) {
+      // Halving both keeps the mean and the sum can never overflow.
+      calls >>= 1;
+      totalCounts >>= 1;
+    }
+    calls++;
+    totalCounts += executionCounts;
+    minCounts = (executionCounts < minCounts) ? executionCounts : minCounts;
+    maxCounts = (executionCounts > maxCounts) ? executionCounts : maxCounts;
+    worstLatencyCounts = (latencyCounts > worstLatencyCounts) ? latencyCounts : worstLatencyCounts;
+    if (overrun && overruns != 0xFFFF) {
+      overruns++;
+    }
+  }
+
+  /**
+   * Method to get the mean execution time. It uses a software division, so it should not be called from
+   * an interruption.
+   */
+  uint16_t getMeanCounts() const noexcept {
+    return (calls == 0) ? 0 : static_cast<uint16_t>(totalCounts / calls);
+  }
+};
+#endif
+
 /**
  * Class that serves as a base for a TaskHanlder. The intention of it
  * is since a timer would store different task handlers, it cannot be tamplated
@@ -41,6 +99,10 @@ namespace Microtech {
  *
  */
 class TaskHandlerBase {
+  template<uint8_t TIMER_NUMBER>
+  friend class Timer;
+  friend class Watchdog;
+
 public:
   // using CallbackFunction = std::function<void()>;
   typedef void (*CallbackFunction)();  ///< Type definition of callback
@@ -49,8 +111,11 @@ public:
    * Class constructor.
    * @param callback function pointer to task callback
    * @param isPeriodic To inform weather this is a one-time callback (non periodic) or it is periodic.
+   * @param requiredClock Clock the task needs running while the CPU sleeps (e.g. SMCLK for the serial).
    */
-  TaskHandlerBase(CallbackFunction callback, bool isPeriodic) : taskCallback(callback), isPeriodic(isPeriodic) {}
+  TaskHandlerBase(CallbackFunction callback, bool isPeriodic,
+                  ClockRequirement requiredClock = ClockRequirement::NONE)
+    : taskCallback(callback), isPeriodic(isPeriodic), requiredClock(requiredClock) {}
 
   /**
    * Function intended to be called by the timer interrupt and it basically calls the callback.
@@ -63,20 +128,51 @@ public:
     }
   }
 
+  /**
+   * Method to know if the task is called periodically or only once.
+   * @return true if periodic
+   */
+  bool getIsPeriodic() const noexcept {
+    return isPeriodic;
+  }
+
+#ifdef MICROTECH_TASK_PROFILING
+  /**
+   * Method to get the execution times of the task. They are updated by the timer interruption, so they
+   * should be copied with the interruptions disabled.
+   */
+  const TaskProfile& getProfile() const noexcept {
+    return profile;
+  }
+
+  /**
+   * Method to restart the measurement of the execution times.
+   */
+  void resetProfile() noexcept {
+    profile = TaskProfile();
+  }
+#endif
+
 private:
   const CallbackFunction taskCallback = nullptr;  ///< Callback pointer. Initially null, but can be set on constructor
   const bool isPeriodic;                          ///< Stores if the task is periodic or not
+  const ClockRequirement requiredClock;           ///< Clock that has to keep running while the CPU sleeps
+  uint16_t tickDivisor = 1;    ///< Number of timer ticks between two calls. Set by the timer when registering the task
+  uint16_t ticksUntilDue = 1;  ///< Number of timer ticks left until the task is called again
+#ifdef MICROTECH_TASK_PROFILING
+  TaskProfile profile;  ///< Execution times of the task. Updated by the timer after every call
+#endif
 };
 
 /**
  * TaskHandler is intended for the user to be able to handle different tasks.
- * At the moment the software supports only one task in the timer, but the advantage
- * of having such class is that later when this is expanded to allow multiple tasks
- * there is no change on the task concept. For example, in continuous mode the MSP supports
- * up to three timer comparators, so one could say that there are three tasks.
+ * The period of the task is a template parameter, so when a group of tasks is registered
+ * to a timer, the timer tick and how many ticks each task has to wait are calculated in compile time.
+ * For example, tasks of 20ms and 50ms result in a timer tick of 10ms, where the first task is
+ * called every 2 ticks and the second every 5 ticks.
  *
- * Software-wise one can eve multiplex the timer and make multiple tasks with one timer
- * interrupt. Like a scheduler.
+ * In continuous mode the MSP also supports up to three timer comparators, so each of them
+ * can also hold one task with its own period (see Timer::registerCompareTasks).
  *
  * @tparam periodValue Period of the task
  * @tparam Duration Time scale of the period (milliseconds, microseconds...)
@@ -89,8 +185,13 @@ public:
    *
    * @param callback function pointer to task callback
    * @param isPeriodic To inform weather this is a one-time callback (non periodic) or it is periodic.
+   * @param requiredClock Clock the task needs running while the CPU sleeps.
    */
-  TaskHandler(CallbackFunction callback, bool isPeriodic) : TaskHandlerBase(callback, isPeriodic) {}
+  TaskHandler(CallbackFunction callback, bool isPeriodic, ClockRequirement requiredClock = ClockRequirement::NONE)
+    : TaskHandlerBase(callback, isPeriodic, requiredClock) {}
+
+  /// Period of the task converted to microseconds. Evaluated in compile time.
+  static constexpr uint64_t PERIOD_IN_US = std::chrono::microseconds(Duration(periodValue)).count();
 };
 
 class TimerClockSource {
@@ -111,9 +212,33 @@ public:
         }
       return TASSEL_2;  // It will actually never get here. But it is needed due to the compiler warning
     }
+
+    /**
+     * Returns which internal clock has to keep running while sleeping so the timer keeps counting.
+     * TACLK and INCLK are external, so they don't need any internal clock.
+     */
+    static constexpr ClockRequirement getClockRequirement(const Option option) noexcept {
+      switch (option) {
+        case Option::ACLK: return ClockRequirement::ACLK;
+        case Option::SMCLK: return ClockRequirement::SMCLK;
+        case Option::TACLK:
+        case Option::INCLK: return ClockRequirement::NONE;
+      }
+      return ClockRequirement::SMCLK;  // It will actually never get here. But it is needed due to the compiler warning
+    }
 };
 
-template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US>
+/**
+ * CLK_DIV of a TimerConfigBase that lets the timer choose its input divider in compile time, see Timer::registerTasks.
+ */
+static constexpr int64_t AUTOMATIC_CLK_DIV = 0;
+
+/**
+ * Configuration of the clock of a timer.
+ * @tparam CLK_DIV Input divider of the timer (1, 2, 4 or 8), or AUTOMATIC_CLK_DIV
+ * @tparam SOURCE_CLK_FREQUENCY_HZ Frequency of the source clock in Hz
+ */
+template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ>
 class TimerConfigBase {
   template<uint8_t TIMER_NUMBER>
   friend class Timer;
@@ -123,6 +248,220 @@ public:
 protected:
   const TimerClockSource::Option clkSource;
 };
+
+/**
+ * Configuration of a timer sourced by SMCLK, with the frequency of the SystemClock.
+ */
+template<int64_t CLK_DIV = AUTOMATIC_CLK_DIV>
+class SmclkTimerConfig : public TimerConfigBase<CLK_DIV, SystemClock::SMCLK_FREQUENCY_HZ> {
+public:
+  constexpr SmclkTimerConfig()
+    : TimerConfigBase<CLK_DIV, SystemClock::SMCLK_FREQUENCY_HZ>(TimerClockSource::Option::SMCLK) {}
+};
+
+/**
+ * Configuration of a timer sourced by ACLK, with the frequency of the SystemClock.
+ */
+template<int64_t CLK_DIV = AUTOMATIC_CLK_DIV>
+class AclkTimerConfig : public TimerConfigBase<CLK_DIV, SystemClock::ACLK_FREQUENCY_HZ> {
+public:
+  constexpr AclkTimerConfig()
+    : TimerConfigBase<CLK_DIV, SystemClock::ACLK_FREQUENCY_HZ>(TimerClockSource::Option::ACLK) {}
+};
+/**
+ * Edges of the input that are captured
+ */
+enum class CaptureEdge : uint16_t {
+  RISING = CM_1,   ///< The period is measured from rising edge to rising edge
+  FALLING = CM_2,  ///< The period is measured from falling edge to falling edge
+  BOTH = CM_3,     ///< Both edges, so the duty cycle can also be measured
+};
+
+/**
+ * Input of the comparator that is captured. The pins of each input are in the datasheet, e.g. for Timer1
+ * CCI1A is P2.1, CCI1B is P2.2, CCI2A is P2.4 and CCI2B is P2.5.
+ */
+enum class CaptureInput : uint16_t {
+  CCI_A = CCIS_0,  ///< CCIxA pin
+  CCI_B = CCIS_1,  ///< CCIxB pin
+  GND = CCIS_2,    ///< Ground, so a capture can be triggered by software toggling to VCC
+  VCC = CCIS_3,    ///< VCC
+};
+
+/**
+ * Timestamps of the edges captured by a comparator of a timer, with the measurements derived from them.
+ *
+ * The interruption only copies the captured counter to a small ring, so the CPU cost per edge is a few
+ * cycles and the resolution is one count of the timer. The measurements are calculated in the main loop from the
+ * differences of the timestamps in the ring, so they are the mean of the last captured periods.
+ *
+ * The period of the input must be shorter than the period of the counter: 0x10000 counts in continuous mode,
+ * or CCR0 + 1 in up mode. Longer periods fold back.
+ */
+class CaptureChannel {
+  template<uint8_t TIMER_NUMBER>
+  friend class Timer;
+
+public:
+  static constexpr uint8_t BUFFER_SIZE = 8;  ///< Number of timestamps kept. It has to be a power of two.
+
+  /**
+   * Method to get the mean period of the input over the captured edges
+   * @return Period in counts of the timer, or 0 if not enough edges were captured
+   */
+  uint16_t getPeriodCounts() const noexcept {
+    const Measurement measurement = measure();
+    return (measurement.periods == 0) ? 0 : static_cast<uint16_t>(measurement.periodCounts / measurement.periods);
+  }
+
+  /**
+   * Method to get the mean time the input was high. It needs CaptureEdge::BOTH.
+   * @return High time in counts of the timer, or 0 if not enough edges were captured
+   */
+  uint16_t getHighCounts() const noexcept {
+    const Measurement measurement = measure();
+    return (measurement.highs == 0) ? 0 : static_cast<uint16_t>(measurement.highCounts / measurement.highs);
+  }
+
+  /**
+   * Method to get the frequency of the input
+   * @return Frequency in Hz, or 0 if not enough edges were captured
+   */
+  uint32_t getFrequencyHz() const noexcept {
+    const Measurement measurement = measure();
+    if (measurement.periodCounts == 0) {
+      return 0;
+    }
+    // Rounded, since the division truncates.
+    return (countFrequencyHz * measurement.periods + measurement.periodCounts / 2) / measurement.periodCounts;
+  }
+
+  /**
+   * Method to get the duty cycle of the input. It needs CaptureEdge::BOTH.
+   * @return Duty cycle between 0 and 100, like the one of the Pwm, or 0 if not enough edges were captured
+   */
+  _iq15 getDutyCycle() const noexcept {
+    const Measurement measurement = measure();
+    if ((measurement.highs == 0) || (measurement.periodCounts == 0)) {
+      return 0;
+    }
+    const uint16_t high = static_cast<uint16_t>(measurement.highCounts / measurement.highs);
+    const uint16_t period = static_cast<uint16_t>(measurement.periodCounts / measurement.periods);
+    return _IQ15mpy(_IQ15div(_IQ15(static_cast<int32_t>(high)), _IQ15(static_cast<int32_t>(period))), _IQ15(100));
+  }
+
+  /**
+   * Method to get how many edges were captured before the interruption read the previous one.
+   * The measurements around them are wrong, so they should be cleared.
+   */
+  uint16_t getOverflows() const noexcept {
+    return overflows;
+  }
+
+  /**
+   * Method to discard the captured edges, e.g. when the input changed.
+   * The interruptions are disabled meanwhile and their state is restored afterwards, so it can also be called by them.
+   */
+  void clear() noexcept {
+    const unsigned short interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    numberOfCaptures = 0;
+    overflows = 0;
+    __set_interrupt_state(interruptState);
+  }
+
+private:
+  /**
+   * Sums of the differences of the timestamps in the ring
+   */
+  struct Measurement {
+    uint32_t periodCounts = 0;  ///< Sum of the whole periods
+    uint32_t highCounts = 0;    ///< Sum of the high times
+    uint8_t periods = 0;        ///< Number of whole periods in the sum
+    uint8_t highs = 0;          ///< Number of high times in the sum
+  };
+
+  /**
+   * Method called by the timer when the capture starts
+   */
+  void start(const CaptureEdge captureEdge, const uint16_t counterWrapCounts, const uint32_t frequencyHz) noexcept {
+    edge = captureEdge;
+    wrapCounts = counterWrapCounts;
+    countFrequencyHz = frequencyHz;
+    head = 0;
+    numberOfCaptures = 0;
+    levels = 0;
+    overflows = 0;
+  }
+
+  /**
+   * Method called by the interruption of the capture
+   * @param timestamp Captured value of the counter
+   * @param high If the input is high after the edge, so it was a rising edge
+   */
+  void addCapture(const uint16_t timestamp, const bool high) noexcept {
+    const uint8_t bit = static_cast<uint8_t>(1U << head);
+    timestamps[head] = timestamp;
+    levels = high ? static_cast<uint8_t>(levels | bit) : static_cast<uint8_t>(levels & ~bit);
+    head = (head + 1) & BUFFER_MASK;
+    if (numberOfCaptures < BUFFER_SIZE) {
+      numberOfCaptures++;
+    }
+  }
+
+  Measurement measure() const noexcept {
+    // The ring is updated by the interruption, so it is copied at once. The interrupt state is restored afterwards.
+    const unsigned short interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    const uint8_t captures = numberOfCaptures;
+    const uint8_t newest = head;
+    const uint8_t capturedLevels = levels;
+    std::array<uint16_t, BUFFER_SIZE> copy = timestamps;
+    __set_interrupt_state(interruptState);
+
+    Measurement measurement;
+    if (captures < 2) {
+      return measurement;
+    }
+    uint8_t differences = captures - 1;
+    // With both edges, a period is two differences, so the oldest one is skipped if there is an odd number.
+    if ((edge == CaptureEdge::BOTH) && ((differences & 0x01) != 0)) {
+      differences--;
+    }
+    uint8_t index = (newest - differences - 1) & BUFFER_MASK;
+    for (uint8_t difference = 0; difference < differences; difference++) {
+      const uint8_t next = (index + 1) & BUFFER_MASK;
+      const uint16_t counts = countsBetween(copy[index], copy[next], wrapCounts);
+      measurement.periodCounts += counts;
+      if ((capturedLevels & (1U << index)) != 0) {
+        measurement.highCounts += counts;
+        measurement.highs++;
+      }
+      index = next;
+    }
+    measurement.periods = (edge == CaptureEdge::BOTH) ? differences / 2 : differences;
+    if (edge != CaptureEdge::BOTH) {
+      // With a single edge the level after it says nothing about the high time.
+      measurement.highCounts = 0;
+      measurement.highs = 0;
+    }
+    return measurement;
+  }
+
+  static constexpr uint8_t BUFFER_MASK = BUFFER_SIZE - 1;
+  static_assert((BUFFER_SIZE & BUFFER_MASK) == 0, "The buffer size has to be a power of two");
+  static_assert(BUFFER_SIZE <= 8, "The levels of the edges are bits of a byte");
+
+  std::array<uint16_t, BUFFER_SIZE> timestamps{};  ///< Captured values of the counter
+  volatile uint8_t head = 0;                       ///< Index of the next capture
+  volatile uint8_t numberOfCaptures = 0;           ///< Valid timestamps in the ring
+  volatile uint8_t levels = 0;                     ///< One bit per timestamp, if the input was high after the edge
+  volatile uint16_t overflows = 0;                 ///< Edges lost because the previous one wasn't read yet
+  CaptureEdge edge = CaptureEdge::RISING;          ///< Edges that are captured
+  uint16_t wrapCounts = 0;                         ///< Counts of a period of the counter, 0 if free running
+  uint32_t countFrequencyHz = 0;                   ///< Frequency of the counts of the timer
+};
+
 /**
  * Timer class is responsible for managing the timer of MSP430.
  * @tparam TIMER_NUMBER The number of the timer.
@@ -130,19 +469,20 @@ protected:
 template<uint8_t TIMER_NUMBER>
 class Timer {
   friend class Pwm;
-  using RegisterRef = volatile uint16_t&;
+  using RegisterRef = volatile RegisterType<uint16_t>&;
 
 public:
-  Timer() : TAxCTL(getTAxCTL()), TAxCCR0(getTAxCCR0()), TAxCCTL0(getTAxCCTL0()) {}
+  typedef void (*PeriodCallback)(void* context);  ///< Type definition of the callback at the period boundary
+
+  constexpr Timer() = default;
   ~Timer() = default;
 
   /**
    * Method that guarantees that there is only one instance of the Timer<TIMER_NUM> class in the software
    * @return A reference to the instance
    */
-  static Timer<TIMER_NUMBER>& getTimer() {
-    static Timer<TIMER_NUMBER> timer;
-    return timer;
+  static Timer<TIMER_NUMBER>& getTimer() noexcept {
+    return SingletonInstance<Timer<TIMER_NUMBER>>::instance;
   }
   /**
    * Method to initialize the timer. The CLK_DIV is at the moment a template parameter
@@ -151,12 +491,14 @@ public:
    * the count type, which IS hard coded. It can also be an argument
    * in the near future.
    */
-  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US>
-  constexpr void init(TimerConfigBase<CLK_DIV, SOURCE_CLK_PERIOD_US> config) {
-    constexpr uint16_t TIMER_INPUT_DIVIDER = getTimerInputDivider<CLK_DIV>();
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ>
+  constexpr void init(TimerConfigBase<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ> config) {
+    // An automatic divider is only known when the period is set, so it starts with 1.
+    constexpr uint16_t TIMER_INPUT_DIVIDER = getTimerInputDivider<(CLK_DIV == AUTOMATIC_CLK_DIV) ? 1 : CLK_DIV>();
     // Choose SMCLK as clock source
     // Counting in Up Mode
-    TAxCTL = TimerClockSource::getTASSELValue(config.clkSource) + TIMER_INPUT_DIVIDER + MC_0;
+    getTAxCTL() = TimerClockSource::getTASSELValue(config.clkSource) + TIMER_INPUT_DIVIDER + MC_0;
+    sourceClockRequirement = TimerClockSource::getClockRequirement(config.clkSource);
   }
   /**
    * Method to register a task to the timer. It will enable the interrupt of timer 0,
@@ -170,14 +512,6 @@ public:
    *  // Sets periodic task that is called every 500ms
    *  TaskHandler<500, std::chrono::milliseconds> task1(&task1Callback, true);
    *  timer0.registerTask(task1);
-   *
-   *  // Sets periodic task that is called every 1s
-   *  TaskHandler<1, std::chrono::seconds> task2(&task2Callback, true);
-   *  timer0.registerTask(task2);
-   *
-   *  // Sets non-periodic task that is once 300us from now
-   *  TaskHandler<500, std::chrono::milliseconds> event1(&event1Callback, false);
-   *  timer0.registerTask(event1);
    * @endcode
    *
    * @tparam periodValue The period value in that specific magnitude.
@@ -186,56 +520,382 @@ public:
    * The whole logic ad calculation is done in compile time. The only thing that goes to the binary is the setting of
    * the registers.
    *
-   * At the moment it is only supported adding one periodic task and no non-periodic
+   * Registering a single task replaces every task previously registered in the timer. In order to have
+   * multiple tasks with different periods, use registerTasks.
    * Usually when calling the registerTask, the template parameters don't have to be completed,
    * since the compiler can deduce them from the TaskHandler type.
    */
-  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t periodValue, typename Duration = std::chrono::microseconds>
-  constexpr void registerTask(const TimerConfigBase<CLK_DIV, SOURCE_CLK_PERIOD_US>& /*config*/, TaskHandler<periodValue, Duration>& task) {
-    // Gets the timer0 compare value
-    constexpr uint16_t COMPARE_VALUE = calculateCompareValue<CLK_DIV, SOURCE_CLK_PERIOD_US, periodValue, Duration>();
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ, uint64_t periodValue,
+           typename Duration = std::chrono::microseconds>
+  constexpr void registerTask(const TimerConfigBase<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ>& config,
+                              TaskHandler<periodValue, Duration>& task) {
+    registerTasks(config, task);
+  }
+
+  /**
+   * Method to register a group of tasks with different periods to the timer. E.g.:
+   *
+   * @code
+   *  // Periodic task that is called every 20ms
+   *  TaskHandler<20, std::chrono::milliseconds> task1(&task1Callback, true);
+   *  // Periodic task that is called every 50ms
+   *  TaskHandler<50, std::chrono::milliseconds> task2(&task2Callback, true);
+   *  // Non-periodic task that is called once 300ms from now
+   *  TaskHandler<300, std::chrono::milliseconds> event1(&event1Callback, false);
+   *
+   *  Timer<1>::getTimer().registerTasks(TIMER_CONFIG, task1, task2, event1);
+   * @endcode
+   *
+   * The timer tick is the greatest common divisor of all the periods, in the example above 10ms,
+   * and each task gets a divisor of how many ticks it has to wait until being called (2, 5 and 30).
+   * Both are calculated in compile time, so the interruption only has to count down the ticks of
+   * each task and call the ones that are due. The non-periodic tasks are removed from the timer
+   * after being called.
+   *
+   * With AUTOMATIC_CLK_DIV, the input divider is the smallest one where the tick fits in the counter, which
+   * gives the best resolution. If the tick doesn't fit even with the largest divider, e.g. a single task of 5s,
+   * it is split by a software postscaler: the tick becomes 5s / 10 and the task waits 10 ticks. This only
+   * costs the few interruptions of the postscaler instead of a fast tick and a counter in the application.
+   *
+   * The tasks previously registered are replaced by the new ones.
+   *
+   * @tparam periodValues The period values of each task.
+   * @tparam Durations std::chrono duration types of each task.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ, uint64_t... periodValues, typename... Durations>
+  void registerTasks(const TimerConfigBase<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ>& /*config*/,
+                     TaskHandler<periodValues, Durations>&... tasks) {
+    static_assert(sizeof...(tasks) > 0, "At least one task must be registered");
+    static_assert(sizeof...(tasks) <= MAX_NUMBER_OF_TASKS, "Too many tasks registered to the timer");
 
-    // For now only one task. This is work in progress.
-    // Task is added to taskHandlers array
-    taskHandlers[0] = &task;
+    // Timer tick that fits all the task periods.
+    constexpr uint64_t TICK_PERIOD_US = greatestCommonDivisor(TaskHandler<periodValues, Durations>::PERIOD_IN_US...);
+    constexpr int64_t TIMER_CLK_DIV = selectClockDivider<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ, TICK_PERIOD_US>();
+    constexpr uint16_t POSTSCALER = calculatePostscaler<TIMER_CLK_DIV, SOURCE_CLK_FREQUENCY_HZ, TICK_PERIOD_US>();
+    constexpr uint16_t COMPARE_VALUE = calculateCompareValue<TIMER_CLK_DIV, SOURCE_CLK_FREQUENCY_HZ, TICK_PERIOD_US,
+                                                             std::chrono::microseconds, POSTSCALER>();
 
-    /* Set Timer 0 compare value.
+    // Disable the interruption while the task list is being modified.
+    resetRegisterBits(getTAxCCTL0(), static_cast<uint16_t>(CCIE));
+    if (continuousMode) {
+      stop();
+      continuousMode = false;
+    }
+    numberOfTasks = 0;
+    // Adds every task with its compile time divisor. The array is only used to be able to expand the
+    // parameter pack in order.
+    using Expander = int[];
+    (void)Expander{0, (addTask(tasks, calculateTickDivisor<TICK_PERIOD_US,
+                                                           TaskHandler<periodValues, Durations>::PERIOD_IN_US,
+                                                           POSTSCALER>()),
+                       0)...};
+    applyClockDivider<CLK_DIV, TIMER_CLK_DIV>();
+
+    /* Set Timer compare value.
      * One can see that it is the correct value when looking at the disassembly on the call:
      * TaskHandler<500, std::chrono::milliseconds> task1(&task1Callback, true);
      * registerTask(task1); the assembly command is:
      * MOV.W   #0xf423,&Timer0_A3_TA0CCR0. Where #0xf423 is the value coming from compareValue evaluated in compile time
      * which is correct: (500000/8)-1 = 62499 = 0xF423.
      */
-    TAxCCR0 = COMPARE_VALUE;
+    getTAxCCR0() = COMPARE_VALUE;
     // Enable interrupt for CCR0.
-    setRegisterBits(TAxCCTL0, static_cast<uint16_t>(CCIE));
-    setRegisterBits(TAxCTL, static_cast<uint16_t>(MC_1));
+    setRegisterBits(getTAxCCTL0(), static_cast<uint16_t>(CCIE));
+    setRegisterBits(getTAxCTL(), static_cast<uint16_t>(MC_1));
+  }
+
+  /**
+   * Method to register up to three periodic tasks where each one uses its own timer comparator.
+   * The first task goes to CCR0, the second to CCR1 and the third to CCR2. E.g.:
+   *
+   * @code
+   *  TaskHandler<1, std::chrono::milliseconds> task1(&task1Callback, true);
+   *  TaskHandler<2500, std::chrono::microseconds> task2(&task2Callback, true);
+   *  TaskHandler<32, std::chrono::milliseconds> task3(&task3Callback, true);
+   *
+   *  Timer<1>::getTimer().registerCompareTasks(TIMER_CONFIG, task1, task2, task3);
+   * @endcode
+   *
+   * The timer counts in continuous mode and every time a comparator interruption happens, its
+   * CCRx register is advanced by the compare increment of that task, which is calculated in compile time.
+   * This way there is no software counting involved and the tasks have independent hardware timed periods.
+   * Non-periodic tasks disable the interruption of their comparator after being called.
+   *
+   * Since every period must fit in the 16 bit counter, the periods are limited to 0xFFFF timer counts.
+   * With AUTOMATIC_CLK_DIV, the input divider is the smallest one where the longest period fits.
+   * The tasks previously registered are replaced by the new ones.
+   *
+   * @note Timer0 CCR2 is used by the Pwm, so this mode should not be used on the Pwm timer.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ, uint64_t... periodValues, typename... Durations>
+  void registerCompareTasks(const TimerConfigBase<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ>& /*config*/,
+                            TaskHandler<periodValues, Durations>&... tasks) {
+    static_assert(sizeof...(tasks) > 0, "At least one task must be registered");
+    static_assert(sizeof...(tasks) <= NUMBER_OF_COMPARATORS, "Timer has only three comparators");
+
+    constexpr uint64_t LONGEST_PERIOD_US = maximum(TaskHandler<periodValues, Durations>::PERIOD_IN_US...);
+    constexpr int64_t TIMER_CLK_DIV = selectClockDivider<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ, LONGEST_PERIOD_US>();
+
+    stop();
+    applyClockDivider<CLK_DIV, TIMER_CLK_DIV>();
+    addCompareTasks<TIMER_CLK_DIV, SOURCE_CLK_FREQUENCY_HZ>(std::make_index_sequence<sizeof...(tasks)>(), tasks...);
+    numberOfTasks = sizeof...(tasks);
+    continuousMode = true;
+    setRegisterBits(getTAxCTL(), static_cast<uint16_t>(MC_2));
   }
 
   constexpr void stop() {
-    resetRegisterBits(TAxCTL, static_cast<uint16_t>(MC_3));
-    resetRegisterBits(TAxCCTL0, static_cast<uint16_t>(CCIE));
+    resetRegisterBits(getTAxCTL(), static_cast<uint16_t>(MC_3));
+    resetRegisterBits(getTAxCCTL0(), static_cast<uint16_t>(CCIE));
+    resetRegisterBits(getTAxCCTLn<1>(), static_cast<uint16_t>(CCIE));
+    resetRegisterBits(getTAxCCTLn<2>(), static_cast<uint16_t>(CCIE));
+  }
+  /**
+   * Method to only set the period of the timer in up mode, without registering any task or enabling
+   * the interruption. It is useful when only the hardware output of the timer is needed, like for the Pwm.
+   * Since the compare value is calculated in compile time, the only thing that goes to the binary is the
+   * setting of the registers.
+   *
+   * A period of 0 stops the timer, since in up mode the timer stops counting when TAxCCR0 is 0.
+   * With AUTOMATIC_CLK_DIV, the input divider is the smallest one where the period fits. There is no
+   * postscaler, since the hardware output has to toggle at the period.
+   *
+   * @tparam periodValue The period value in that specific magnitude.
+   * @tparam Duration std::chrono duration type.
+   */
+  template<uint64_t periodValue, typename Duration = std::chrono::microseconds, int64_t CLK_DIV,
+           int64_t SOURCE_CLK_FREQUENCY_HZ>
+  constexpr void setPeriod(const TimerConfigBase<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ>& /*config*/) {
+    constexpr uint64_t PERIOD_IN_US = TaskHandler<periodValue, Duration>::PERIOD_IN_US;
+    constexpr int64_t TIMER_CLK_DIV = selectClockDivider<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ, PERIOD_IN_US>();
+    // A period of 0 results in a compare value of 0. The period of about one count is only given so the
+    // calculation of the unused branch doesn't assert.
+    constexpr uint64_t COUNT_PERIOD_US = MICROSECONDS_PER_SECOND * TIMER_CLK_DIV / SOURCE_CLK_FREQUENCY_HZ + 1;
+    constexpr uint16_t COMPARE_VALUE =
+      (PERIOD_IN_US == 0)
+        ? 0
+        : calculateCompareValue<TIMER_CLK_DIV, SOURCE_CLK_FREQUENCY_HZ,
+                                (PERIOD_IN_US == 0) ? COUNT_PERIOD_US : PERIOD_IN_US>();
+    applyClockDivider<CLK_DIV, TIMER_CLK_DIV>();
+    getTAxCCR0() = COMPARE_VALUE;
+    setRegisterBits(getTAxCTL(), static_cast<uint16_t>(MC_1));
+  }
+
+  /**
+   * Method to call a function once at the next period boundary in up mode, when the timer counts back to 0.
+   * It is used to update the comparators in sync with the period, like the duty cycle of the Pwm, so the
+   * output never has a runt pulse. The interruption of CCR0 is only enabled until the function is called.
+   *
+   * The callback runs at the next wrap of the timer, never in the middle of the current period: in up mode
+   * CCIFG of CCR0 is set at every period even while its interruption is disabled, so the stale flag is
+   * cleared before the interruption is enabled. If tasks already keep the interruption enabled, the flag
+   * is left as it is, since it is then a pending tick of the tasks at the boundary itself.
+   *
+   * The interruption can take the callback at any time, so the callback, its context and CCIE are updated with the
+   * interruptions disabled, and their state is restored afterwards, so the callback can also register again.
+   *
+   * @param callback Function called from the CCR0 interruption
+   * @param context Pointer passed to the function
+   */
+  void callAtNextPeriod(const PeriodCallback callback, void* const context) noexcept {
+    const unsigned short interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    periodContext = context;
+    periodCallback = callback;
+    if ((getTAxCCTL0() & CCIE) == 0) {
+      resetRegisterBits(getTAxCCTL0(), static_cast<uint16_t>(CCIFG));
+      setRegisterBits(getTAxCCTL0(), static_cast<uint16_t>(CCIE));
+    }
+    __set_interrupt_state(interruptState);
   }
+
   /**
-   * Method to deregister a task. But not yet implemented
+   * Method to deregister a task. After it, the task is not called anymore and its object can be
+   * destroyed.
+   * In up mode the last task of the list takes its place, so there is no shifting of the list. In continuous mode
+   * the interruption of the comparator of that task is disabled.
+   *
    * @param taskHandler Takes the reference of the taskHandler.
+   * @return true if the task was registered in the timer, false otherwise.
    */
-  bool deregisterTask(TaskHandlerBase& /*taskHandler*/) {
-    // static_assert(false, "Function not yet implemented");
+  bool deregisterTask(TaskHandlerBase& taskHandler) noexcept {
+    for (uint8_t taskIndex = 0; taskIndex < numberOfTasks; taskIndex++) {
+      if (taskHandlers[taskIndex] != &taskHandler) {
+        continue;
+      }
+      if (continuousMode) {
+        // The index of the task is its comparator, so the other tasks must keep their indexes.
+        disableCompareInterrupt(taskIndex);
+        taskHandlers[taskIndex] = nullptr;
+      } else {
+        resetRegisterBits(getTAxCCTL0(), static_cast<uint16_t>(CCIE));
+        removeTask(taskIndex);
+        if (numberOfTasks > 0) {
+          setRegisterBits(getTAxCCTL0(), static_cast<uint16_t>(CCIE));
+        }
+      }
+      return true;
+    }
     return false;
   }
 
   /**
    * Function must be called by the timer interrupt.
+   * It counts down the ticks of every registered task and calls the ones that are due.
    *
    * @note There must be a better way of doing this. Maybe encapsulating
    * this function or setting durin runtime the interrupt function
    * to a private method of the Timer instance. Need to figure this out.
    */
   inline void interruptionHappened() {
-    taskHandlers[0]->callCallback();
+    if (continuousMode) {
+      compareChannelInterruption<0>();
+      return;
+    }
+    if (periodCallback != nullptr) {
+      const PeriodCallback callback = periodCallback;
+      periodCallback = nullptr;
+      callback(periodContext);
+    }
+    // Without a callback, also when it didn't register again, and without tasks, nothing uses the interruption.
+    if ((periodCallback == nullptr) && (numberOfTasks == 0)) {
+      resetRegisterBits(getTAxCCTL0(), static_cast<uint16_t>(CCIE));
+    }
+    uint8_t taskIndex = 0;
+    while (taskIndex < numberOfTasks) {
+      TaskHandlerBase& task = *taskHandlers[taskIndex];
+      if (--task.ticksUntilDue == 0) {
+        callTask<0, false>(task, 0);
+        if (!task.isPeriodic) {
+          // The last task is moved to this index, so it must be evaluated before moving on.
+          removeTask(taskIndex);
+          continue;
+        }
+        task.ticksUntilDue = task.tickDivisor;
+      }
+      taskIndex++;
+    }
+  }
+
+  /**
+   * Method to know which clock has to keep running while the CPU sleeps, so this timer and its tasks
+   * keep working. If the timer is stopped, it doesn't need any clock.
+   * @return The clock requirement of the timer combined with the ones of its tasks.
+   */
+  ClockRequirement getClockRequirement() const noexcept {
+    if ((getTAxCTL() & MC_3) == MC_0) {
+      return ClockRequirement::NONE;
+    }
+    ClockRequirement requirement = sourceClockRequirement;
+    for (uint8_t taskIndex = 0; taskIndex < numberOfTasks; taskIndex++) {
+      if (taskHandlers[taskIndex] != nullptr) {
+        requirement = combineClockRequirements(requirement, taskHandlers[taskIndex]->requiredClock);
+      }
+    }
+    return requirement;
+  }
+
+  /**
+   * Function must be called by the timer interrupt of CCR1, CCR2 and overflow.
+   * Reading TAxIV returns the highest priority pending interruption and clears its flag.
+   * Each comparator either captures or calls its compare task.
+   */
+  inline void compareInterruptionHappened() {
+    switch (__even_in_range(getTAxIV(), TA0IV_TAIFG)) {
+      case TA0IV_TACCR1: channelInterruption<1>(); break;
+      case TA0IV_TACCR2: channelInterruption<2>(); break;
+      default: break;
+    }
+  }
+
+  /**
+   * Method to start capturing the edges of an input with a comparator. E.g. to measure the frequency of a signal
+   * on P2.1:
+   *
+   * @code
+   *  CaptureChannel capture;
+   *  ...
+   *  input.setIoFunctionality(IOFunctionality::TIMER_CAPTURE_INPUT);
+   *  Timer<1>::getTimer().init(TIMER_CONFIG);
+   *  Timer<1>::getTimer().startCapture<1>(TIMER_CONFIG, capture, CaptureEdge::RISING);
+   *  ...
+   *  const uint32_t frequency = capture.getFrequencyHz();
+   * @endcode
+   *
+   * CCR0 sets the period in up mode, so only CCR1 and CCR2 capture. If the timer is stopped, it starts counting
+   * in continuous mode. Otherwise it keeps its mode, so the capture can share the timer with tasks registered
+   * before it, and in up mode the differences wrap at CCR0 + 1. The capture replaces the compare task of the
+   * comparator, if any.
+   *
+   * @tparam CHANNEL Comparator that captures, 1 or 2
+   * @param config Configuration of the timer, used to convert the counts to Hz
+   * @param capture Object that keeps the timestamps. It must exist while the capture runs.
+   * @param edge Edges that are captured
+   * @param input Input of the comparator
+   */
+  template<uint8_t CHANNEL, int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ>
+  void startCapture(const TimerConfigBase<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ>& /*config*/, CaptureChannel& capture,
+                    const CaptureEdge edge, const CaptureInput input = CaptureInput::CCI_A) noexcept {
+    static_assert((CHANNEL == 1) || (CHANNEL == 2), "Only CCR1 and CCR2 can capture, CCR0 sets the period");
+    getTAxCCTLn<CHANNEL>() = 0;
+    if ((getTAxCTL() & MC_3) == MC_0) {
+      setRegisterBits(getTAxCTL(), static_cast<uint16_t>(MC_2));
+    }
+    const bool upMode = (getTAxCTL() & MC_3) == MC_1;
+    capture.start(edge, upMode ? static_cast<uint16_t>(getTAxCCR0() + 1) : 0,
+                  static_cast<uint32_t>(SOURCE_CLK_FREQUENCY_HZ) / getInputDivider());
+    captureChannels[CHANNEL] = &capture;
+    // The capture is synchronized to the timer clock, so the timestamp is never read while the counter changes.
+    getTAxCCTLn<CHANNEL>() = static_cast<uint16_t>(edge) | static_cast<uint16_t>(input) | SCS | CAP | CCIE;
   }
 
+  /**
+   * Method to stop capturing with a comparator. The timer keeps counting.
+   * @tparam CHANNEL Comparator that captures, 1 or 2
+   */
+  template<uint8_t CHANNEL>
+  void stopCapture() noexcept {
+    static_assert((CHANNEL == 1) || (CHANNEL == 2), "Only CCR1 and CCR2 can capture, CCR0 sets the period");
+    getTAxCCTLn<CHANNEL>() = 0;
+    captureChannels[CHANNEL] = nullptr;
+  }
+
+  /**
+   * Method to get the input divider of the timer, also when it was chosen automatically
+   * @return 1, 2, 4 or 8
+   */
+  uint16_t getInputDivider() const noexcept {
+    return static_cast<uint16_t>(1U << ((getTAxCTL() & ID_3) / ID_1));
+  }
+
+  /**
+   * Method to get how many tasks are registered. In continuous mode, the tasks are at the index of their
+   * comparator, so deregistered ones are nullptr.
+   */
+  uint8_t getNumberOfTasks() const noexcept {
+    return numberOfTasks;
+  }
+
+  /**
+   * Method to get a registered task
+   * @param taskIndex Index in the list of tasks, from 0 to getNumberOfTasks() - 1
+   * @return The task, or nullptr if there is no task in the index
+   */
+  TaskHandlerBase* getTask(const uint8_t taskIndex) const noexcept {
+    return (taskIndex < numberOfTasks) ? taskHandlers[taskIndex] : nullptr;
+  }
+
+  /// Maximum number of tasks that can be registered at the same time in one timer.
+  static constexpr uint8_t MAX_NUMBER_OF_TASKS = 4;
+  /// Number of comparators (CCR0, CCR1 and CCR2) of the timer.
+  static constexpr uint8_t NUMBER_OF_COMPARATORS = 3;
+  /// Largest input divider of the timer.
+  static constexpr int64_t MAX_CLK_DIV = 8;
+  /// Number of counts of the 16 bit counter, so the longest period of a tick.
+  static constexpr uint64_t COUNTER_LENGTH = 0x10000;
+  /// Used to convert the periods in microseconds and the frequencies in Hz to timer counts.
+  static constexpr uint64_t MICROSECONDS_PER_SECOND = 1000000;
+
 protected:
   /**
    * Function to calculate the TACCRx value.
@@ -243,7 +903,8 @@ protected:
    * this doesn't result in a function call during runtime and it is
    * evaluated in compile time resulting in just a number in the program binary.
    */
-  template<int64_t CLK_DIV, int64_t SOURCE_CLK_PERIOD_US, uint64_t periodValue, typename Duration = std::chrono::microseconds>
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ, uint64_t periodValue,
+           typename Duration = std::chrono::microseconds, uint16_t POSTSCALER = 1>
   static constexpr uint16_t calculateCompareValue() {
     // Declares the duration given by the user and then converts it to microseconds
     // !! Duration is a type and periodValue is a value !!
@@ -251,20 +912,257 @@ protected:
     constexpr std::chrono::microseconds PERIOD_IN_US = PERIOD;
 
     /*
-     * Internal clock is 1 MHz, according to templateEMP.h
+     * The source clock is given by the configuration, usually from the SystemClock.
      *
-     * So the compare value is basically the (period[us] / (1us * clockDiv)) - 1. The -1 because the counter starts in 0
+     * So the compare value is basically the (period[us] * frequency[MHz] / clockDiv) - 1. The -1 because the counter
+     * starts in 0. With a postscaler, the period is split in that many ticks.
      * !!!! Since all the values are constants, the division is evaluated in compile time. !!!!!
      */
-    constexpr int64_t COMPARE_VALUE = (PERIOD_IN_US.count() / (CLK_DIV*SOURCE_CLK_PERIOD_US)) - 1;
+    constexpr int64_t COMPARE_VALUE =
+      static_cast<int64_t>(calculateCounts<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ>(PERIOD_IN_US.count()) / POSTSCALER) - 1;
 
     // Static assert so if the compareValue is bigger than 0xFFFF the compiler gives an error. This is not added as
     // instructions in the binary. One could verify that it works by calling "setupTimer0<5, std::chrono::seconds>();".
     static_assert((COMPARE_VALUE <= 0xFFFF), "Cannot set desired timer period. It exceeds the counter maximum value");
+    static_assert((COMPARE_VALUE >= 0), "Cannot set desired timer period. It is shorter than the timer resolution");
     return static_cast<uint16_t>(COMPARE_VALUE);
   }
 
+  /**
+   * Function to calculate how many timer ticks a task has to wait until it is called.
+   * Evaluated in compile time.
+   */
+  template<uint64_t TICK_PERIOD_US, uint64_t TASK_PERIOD_US, uint16_t POSTSCALER = 1>
+  static constexpr uint16_t calculateTickDivisor() {
+    constexpr uint64_t TICK_DIVISOR = (TASK_PERIOD_US / TICK_PERIOD_US) * POSTSCALER;
+    static_assert((TICK_DIVISOR <= 0xFFFF), "Task period is too long compared to the shortest task of the timer");
+    return static_cast<uint16_t>(TICK_DIVISOR);
+  }
+
+  /**
+   * Function to calculate how many timer counts fit in a period. Evaluated in compile time.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ>
+  static constexpr uint64_t calculateCounts(const uint64_t periodUs) {
+    return periodUs * SOURCE_CLK_FREQUENCY_HZ / (CLK_DIV * MICROSECONDS_PER_SECOND);
+  }
+
+  /**
+   * Function to choose the input divider in compile time. A divider given in the configuration is kept. With
+   * AUTOMATIC_CLK_DIV, it is the smallest one where the period fits in the counter, so the resolution is the best
+   * possible. If the period doesn't fit even with the largest one, the largest one is used.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ, uint64_t PERIOD_US>
+  static constexpr int64_t selectClockDivider() {
+    if (CLK_DIV != AUTOMATIC_CLK_DIV) {
+      return CLK_DIV;
+    }
+    int64_t clockDivider = 1;
+    while ((clockDivider < MAX_CLK_DIV) &&
+           (PERIOD_US * SOURCE_CLK_FREQUENCY_HZ / (clockDivider * MICROSECONDS_PER_SECOND) > COUNTER_LENGTH)) {
+      clockDivider *= 2;
+    }
+    return clockDivider;
+  }
+
+  /**
+   * Function to calculate in how many ticks a period is split so each one fits in the counter. Evaluated in
+   * compile time. If possible, the postscaler divides the counts of the period exactly, so the period is kept.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ, uint64_t PERIOD_US>
+  static constexpr uint16_t calculatePostscaler() {
+    constexpr uint64_t COUNTS = calculateCounts<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ>(PERIOD_US);
+    constexpr uint64_t MIN_POSTSCALER = (COUNTS <= COUNTER_LENGTH) ? 1 : (COUNTS + COUNTER_LENGTH - 1) / COUNTER_LENGTH;
+    static_assert((MIN_POSTSCALER <= 0xFFFF), "Cannot set desired timer period. It exceeds the postscaler range");
+    return static_cast<uint16_t>(findExactPostscaler(COUNTS, MIN_POSTSCALER));
+  }
+
+  /**
+   * Smallest postscaler from the minimum up to twice of it that divides the counts without rest, or the minimum.
+   */
+  static constexpr uint64_t findExactPostscaler(const uint64_t counts, const uint64_t minimum) {
+    for (uint64_t postscaler = minimum; (postscaler < 2 * minimum) && (postscaler <= 0xFFFF); postscaler++) {
+      if ((counts % postscaler) == 0) {
+        return postscaler;
+      }
+    }
+    return minimum;
+  }
+
+  /**
+   * Method to write the input divider chosen in compile time when the configuration is automatic.
+   * The divider only takes effect after the counter is cleared.
+   */
+  template<int64_t CLK_DIV, int64_t TIMER_CLK_DIV>
+  void applyClockDivider() noexcept {
+    if (CLK_DIV == AUTOMATIC_CLK_DIV) {
+      getTAxCTL() = (getTAxCTL() & ~(ID_3 | MC_3)) | getTimerInputDivider<TIMER_CLK_DIV>() | TACLR;
+    }
+  }
+
+  /**
+   * Function to calculate by how much a CCRx register has to be advanced in continuous mode
+   * so the interruption happens with the desired period. Evaluated in compile time.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ, uint64_t TASK_PERIOD_US>
+  static constexpr uint16_t calculateCompareIncrement() {
+    constexpr uint64_t COMPARE_INCREMENT = calculateCounts<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ>(TASK_PERIOD_US);
+    static_assert((COMPARE_INCREMENT <= 0xFFFF), "Cannot set desired timer period. It exceeds the counter maximum value");
+    static_assert((COMPARE_INCREMENT > 0), "Cannot set desired timer period. It is shorter than the timer resolution");
+    return static_cast<uint16_t>(COMPARE_INCREMENT);
+  }
+
+  /**
+   * Greatest common divisor of the task periods. Used to calculate the timer tick in compile time.
+   */
+  static constexpr uint64_t greatestCommonDivisor(uint64_t value) {
+    return value;
+  }
+
+  template<typename... Values>
+  static constexpr uint64_t greatestCommonDivisor(uint64_t first, uint64_t second, Values... others) {
+    return second == 0 ? greatestCommonDivisor(first, others...)
+                       : greatestCommonDivisor(second, first % second, others...);
+  }
+
+  /**
+   * Longest of the task periods. Used to choose the input divider of the continuous mode in compile time.
+   */
+  static constexpr uint64_t maximum(uint64_t value) {
+    return value;
+  }
+
+  template<typename... Values>
+  static constexpr uint64_t maximum(uint64_t first, uint64_t second, Values... others) {
+    return maximum((first > second) ? first : second, others...);
+  }
+
 private:
+  /**
+   * Method to add a task to the task list.
+   * @param task The task to be added
+   * @param tickDivisor Number of ticks between two calls of the task
+   */
+  void addTask(TaskHandlerBase& task, const uint16_t tickDivisor) noexcept {
+    task.tickDivisor = tickDivisor;
+    task.ticksUntilDue = tickDivisor;
+    taskHandlers[numberOfTasks++] = &task;
+  }
+
+  /**
+   * Method to add the tasks to the comparators. The index sequence is used so the comparator of each task
+   * is known in compile time.
+   */
+  template<int64_t CLK_DIV, int64_t SOURCE_CLK_FREQUENCY_HZ, std::size_t... CHANNELS, uint64_t... periodValues,
+           typename... Durations>
+  void addCompareTasks(std::index_sequence<CHANNELS...> /*channels*/, TaskHandler<periodValues, Durations>&... tasks) {
+    using Expander = int[];
+    (void)Expander{0, (addCompareTask<CHANNELS>(tasks, calculateCompareIncrement<CLK_DIV, SOURCE_CLK_FREQUENCY_HZ,
+                                                     TaskHandler<periodValues, Durations>::PERIOD_IN_US>()),
+                       0)...};
+  }
+
+  /**
+   * Method to add a task to an specific comparator.
+   * The task list index is the same as the comparator number.
+   * @param task The task to be added
+   * @param compareIncrement By how much the comparator is advanced after every interruption.
+   */
+  template<uint8_t CHANNEL>
+  void addCompareTask(TaskHandlerBase& task, const uint16_t compareIncrement) noexcept {
+    captureChannels[CHANNEL] = nullptr;
+    taskHandlers[CHANNEL] = &task;
+    compareIncrements[CHANNEL] = compareIncrement;
+    getTAxCCRn<CHANNEL>() = getTAxR() + compareIncrement;
+    getTAxCCTLn<CHANNEL>() = CCIE;
+  }
+
+  /**
+   * Method called by the interruption of CCR1 and CCR2.
+   */
+  template<uint8_t CHANNEL>
+  inline void channelInterruption() {
+    CaptureChannel* const capture = captureChannels[CHANNEL];
+    if (capture == nullptr) {
+      compareChannelInterruption<CHANNEL>();
+      return;
+    }
+    RegisterRef control = getTAxCCTLn<CHANNEL>();
+    if ((control & COV) != 0) {
+      resetRegisterBits(control, static_cast<uint16_t>(COV));
+      capture->overflows = capture->overflows + 1;
+    }
+    // The input is read right after the edge, so it tells which edge it was.
+    capture->addCapture(getTAxCCRn<CHANNEL>(), (control & CCI) != 0);
+  }
+
+  /**
+   * Method called when a comparator interruption happens in continuous mode.
+   * It schedules the next interruption and calls the task.
+   */
+  template<uint8_t CHANNEL>
+  inline void compareChannelInterruption() {
+    const uint16_t dueCount = getTAxCCRn<CHANNEL>();
+    getTAxCCRn<CHANNEL>() = dueCount + compareIncrements[CHANNEL];
+    TaskHandlerBase& task = *taskHandlers[CHANNEL];
+    callTask<CHANNEL, true>(task, dueCount);
+    if (!task.isPeriodic) {
+      resetRegisterBits(getTAxCCTLn<CHANNEL>(), static_cast<uint16_t>(CCIE));
+    }
+  }
+
+  /**
+   * Method to call the callback of a task. When MICROTECH_TASK_PROFILING is defined, it also measures the
+   * task with the counter of the timer and adds the call to the profile of the task.
+   * The flag of the comparator is set again by the next tick, so if it is set when the task returns, it overran.
+   * @tparam CHANNEL Comparator that calls the task
+   * @tparam FREE_RUNNING If the timer is in continuous mode. Otherwise it is in up mode.
+   * @param task Task to be called
+   * @param dueCount Value of the counter when the task was due. Only used in continuous mode.
+   */
+  template<uint8_t CHANNEL, bool FREE_RUNNING>
+  inline void callTask(TaskHandlerBase& task, const uint16_t dueCount) {
+#ifdef MICROTECH_TASK_PROFILING
+    // In up mode the task is due when the counter reaches CCR0, and then the counter restarts at 0.
+    const uint16_t due = FREE_RUNNING ? dueCount : getTAxCCR0();
+    const uint16_t wrapCounts = FREE_RUNNING ? 0 : static_cast<uint16_t>(due + 1);
+    const uint16_t start = getTAxR();
+    task.callCallback();
+    const uint16_t end = getTAxR();
+    task.profile.addCall(countsBetween(due, start, wrapCounts), countsBetween(start, end, wrapCounts),
+                         (getTAxCCTLn<CHANNEL>() & CCIFG) != 0);
+#else
+    (void)dueCount;
+    task.callCallback();
+#endif
+  }
+
+  /**
+   * Method to disable the interruption of a comparator when the comparator is only known in runtime.
+   * @param channel The comparator number
+   */
+  void disableCompareInterrupt(const uint8_t channel) noexcept {
+    switch (channel) {
+      case 0: resetRegisterBits(getTAxCCTLn<0>(), static_cast<uint16_t>(CCIE)); break;
+      case 1: resetRegisterBits(getTAxCCTLn<1>(), static_cast<uint16_t>(CCIE)); break;
+      case 2: resetRegisterBits(getTAxCCTLn<2>(), static_cast<uint16_t>(CCIE)); break;
+      default: break;
+    }
+  }
+
+  /**
+   * Method to remove a task from the task list. The last task of the list is moved to
+   * the index of the removed one, so no shifting is necessary.
+   * If there are no more tasks left, the interruption is disabled, but the timer keeps counting.
+   * @param taskIndex Index of the task to be removed.
+   */
+  void removeTask(const uint8_t taskIndex) noexcept {
+    taskHandlers[taskIndex] = taskHandlers[--numberOfTasks];
+    if (numberOfTasks == 0) {
+      resetRegisterBits(getTAxCCTL0(), static_cast<uint16_t>(CCIE));
+    }
+  }
+
   /**
    * Method to get the correct value of the timer interrupt
    * Divider given in the template parameter of this class.
@@ -311,30 +1209,122 @@ private:
     return TA0CCTL0;
   }
 
+  static RegisterRef getTAxR() {
+    switch (TIMER_NUMBER) {
+      case 0: return TA0R;
+      case 1: return TA1R;
+    };
+    return TA0R;
+  }
+
+  static RegisterRef getTAxIV() {
+    switch (TIMER_NUMBER) {
+      case 0: return TA0IV;
+      case 1: return TA1IV;
+    };
+    return TA0IV;
+  }
+
+  /**
+   * Returns the compare register of the desired comparator.
+   * Since both the timer and the comparator are template parameters, the compiler resolves it to the register address.
+   */
+  template<uint8_t CHANNEL>
+  static RegisterRef getTAxCCRn() {
+    static_assert(CHANNEL < NUMBER_OF_COMPARATORS, "Timer has only three comparators");
+    switch (TIMER_NUMBER) {
+      case 0: return CHANNEL == 0 ? TA0CCR0 : (CHANNEL == 1 ? TA0CCR1 : TA0CCR2);
+      case 1: return CHANNEL == 0 ? TA1CCR0 : (CHANNEL == 1 ? TA1CCR1 : TA1CCR2);
+    };
+    return TA0CCR0;
+  }
+
+  /**
+   * Returns the capture/compare control register of the desired comparator.
+   */
+  template<uint8_t CHANNEL>
+  static RegisterRef getTAxCCTLn() {
+    static_assert(CHANNEL < NUMBER_OF_COMPARATORS, "Timer has only three comparators");
+    switch (TIMER_NUMBER) {
+      case 0: return CHANNEL == 0 ? TA0CCTL0 : (CHANNEL == 1 ? TA0CCTL1 : TA0CCTL2);
+      case 1: return CHANNEL == 0 ? TA1CCTL0 : (CHANNEL == 1 ? TA1CCTL1 : TA1CCTL2);
+    };
+    return TA0CCTL0;
+  }
+
   /**
    * List of the task handlers registered to the timer.
-   *
-   * For now it is only one, but the container is there already so later it is easier
-   * to update the code. And also doesn't add much extra overhead or memory.
+   * Only the first numberOfTasks entries are valid.
    */
-  std::array<TaskHandlerBase*, 1> taskHandlers;
-  RegisterRef TAxCTL;
-  RegisterRef TAxCCR0;
-  RegisterRef TAxCCTL0;
+  std::array<TaskHandlerBase*, MAX_NUMBER_OF_TASKS> taskHandlers{};
+  uint8_t numberOfTasks = 0;  ///< Number of tasks currently registered.
+  /// In continuous mode, by how much each comparator is advanced after its interruption.
+  std::array<uint16_t, NUMBER_OF_COMPARATORS> compareIncrements{};
+  /// Comparators that capture instead of calling a task, nullptr otherwise.
+  std::array<CaptureChannel*, NUMBER_OF_COMPARATORS> captureChannels{};
+  bool continuousMode = false;  ///< If the tasks are registered to the comparators in continuous mode.
+  ClockRequirement sourceClockRequirement = ClockRequirement::SMCLK;  ///< Clock needed by the timer source
+  volatile PeriodCallback periodCallback = nullptr;  ///< Function called at the next period boundary, if any
+  void* periodContext = nullptr;                     ///< Pointer passed to the period callback
 };
 
+/**
+ * Idle hook of the scheduler. It is intended to be called in the main loop instead of busy waiting:
+ *
+ * @code
+ *  while (true) {
+ *    idle();
+ *    // Work requested by the interruptions through LowPower::requestWakeUp()
+ *  }
+ * @endcode
+ *
+ * The CPU goes to the deepest low power mode that keeps running the clocks needed by both timers
+ * and their tasks. That is LPM0 when a timer is fed by SMCLK, LPM3 when only ACLK is needed and LPM4 otherwise.
+ *
+ * @param additionalRequirement Clock needed by something else than the timers, e.g. the serial communication.
+ */
+inline void idle(const ClockRequirement additionalRequirement = ClockRequirement::NONE) noexcept {
+  const ClockRequirement timersRequirement = combineClockRequirements(Timer<0>::getTimer().getClockRequirement(),
+                                                                      Timer<1>::getTimer().getClockRequirement());
+  LowPower::enter(combineClockRequirements(timersRequirement, additionalRequirement));
+}
+
 } /* namespace Microtech */
 
 // Timer0 Interruption
 #pragma vector = TIMER0_A0_VECTOR
 __interrupt void Timer_A_CCR0_ISR(void) {
   Microtech::Timer<0>::getTimer().interruptionHappened();
+  if (Microtech::LowPower::isWakeUpRequested()) {
+    __bic_SR_register_on_exit(LPM4_bits);
+  }
 }
 
 // Timer1 Interruption
 #pragma vector = TIMER1_A0_VECTOR
 __interrupt void Timer1_A_CCR0_ISR(void) {
   Microtech::Timer<1>::getTimer().interruptionHappened();
+  if (Microtech::LowPower::isWakeUpRequested()) {
+    __bic_SR_register_on_exit(LPM4_bits);
+  }
+}
+
+// Timer0 CCR1, CCR2 and overflow Interruption
+#pragma vector = TIMER0_A1_VECTOR
+__interrupt void Timer_A_CCR1_2_ISR(void) {
+  Microtech::Timer<0>::getTimer().compareInterruptionHappened();
+  if (Microtech::LowPower::isWakeUpRequested()) {
+    __bic_SR_register_on_exit(LPM4_bits);
+  }
+}
+
+// Timer1 CCR1, CCR2 and overflow Interruption
+#pragma vector = TIMER1_A1_VECTOR
+__interrupt void Timer1_A_CCR1_2_ISR(void) {
+  Microtech::Timer<1>::getTimer().compareInterruptionHappened();
+  if (Microtech::LowPower::isWakeUpRequested()) {
+    __bic_SR_register_on_exit(LPM4_bits);
+  }
 }
 
 #endif /* COMMON_TIMER_HPP_ */
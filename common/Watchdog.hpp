@@ -0,0 +1,324 @@
+/******************************************************************************
+ * @file                    Watchdog.hpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Header contains abstraction of the watchdog timer WDT+
+ *
+ * Description: The WDT+ has two modes, and the Watchdog supports both:
+ *
+ *              Watchdog mode: the MSP is reset if the counter is not cleared
+ *              within the interval. Instead of clearing it at an arbitrary place
+ *              of the application, every part that has to keep running gets a
+ *              ProgressMonitor and reports its progress, e.g. once per call of a
+ *              task and once per pass of the main loop. The counter is only
+ *              cleared when every monitor reported since the last clear, so a
+ *              task that stopped being called or a main loop that is stuck
+ *              resets the MSP, even if the interruptions keep running:
+ *                ProgressMonitor mainLoopMonitor = Watchdog::getInstance().registerMonitor();
+ *                ProgressMonitor controlMonitor = Watchdog::getInstance().registerMonitor();
+ *                ...
+ *                Watchdog::getInstance().startWatchdog<WatchdogClock::ACLK, WatchdogInterval::CLOCKS_32768>();
+ *                while (true) {
+ *                  mainLoopMonitor.reportProgress();
+ *                  idle();
+ *                }
+ *
+ *              Interval timer mode: the counter only requests an interruption at
+ *              every interval, so it is a tick for tasks with long periods. With
+ *              ACLK it keeps running in LPM3, and both Timer_A stay free for the
+ *              Pwm or captures:
+ *                TaskHandler<1, std::chrono::seconds> heartbeatTask(&heartbeat, true);
+ *                Watchdog::getInstance().registerTasks<WatchdogClock::ACLK, WatchdogInterval::CLOCKS_8192>(
+ *                  heartbeatTask);
+ *                ...
+ *                idle(Watchdog::getInstance().getClockRequirement());
+ *
+ *              There is only one WDT+, so the two modes cannot be used at the same
+ *              time. The intervals are the number of clocks in WatchdogInterval,
+ *              e.g. 8192 clocks of a 32768 Hz ACLK are 250 ms.
+ ******************************************************************************/
+#ifndef MICROTECH_WATCHDOG_HPP
+#define MICROTECH_WATCHDOG_HPP
+
+#include "ClockSystem.hpp"
+#include "LowPower.hpp"
+#include "Timer.hpp"
+#include "helpers.hpp"
+#include <msp430g2553.h>
+#include <chrono>
+#include <cstdint>
+
+namespace Microtech {
+
+/**
+ * Source clock of the watchdog
+ */
+enum class WatchdogClock : uint8_t {
+  SMCLK = 0,
+  ACLK = WDTSSEL,
+};
+
+/**
+ * Number of clocks of the source in an interval
+ */
+enum class WatchdogInterval : uint8_t {
+  CLOCKS_32768 = 0,
+  CLOCKS_8192 = WDTIS0,
+  CLOCKS_512 = WDTIS1,
+  CLOCKS_64 = WDTIS1 | WDTIS0,
+};
+
+/**
+ * Handle of a part of the application that is supervised by the Watchdog. It is given by
+ * Watchdog::registerMonitor.
+ */
+class ProgressMonitor {
+  friend class Watchdog;
+
+public:
+  /**
+   * Method to inform that this part of the application made progress. It can be called by the main loop and by the
+   * interruptions.
+   */
+  inline void reportProgress() const noexcept;
+
+private:
+  constexpr explicit ProgressMonitor(const uint8_t mask) : mask(mask) {}
+
+  const uint8_t mask;  ///< Bit of the monitor in the progress of the Watchdog
+};
+
+class Watchdog {
+  friend struct SingletonInstance<Watchdog>;
+  constexpr Watchdog() = default;
+
+public:
+  // Deleted copy and move constructors
+  Watchdog(Watchdog&) = delete;
+  Watchdog(Watchdog&&) = delete;
+  ~Watchdog() = default;
+
+  static constexpr uint8_t MAX_NUMBER_OF_MONITORS = 8;  ///< One bit of the progress per monitor
+  static constexpr uint8_t MAX_NUMBER_OF_TASKS = 4;     ///< Tasks of the interval timer mode
+
+  /**
+   * Method that guarantees that there is only one instance of the Watchdog class in the software
+   * @return A reference to the instance
+   */
+  static Watchdog& getInstance() noexcept {
+    return SingletonInstance<Watchdog>::instance;
+  }
+
+  /**
+   * Method to stop the watchdog in any mode. It is also what the initMSP of the templateEMP does after the reset.
+   */
+  void hold() noexcept {
+    resetRegisterBits(IE1, static_cast<uint8_t>(WDTIE));
+    WDTCTL = WDTPW | WDTHOLD;
+    mode = Mode::HELD;
+  }
+
+  /**
+   * Method to add a part of the application to be supervised. It should be registered before starting the watchdog
+   * mode, otherwise its first report is already required for the next clear of the counter.
+   * @return The monitor. If MAX_NUMBER_OF_MONITORS were already registered, the monitor is not supervised.
+   */
+  ProgressMonitor registerMonitor() noexcept {
+    if (numberOfMonitors >= MAX_NUMBER_OF_MONITORS) {
+      return ProgressMonitor(0);
+    }
+    const uint8_t mask = static_cast<uint8_t>(0x01 << numberOfMonitors++);
+    registeredMonitors = static_cast<uint8_t>(registeredMonitors | mask);
+    return ProgressMonitor(mask);
+  }
+
+  /**
+   * Method to start the watchdog mode. The MSP is reset if the monitors don't all report their progress within
+   * one interval, so the interval has to be longer than the period of the slowest monitor. E.g. 32768 clocks of
+   * ACLK from the VLO divided by 8 are around 21.8s.
+   * @tparam CLOCK Source clock of the counter
+   * @tparam INTERVAL Number of clocks until the reset
+   */
+  template<WatchdogClock CLOCK, WatchdogInterval INTERVAL>
+  void startWatchdog() noexcept {
+    resetRegisterBits(IE1, static_cast<uint8_t>(WDTIE));
+    control = static_cast<uint8_t>(static_cast<uint8_t>(CLOCK) | static_cast<uint8_t>(INTERVAL));
+    progress = 0;
+    mode = Mode::WATCHDOG;
+    WDTCTL = WDTPW | WDTCNTCL | control;
+  }
+
+  /**
+   * Method to register a group of tasks to the interval timer mode. E.g.:
+   *
+   * @code
+   *  // Periodic task that is called every second
+   *  TaskHandler<1, std::chrono::seconds> task1(&task1Callback, true);
+   *  // Non-periodic task that is called once 10s from now
+   *  TaskHandler<10, std::chrono::seconds> event1(&event1Callback, false);
+   *
+   *  Watchdog::getInstance().registerTasks<WatchdogClock::ACLK, WatchdogInterval::CLOCKS_8192>(task1, event1);
+   * @endcode
+   *
+   * The interval is the tick, so each task waits its period rounded to a whole number of intervals (4 and 40
+   * in the example above). The numbers of intervals are calculated in compile time from the SystemClock.
+   * The tasks previously registered are replaced by the new ones, and the watchdog mode is stopped.
+   *
+   * @tparam CLOCK Source clock of the counter
+   * @tparam INTERVAL Number of clocks of the tick
+   */
+  template<WatchdogClock CLOCK, WatchdogInterval INTERVAL, uint64_t... periodValues, typename... Durations>
+  void registerTasks(TaskHandler<periodValues, Durations>&... tasks) noexcept {
+    static_assert(sizeof...(tasks) > 0, "At least one task must be registered");
+    static_assert(sizeof...(tasks) <= MAX_NUMBER_OF_TASKS, "Too many tasks registered to the watchdog");
+
+    hold();
+    numberOfTasks = 0;
+    using Expander = int[];
+    (void)Expander{0, (addTask(tasks, calculateTickDivisor<CLOCK, INTERVAL,
+                                                           TaskHandler<periodValues, Durations>::PERIOD_IN_US>()),
+                       0)...};
+    control = static_cast<uint8_t>(static_cast<uint8_t>(CLOCK) | static_cast<uint8_t>(INTERVAL));
+    mode = Mode::INTERVAL_TIMER;
+    WDTCTL = WDTPW | WDTTMSEL | WDTCNTCL | control;
+    resetRegisterBits(IFG1, static_cast<uint8_t>(WDTIFG));
+    setRegisterBits(IE1, static_cast<uint8_t>(WDTIE));
+  }
+
+  /**
+   * Function to get the length of an interval. Evaluated in compile time.
+   * @return The interval in microseconds
+   */
+  template<WatchdogClock CLOCK, WatchdogInterval INTERVAL>
+  static constexpr uint64_t getIntervalUs() noexcept {
+    return getIntervalClocks(INTERVAL) * MICROSECONDS_PER_SECOND / getSourceFrequencyHz(CLOCK);
+  }
+
+  /**
+   * Method to know which clock has to keep running while the CPU sleeps. In the interval timer mode, it is the
+   * source of the counter combined with the ones of the tasks. In the watchdog mode no clock is requested. The
+   * counter then stops in the low power modes without its clock, and there is no code running to be supervised.
+   * @return The clock requirement of the watchdog
+   */
+  ClockRequirement getClockRequirement() const noexcept {
+    if (mode != Mode::INTERVAL_TIMER) {
+      return ClockRequirement::NONE;
+    }
+    ClockRequirement requirement = ((control & WDTSSEL) != 0) ? ClockRequirement::ACLK : ClockRequirement::SMCLK;
+    for (uint8_t taskIndex = 0; taskIndex < numberOfTasks; taskIndex++) {
+      requirement = combineClockRequirements(requirement, taskHandlers[taskIndex]->requiredClock);
+    }
+    return requirement;
+  }
+
+  /**
+   * Method called by ProgressMonitor::reportProgress. When the last monitor reports, the counter is cleared and
+   * the monitors have to report again. The interruptions are disabled meanwhile, since the main loop and the
+   * interruptions can report at the same time, and restored afterwards, so it can also be called by them.
+   * @param mask Bit of the monitor
+   */
+  void reportProgress(const uint8_t mask) noexcept {
+    const unsigned short interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    progress = static_cast<uint8_t>(progress | mask);
+    if ((mode == Mode::WATCHDOG) && (progress == registeredMonitors)) {
+      WDTCTL = WDTPW | WDTCNTCL | control;
+      progress = 0;
+    }
+    __set_interrupt_state(interruptState);
+  }
+
+  /**
+   * Function must be called by the watchdog interrupt in the interval timer mode.
+   * It counts down the intervals of every registered task and calls the ones that are due.
+   */
+  inline void interruptionHappened() {
+    uint8_t taskIndex = 0;
+    while (taskIndex < numberOfTasks) {
+      TaskHandlerBase& task = *taskHandlers[taskIndex];
+      if (--task.ticksUntilDue == 0) {
+        task.callCallback();
+        if (!task.isPeriodic) {
+          // The last task is moved to this index, so it must be evaluated before moving on.
+          taskHandlers[taskIndex] = taskHandlers[--numberOfTasks];
+          continue;
+        }
+        task.ticksUntilDue = task.tickDivisor;
+      }
+      taskIndex++;
+    }
+  }
+
+private:
+  /**
+   * Mode the WDT+ was configured to
+   */
+  enum class Mode : uint8_t {
+    HELD = 0,
+    WATCHDOG,
+    INTERVAL_TIMER,
+  };
+
+  static constexpr uint64_t MICROSECONDS_PER_SECOND = 1000000;
+
+  static constexpr uint64_t getIntervalClocks(const WatchdogInterval interval) noexcept {
+    switch (interval) {
+      case WatchdogInterval::CLOCKS_32768: return 32768;
+      case WatchdogInterval::CLOCKS_8192: return 8192;
+      case WatchdogInterval::CLOCKS_512: return 512;
+      case WatchdogInterval::CLOCKS_64: return 64;
+    }
+    return 32768;  // It will actually never get here. But it is needed due to the compiler warning
+  }
+
+  static constexpr uint64_t getSourceFrequencyHz(const WatchdogClock clock) noexcept {
+    return (clock == WatchdogClock::ACLK) ? SystemClock::ACLK_FREQUENCY_HZ : SystemClock::SMCLK_FREQUENCY_HZ;
+  }
+
+  /**
+   * Function to calculate how many intervals a task has to wait until it is called, rounded to the closest one.
+   * Evaluated in compile time.
+   */
+  template<WatchdogClock CLOCK, WatchdogInterval INTERVAL, uint64_t TASK_PERIOD_US>
+  static constexpr uint16_t calculateTickDivisor() noexcept {
+    constexpr uint64_t INTERVAL_CLOCKS_US = getIntervalClocks(INTERVAL) * MICROSECONDS_PER_SECOND;
+    constexpr uint64_t TICK_DIVISOR =
+      (TASK_PERIOD_US * getSourceFrequencyHz(CLOCK) + INTERVAL_CLOCKS_US / 2) / INTERVAL_CLOCKS_US;
+    static_assert((TICK_DIVISOR >= 1), "Task period is shorter than the watchdog interval");
+    static_assert((TICK_DIVISOR <= 0xFFFF), "Task period is too long compared to the watchdog interval");
+    return static_cast<uint16_t>(TICK_DIVISOR);
+  }
+
+  void addTask(TaskHandlerBase& task, const uint16_t tickDivisor) noexcept {
+    task.tickDivisor = tickDivisor;
+    task.ticksUntilDue = tickDivisor;
+    taskHandlers[numberOfTasks++] = &task;
+  }
+
+  TaskHandlerBase* taskHandlers[MAX_NUMBER_OF_TASKS] = {};  ///< Tasks of the interval timer mode
+  uint8_t numberOfTasks = 0;                                ///< Number of tasks of the interval timer mode
+  uint8_t control = 0;                                      ///< Clock and interval bits of WDTCTL
+  Mode mode = Mode::HELD;                                   ///< Current mode of the WDT+
+  uint8_t numberOfMonitors = 0;                             ///< Number of monitors registered
+  uint8_t registeredMonitors = 0;                           ///< One bit per monitor registered
+  volatile uint8_t progress = 0;                            ///< One bit per monitor that reported since the last clear
+};
+
+inline void ProgressMonitor::reportProgress() const noexcept {
+  Watchdog::getInstance().reportProgress(mask);
+}
+}  // namespace Microtech
+
+// Watchdog Interruption, only requested in the interval timer mode
+#pragma vector = WDT_VECTOR
+__interrupt void WDT_ISR(void) {
+  Microtech::Watchdog::getInstance().interruptionHappened();
+  if (Microtech::LowPower::isWakeUpRequested()) {
+    __bic_SR_register_on_exit(LPM4_bits);
+  }
+}
+
+#endif  // MICROTECH_WATCHDOG_HPP
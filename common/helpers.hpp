@@ -13,8 +13,22 @@
 #ifndef MICROTECH_HELPERS_HPP
 #define MICROTECH_HELPERS_HPP
 
+#include <msp430g2553.h>
 #include <cstdint>
 
+/**
+ * Type of a register whose content is a TYPE, e.g. RegisterType<uint8_t> for P1DIR.
+ * On the target it is the integer itself. The mock of the host declares the registers as Mock::Register, which counts
+ * every access.
+ */
+#ifdef MOCK_REGISTERS
+template<typename TYPE>
+using RegisterType = Mock::Register<TYPE>;
+#else
+template<typename TYPE>
+using RegisterType = TYPE;
+#endif
+
 /**
  * Method to set the desired bits of a register to 1.
  * @param registerRef is the reference to the register to be accessed.
@@ -52,7 +66,7 @@
  * to get a feeling. You can see that many instructions are added when not having the constexpr specifier.
  */
 template<typename TYPE>
-constexpr void setRegisterBits(volatile TYPE& registerRef, TYPE bitSelection) noexcept {
+constexpr void setRegisterBits(volatile RegisterType<TYPE>& registerRef, TYPE bitSelection) noexcept {
   registerRef |= bitSelection;
 }
 
@@ -70,7 +84,7 @@ constexpr void setRegisterBits(volatile TYPE& registerRef, TYPE bitSelection) no
  * For info on template or constexpr specifier, check the documentation of setRegister
  */
 template<typename TYPE>
-constexpr void resetRegisterBits(volatile TYPE& registerRef, TYPE bitSelection) noexcept {
+constexpr void resetRegisterBits(volatile RegisterType<TYPE>& registerRef, TYPE bitSelection) noexcept {
   registerRef &= ~bitSelection;
 }
 
@@ -87,7 +101,7 @@ constexpr void resetRegisterBits(volatile TYPE& registerRef, TYPE bitSelection)
  * For info on template or constexpr specifier, check the documentation of setRegister
  */
 template<typename TYPE>
-constexpr void toggleRegisterBits(volatile TYPE& registerRef, TYPE bitSelection) noexcept {
+constexpr void toggleRegisterBits(volatile RegisterType<TYPE>& registerRef, TYPE bitSelection) noexcept {
   registerRef ^= bitSelection;
 }
 
@@ -104,8 +118,43 @@ constexpr void toggleRegisterBits(volatile TYPE& registerRef, TYPE bitSelection)
  * For info on template or constexpr specifier, check the documentation of setRegister
  */
 template<typename TYPE>
-constexpr TYPE getRegisterBits(volatile TYPE& registerRef, TYPE bitSelection, TYPE shiftsRight) noexcept {
+constexpr TYPE getRegisterBits(volatile RegisterType<TYPE>& registerRef, TYPE bitSelection, TYPE shiftsRight) noexcept {
   return (registerRef & bitSelection) >> shiftsRight;
 }
 
+namespace Microtech {
+
+/**
+ * Storage of the only instance of a singleton, like the Serial or the Adc.
+ *
+ * A function-local static is constructed by the first call, so every call, also from an interruption, checks a
+ * guard variable first. The static member of a template can be defined in the header instead, and since the
+ * singletons have constexpr constructors, the instance is constant initialized like any other global. getInstance
+ * is then only the address of the instance, known by the linker.
+ * @tparam SINGLETON Class of the singleton. With a private constructor, it has to be a friend of the class.
+ */
+template<class SINGLETON>
+struct SingletonInstance {
+  static SINGLETON instance;  ///< The instance, initialized before main
+};
+
+template<class SINGLETON>
+SINGLETON SingletonInstance<SINGLETON>::instance;
+
+/**
+ * Updates a CRC-8 with the polynomial 0x07, like the frames of the ScopeStream and the FlashLogger.
+ * The CRC is calculated bit by bit, which saves the 256 bytes of a table.
+ * @param crc CRC of the previous bytes, 0 before the first one
+ * @param byte Next byte
+ * @return The CRC including the byte
+ */
+constexpr uint8_t crc8Update(uint8_t crc, const uint8_t byte) noexcept {
+  crc ^= byte;
+  for (uint8_t i = 0; i < 8; i++) {
+    crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+  }
+  return crc;
+}
+}  // namespace Microtech
+
 #endif  // MICROTECH_HELPERS_HPP
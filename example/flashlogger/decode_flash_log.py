@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""Decodes and plots the dump of the segments of common/FlashLogger.hpp.
+
+The frame format is documented in common/FlashLogger.hpp.
+
+Usage:
+    decode_flash_log.py /dev/ttyACM0        Reads from the serial port (needs pyserial), 9600 baud
+    decode_flash_log.py dump.bin            Reads a file with the raw bytes of the dump
+    decode_flash_log.py dump.bin --csv      Prints time and sample instead of plotting them
+"""
+import argparse
+import sys
+
+SYNC = b"\xA5\xC3"
+HEADER_WORDS = 8  # magic, sequence, first sample (2), sample rate, dropped blocks, overwritten blocks, reserved
+MAGIC = 0x4C47
+NOT_CLOSED = 0xFFFF
+
+
+def crc8(data):
+    """CRC-8 with polynomial 0x07, calculated bit by bit as in the firmware."""
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def words(data):
+    return [data[index] | (data[index + 1] << 8) for index in range(0, len(data), 2)]
+
+
+class Segment:
+    def __init__(self, sequence, first_sample, sample_rate, dropped_blocks, overwritten_blocks, samples):
+        self.sequence = sequence
+        self.first_sample = first_sample
+        self.sample_rate = sample_rate
+        self.dropped_blocks = dropped_blocks  # None if the capture stopped before the segment was closed
+        self.overwritten_blocks = overwritten_blocks  # None like the dropped blocks
+        self.samples = samples
+
+
+def parse_frame(buffer):
+    """Parses the frame at the beginning of the buffer.
+
+    Returns (segment, consumed bytes), (None, consumed bytes) for a corrupted frame,
+    or (None, 0) if the buffer doesn't have the whole frame yet.
+    """
+    header_size = 2 * (HEADER_WORDS + 1)
+    if len(buffer) < len(SYNC) + header_size:
+        return None, 0
+    header = words(buffer[len(SYNC):len(SYNC) + header_size])
+    if header[0] != MAGIC:
+        return None, 1
+    number_of_samples = header[HEADER_WORDS]
+    frame_size = len(SYNC) + header_size + 2 * number_of_samples + 1
+    if len(buffer) < frame_size:
+        return None, 0
+
+    if crc8(buffer[len(SYNC):frame_size - 1]) != buffer[frame_size - 1]:
+        # Only skips the sync, since it may have been a sample that looked like a sync.
+        return None, 1
+
+    samples = words(buffer[len(SYNC) + header_size:frame_size - 1])
+    dropped_blocks = None if header[5] == NOT_CLOSED else header[5]
+    overwritten_blocks = None if header[6] == NOT_CLOSED else header[6]
+    segment = Segment(header[1], header[2] | (header[3] << 16), header[4], dropped_blocks, overwritten_blocks, samples)
+    return segment, frame_size
+
+
+def decode(stream):
+    """Yields the valid segments of a byte stream, skipping anything that is not a frame."""
+    buffer = bytearray()
+    for chunk in stream:
+        buffer += chunk
+        while True:
+            start = buffer.find(SYNC)
+            if start < 0:
+                del buffer[:-1]  # The last byte may be the beginning of a sync
+                break
+            del buffer[:start]
+            segment, consumed = parse_frame(bytes(buffer))
+            if consumed == 0:
+                break
+            del buffer[:consumed]
+            if segment is not None:
+                yield segment
+
+
+def read_source(source, baud):
+    if source.startswith("/dev/") or source.upper().startswith("COM"):
+        import serial  # pyserial
+
+        port = serial.Serial(source, baud, timeout=5)
+        while True:
+            chunk = port.read(port.in_waiting or 1)
+            if not chunk:
+                return  # The dump is over when the port stays silent
+            yield chunk
+    else:
+        with open(source, "rb") as file:
+            while True:
+                chunk = file.read(4096)
+                if not chunk:
+                    return
+                yield chunk
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", help="serial port or file with the dump")
+    parser.add_argument("--baud", type=int, default=9600)
+    parser.add_argument("--csv", action="store_true", help="print the samples instead of plotting them")
+    arguments = parser.parse_args()
+
+    time = []
+    samples = []
+    # The firmware already sends the segments from the oldest one
+    for segment in decode(read_source(arguments.source, arguments.baud)):
+        if segment.dropped_blocks:
+            print("Segment %d: %d blocks dropped, its times are not exact" % (segment.sequence, segment.dropped_blocks),
+                  file=sys.stderr)
+        if segment.overwritten_blocks:
+            print("Segment %d: %d blocks were overwritten while they were written, some samples may be of later blocks"
+                  % (segment.sequence, segment.overwritten_blocks), file=sys.stderr)
+        rate = segment.sample_rate or 1
+        for index, sample in enumerate(segment.samples):
+            time.append((segment.first_sample + index) / rate)
+            samples.append(sample)
+            if arguments.csv:
+                print("%.6f,%d" % (time[-1], sample))
+
+    if arguments.csv:
+        return 0
+    if not samples:
+        print("No valid segment found", file=sys.stderr)
+        return 1
+
+    import matplotlib.pyplot as plt
+
+    plt.plot(time, samples)
+    plt.xlabel("Time [s]")
+    plt.ylabel("ADC value")
+    plt.ylim(0, 1023)
+    plt.show()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Decodes and plots the binary oscilloscope stream of common/ScopeStream.hpp.
+
+The frame format is documented in common/ScopeStream.hpp.
+
+Usage:
+    decode_scope_stream.py /dev/ttyACM0        Reads from the serial port (needs pyserial), 9600 baud
+    decode_scope_stream.py capture.bin         Reads a file with the raw bytes of the stream
+    decode_scope_stream.py capture.bin --csv   Prints the samples instead of plotting them
+"""
+import argparse
+import sys
+
+SYNC = b"\xA5\x5A"
+HEADER_SIZE = 6  # flags, channel mask, sample rate (2), samples per frame, bit width
+SAMPLE_BITS = 10
+FLAG_DELTA = 0x01
+FLAG_MIN_MAX = 0x02
+FLAG_TRIGGER = 0x04
+
+
+def crc8(data):
+    """CRC-8 with polynomial 0x07, calculated bit by bit as in the firmware."""
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def unpack_bits(payload, widths):
+    """Unpacks values packed starting from the least significant bit of each byte."""
+    value = int.from_bytes(payload, "little")
+    values = []
+    for width in widths:
+        values.append(value & ((1 << width) - 1))
+        value >>= width
+    return values
+
+
+def zigzag_decode(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+class Frame:
+    def __init__(self, channels, sample_rate, samples, decimation, trigger_index):
+        self.channels = channels
+        self.sample_rate = sample_rate
+        self.samples = samples  # one list of samples for each channel
+        self.decimation = decimation  # samples reduced to each minimum and maximum pair, 1 for plain samples
+        self.trigger_index = trigger_index  # index of the trigger in the frame, or None
+
+
+def parse_frame(buffer):
+    """Parses the frame at the beginning of the buffer.
+
+    Returns (frame, consumed bytes), (None, consumed bytes) for a corrupted frame,
+    or (None, 0) if the buffer doesn't have the whole frame yet.
+    """
+    if len(buffer) < len(SYNC) + HEADER_SIZE:
+        return None, 0
+    header = buffer[len(SYNC):len(SYNC) + HEADER_SIZE]
+    flags, channel_mask = header[0], header[1]
+    sample_rate = header[2] | (header[3] << 8)
+    samples_per_frame, bit_width = header[4], header[5]
+    channels = [channel for channel in range(8) if channel_mask & (1 << channel)]
+    if not channels or samples_per_frame == 0 or not 1 <= bit_width <= SAMPLE_BITS:
+        return None, 1
+
+    delta = bool(flags & FLAG_DELTA)
+    options_size = bool(flags & FLAG_MIN_MAX) + bool(flags & FLAG_TRIGGER)
+    payload_start = len(SYNC) + HEADER_SIZE + options_size
+    if len(buffer) < payload_start:
+        return None, 0
+    options = list(buffer[len(SYNC) + HEADER_SIZE:payload_start])
+    decimation = options.pop(0) if flags & FLAG_MIN_MAX else 1
+    trigger_index = options.pop(0) if flags & FLAG_TRIGGER else None
+    if decimation == 0 or (trigger_index is not None and trigger_index >= samples_per_frame):
+        return None, 1
+
+    widths = []
+    for sample_index in range(samples_per_frame):
+        width = bit_width if (delta and sample_index > 0) else SAMPLE_BITS
+        widths += [width] * len(channels)
+    payload_size = (sum(widths) + 7) // 8
+    frame_size = payload_start + payload_size + 1
+    if len(buffer) < frame_size:
+        return None, 0
+
+    payload = buffer[payload_start:frame_size - 1]
+    if crc8(buffer[len(SYNC):frame_size - 1]) != buffer[frame_size - 1]:
+        # Only skips the sync, since it may have been a sample that looked like a sync.
+        return None, 1
+
+    values = unpack_bits(payload, widths)
+    samples = [[] for _ in channels]
+    for index, value in enumerate(values):
+        channel = index % len(channels)
+        if delta and index >= len(channels):
+            value = samples[channel][-1] + zigzag_decode(value)
+        samples[channel].append(value)
+    return Frame(channels, sample_rate, samples, decimation, trigger_index), frame_size
+
+
+def decode(stream):
+    """Yields the valid frames of a byte stream, skipping anything that is not a frame."""
+    buffer = bytearray()
+    for chunk in stream:
+        buffer += chunk
+        while True:
+            start = buffer.find(SYNC)
+            if start < 0:
+                del buffer[:-1]  # The last byte may be the beginning of a sync
+                break
+            del buffer[:start]
+            frame, consumed = parse_frame(bytes(buffer))
+            if consumed == 0:
+                break
+            del buffer[:consumed]
+            if frame is not None:
+                yield frame
+
+
+def read_source(source, baud):
+    if source.startswith("/dev/") or source.upper().startswith("COM"):
+        import serial  # pyserial
+
+        port = serial.Serial(source, baud, timeout=1)
+        while True:
+            yield port.read(port.in_waiting or 1)
+    else:
+        with open(source, "rb") as file:
+            while True:
+                chunk = file.read(4096)
+                if not chunk:
+                    return
+                yield chunk
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", help="serial port or file with the stream")
+    parser.add_argument("--baud", type=int, default=9600)
+    parser.add_argument("--csv", action="store_true", help="print the samples instead of plotting them")
+    arguments = parser.parse_args()
+
+    channels = {}  # times in sample periods and samples of each channel
+    next_times = {}
+    triggers = []
+    sample_rate = 0
+    for frame in decode(read_source(arguments.source, arguments.baud)):
+        sample_rate = frame.sample_rate
+        # A minimum and maximum pair covers the periods of all its samples, so each of them takes half of it.
+        step = frame.decimation / 2 if frame.decimation > 1 else 1
+        for channel, samples in zip(frame.channels, frame.samples):
+            times, values = channels.setdefault(channel, ([], []))
+            start = next_times.get(channel, 0)
+            next_times[channel] = start + len(samples) * step
+            for index, sample in enumerate(samples):
+                time = start + index * step
+                if index == frame.trigger_index:
+                    triggers.append(time)
+                times.append(time)
+                values.append(sample)
+                if arguments.csv:
+                    print("A%d,%g,%d%s" % (channel, time, sample, ",T" if index == frame.trigger_index else ""))
+
+    if arguments.csv:
+        return 0
+    if not channels:
+        print("No valid frame found", file=sys.stderr)
+        return 1
+
+    import matplotlib.pyplot as plt
+
+    scale = 1 / sample_rate if sample_rate else 1
+    for channel, (times, values) in sorted(channels.items()):
+        plt.plot([time * scale for time in times], values, label="A%d" % channel)
+    for time in triggers:
+        plt.axvline(time * scale, color="red", linestyle="--")
+    plt.xlabel("Time [s]" if sample_rate else "Sample")
+    plt.ylabel("ADC value")
+    plt.ylim(0, 1023)
+    plt.legend()
+    plt.show()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -18,11 +18,11 @@ int main() {
   for(int i=0; i<n; ++i) {
     if(i == 2250 && !freqUpdated) {
       freqUpdated = true;
-      signalGenerator.setNewFrequency(2);
+      signalGenerator.setNewFrequency(_IQ15(2));
       signalGenerator.nextSignalShape();
     }
     x.at(i) = i;
-    y.at(i) = signalGenerator.getNextDatapoint();
+    y.at(i) = _IQ15toF(signalGenerator.getNextDatapoint());
   }
 
   // Set the size of output image to 1200x780 pixels
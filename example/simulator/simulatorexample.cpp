@@ -0,0 +1,266 @@
+/******************************************************************************
+ * @file                    simulatorexample.cpp
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Replays an application like exercise8 in the simulator of the mock
+ *
+ * Description: The application has the same interruptions as exercise8: the
+ *              DacStream latches the samples of the signal generator at the
+ *              period of the 4kHz PWM of Timer0, a 20ms task of Timer1 samples
+ *              the oscilloscope, the ADC10 converts continuously, the Serial
+ *              prints every sample, commands arrive over the serial port and the
+ *              buttons of Port 1 are debounced in the main loop.
+ *
+ *              The replay scripts the inputs: DAC_OUT is connected to the channel
+ *              A0 like on the board, so the ADC10 converts the duty cycle of the
+ *              PWM as if it was filtered, a few commands are received, and PB6
+ *              is pressed once. At the end, the execution time of each
+ *              interruption is printed, which is the worst case that has to fit
+ *              in the period of the fastest one.
+ ******************************************************************************/
+#define MICROTECH_PORT1_INTERRUPTS
+#define MICROTECH_SERIAL_RX
+#include "Adc.hpp"
+#include "Button.hpp"
+#include "DacStream.hpp"
+#include "Debouncer.hpp"
+#include "EventQueue.hpp"
+#include "GPIOs.hpp"
+#include "Pwm.hpp"
+#include "Serial.hpp"
+#include "SerialReceiver.hpp"
+#include "ShiftRegister.hpp"
+#include "SignalGenerator.hpp"
+#include "Timer.hpp"
+
+#include "simulator.h"
+#include <cstdio>
+
+using namespace Microtech;
+
+namespace {
+
+constexpr uint64_t SIMULATION_CYCLES = 2000000;  ///< 2s at 1MHz
+constexpr uint64_t PRESS_CYCLE = 1200000;        ///< When PB6 is pressed
+constexpr uint64_t RELEASE_CYCLE = 1400000;      ///< When PB6 is released
+constexpr uint8_t PB6_BIT = BIT6;
+
+// Commands received from the start of the simulation, one character per ms at 9600 baud. X is unknown, so it is
+// answered with ERR.
+const char SERIAL_COMMANDS_INPUT[] = "F 2.5\nS TRA\nA 50\nX\n";
+
+}  // namespace
+
+// The application, like exercise8
+Button btnDecreaseAmplitude(GPIOs::getInputHandle<IOPort::PORT_1, static_cast<uint8_t>(5)>(), true);
+Button btnIncreaseAmplitude(GPIOs::getInputHandle<IOPort::PORT_1, static_cast<uint8_t>(6)>(), true);
+AdcHandle adcCH1 = Adc::getInstance().getAdcHandle<0>();
+EventQueue<8> eventQueue;
+
+constexpr uint16_t PWM_FREQUENCY_HZ = 4000;
+constexpr uint8_t PWM_PERIODS_PER_SAMPLE = 8;
+SignalGenerator signalGenerator(PWM_FREQUENCY_HZ / PWM_PERIODS_PER_SAMPLE);
+Pwm DAC_IN(GPIOs::getOutputHandle<IOPort::PORT_3, static_cast<uint8_t>(6)>());
+DacStream<32> dacStream(DAC_IN, PWM_PERIODS_PER_SAMPLE);
+
+constexpr ShiftRegisterPB pb1to4(GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(4)>(),
+                                 GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(5)>(),
+                                 GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(2)>(),
+                                 GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(3)>(),
+                                 GPIOs::getInputHandle<IOPort::PORT_2, static_cast<uint8_t>(7)>());
+PBScanner<ShiftRegisterPB> pbScanner(pb1to4, 8);
+
+/**
+ * @brief Prints the oscilloscope sample and debounces the buttons, deferred from the timer interruption
+ * @param scopeSample The oscilloscope sample read in the timer interruption
+ */
+void processUserInterface(uint16_t scopeSample) {
+  Serial::getInstance().printInt(scopeSample);
+  Serial::getInstance().println();
+
+  const uint8_t pressedPBs = pbScanner.tick().pressed;
+  if (pressedPBs & (0x01)) {
+    signalGenerator.previousSignalShape();
+  } else if (pressedPBs & (0x01 << 1)) {
+    signalGenerator.nextSignalShape();
+  }
+
+  btnDecreaseAmplitude.evaluateDebounce();
+  btnIncreaseAmplitude.evaluateDebounce();
+}
+
+bool setFrequencyCommand(SerialReceiver::Arguments& arguments) {
+  _iq15 frequency;
+  if (!arguments.readFixedPoint(frequency)) {
+    return false;
+  }
+  signalGenerator.setNewFrequency(frequency);
+  return true;
+}
+
+bool setShapeCommand(SerialReceiver::Arguments& arguments) {
+  if (arguments.readWord("SIN")) {
+    signalGenerator.setActiveSignalShape(SignalGenerator::Shape::SINUSOIDAL);
+  } else if (arguments.readWord("TRA")) {
+    signalGenerator.setActiveSignalShape(SignalGenerator::Shape::TRAPEZOIDAL);
+  } else if (arguments.readWord("REC")) {
+    signalGenerator.setActiveSignalShape(SignalGenerator::Shape::RECTANGULAR);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool setAmplitudeCommand(SerialReceiver::Arguments& arguments) {
+  _iq15 amplitude;
+  if (!arguments.readFixedPoint(amplitude)) {
+    return false;
+  }
+  signalGenerator.setAmplitude(amplitude);
+  return true;
+}
+
+// Commands received over the serial port, like in exercise8
+const SerialCommand SERIAL_COMMANDS[] = {
+    {"F", &setFrequencyCommand},
+    {"S", &setShapeCommand},
+    {"A", &setAmplitudeCommand},
+};
+
+/**
+ * @brief 20ms task of Timer1, which only samples the oscilloscope
+ */
+void timerInterrupt() {
+  eventQueue.post<&processUserInterface>(adcCH1.getRawValue());
+}
+
+void increaseAmplitudeCallback(ButtonState /*buttonState*/) {
+  signalGenerator.increaseAmplitude();
+}
+
+void decreaseAmplitudeCallback(ButtonState /*buttonState*/) {
+  signalGenerator.decreaseAmplitude();
+}
+
+// The button callbacks are deferred to the main loop
+void decreaseAmplitudePinChanged() {
+  eventQueue.post<Debouncer<Button>, &Debouncer<Button>::pinStateChanged>(btnDecreaseAmplitude.getDebouncer());
+}
+
+void increaseAmplitudePinChanged() {
+  eventQueue.post<Debouncer<Button>, &Debouncer<Button>::pinStateChanged>(btnIncreaseAmplitude.getDebouncer());
+}
+
+// Port 1 interruption table: P1.5 decreases and P1.6 increases the amplitude
+template<>
+const PinInterruptHandler PortInterrupts<IOPort::PORT_1>::HANDLERS[8] = {
+    {}, {}, {}, {}, {}, makePinInterruptHandler<&decreaseAmplitudePinChanged>(),
+    makePinInterruptHandler<&increaseAmplitudePinChanged>(), {}};
+
+namespace {
+
+/**
+ * DAC_OUT filters the PWM, so the oscilloscope converts its duty cycle
+ */
+uint16_t filteredPwm(void* /*context*/, uint8_t channel, uint64_t /*cycle*/) {
+  if ((channel != 0) || (TA0CCR0.value == 0)) {
+    return 0;
+  }
+  return static_cast<uint16_t>(static_cast<uint32_t>(TA0CCR2.value) * 1023 / TA0CCR0.value);
+}
+
+/**
+ * Prints the answers to the commands. The samples of the oscilloscope are only counted.
+ */
+void serialOutput(void* /*context*/, char character) {
+  static char line[16];
+  static uint8_t length = 0;
+  static uint32_t printedSamples = 0;
+  if (character != '\n') {
+    if (length < sizeof(line) - 1) {
+      line[length++] = character;
+    }
+    return;
+  }
+  line[length] = '\0';
+  length = 0;
+  if ((line[0] >= '0') && (line[0] <= '9')) {
+    printedSamples++;
+    return;
+  }
+  std::printf("%8.1f ms  serial: %s (after %lu samples)\n",
+              static_cast<double>(Mock::Simulator::getInstance().getCycle()) / 1000.0, line,
+              static_cast<unsigned long>(printedSamples));
+}
+
+/**
+ * Presses and releases PB6, which is active low, at the scripted cycles
+ */
+void scriptButton() {
+  static bool pressed = false;
+  static bool released = false;
+  const uint64_t cycle = Mock::Simulator::getInstance().getCycle();
+  if (!pressed && (cycle >= PRESS_CYCLE)) {
+    pressed = true;
+    P1IN.value &= static_cast<uint8_t>(~PB6_BIT);
+  } else if (pressed && !released && (cycle >= RELEASE_CYCLE)) {
+    released = true;
+    P1IN.value |= PB6_BIT;
+  } else {
+    return;
+  }
+  P1IFG.value |= PB6_BIT;
+  Mock::Simulator::getInstance().raiseInterrupt(PORT1_VECTOR);
+}
+
+}  // namespace
+
+int main() {
+  Mock::Simulator& simulator = Mock::Simulator::getInstance();
+  simulator.attachInterrupt(TIMER0_A0_VECTOR, &Timer_A_CCR0_ISR);
+  simulator.attachInterrupt(TIMER1_A0_VECTOR, &Timer1_A_CCR0_ISR);
+  simulator.attachInterrupt(ADC10_VECTOR, &ADC10_ISR);
+  simulator.attachInterrupt(PORT1_VECTOR, &PORT1_ISR);
+  simulator.attachInterrupt(USCIAB0TX_VECTOR, &USCIAB0TX_ISR);
+  simulator.attachInterrupt(USCIAB0RX_VECTOR, &USCIAB0RX_ISR);
+  simulator.setAdcInput(&filteredPwm, nullptr);
+  simulator.setSerialInput(SERIAL_COMMANDS_INPUT);
+  simulator.setSerialOutput(&serialOutput, nullptr);
+  P1IN.value |= PB6_BIT;  // Released, the pull-up keeps it high
+
+  // The initialization of exercise8
+  btnDecreaseAmplitude.init();
+  btnDecreaseAmplitude.registerPressedStateChangeCallback(&decreaseAmplitudeCallback);
+  btnIncreaseAmplitude.init();
+  btnIncreaseAmplitude.registerPressedStateChangeCallback(&increaseAmplitudeCallback);
+  pb1to4.init();
+  DAC_IN.init();
+  DAC_IN.setPwmPeriod<1000000 / PWM_FREQUENCY_HZ, std::chrono::microseconds>();
+  Adc::getInstance().init();
+  Adc::getInstance().startConversion();
+  dacStream.fill(signalGenerator);
+  dacStream.start();
+  SerialReceiver::getInstance().init();
+  constexpr SmclkTimerConfig<> TIMER_CONFIG;
+  Timer<1>::getTimer().init(TIMER_CONFIG);
+  TaskHandler<20, std::chrono::milliseconds> timerTask(&timerInterrupt, true);
+  Timer<1>::getTimer().registerTask(TIMER_CONFIG, timerTask);
+
+  simulator.setSimulationLength(SIMULATION_CYCLES);
+  while (!simulator.isFinished()) {
+    scriptButton();
+    dacStream.fill(signalGenerator);
+    eventQueue.process();
+    SerialReceiver::getInstance().process(SERIAL_COMMANDS);
+    idle(ClockRequirement::SMCLK);
+  }
+
+  std::printf("\n");
+  simulator.printReport();
+  std::printf("DAC underruns: %u, dropped characters: %u, dropped command lines: %u\n", dacStream.getUnderruns(),
+              Serial::getInstance().getDroppedCharacters(), SerialReceiver::getInstance().getDroppedLines());
+  return 0;
+}
@@ -51,7 +51,7 @@
  * @param bitSelection Is the pins of the port that you want to set as an output. So if you want to set pin 4 as an output, then the bitSelection would be 0x10.
  *                     For pin 4 and 1, it would be 0x12.
  */
-constexpr void setIOsAsOutput(volatile uint8_t& PxDir, volatile uint8_t& PxSel, volatile uint8_t& PxSel2, uint8_t bitSelection) noexcept {
+constexpr void setIOsAsOutput(volatile RegisterType<uint8_t>& PxDir, volatile RegisterType<uint8_t>& PxSel, volatile RegisterType<uint8_t>& PxSel2, uint8_t bitSelection) noexcept {
     setRegisterBits(PxDir, bitSelection);
     resetRegisterBits(PxSel, bitSelection);
     resetRegisterBits(PxSel2, bitSelection);
@@ -84,7 +84,8 @@ uint8_t idOfColorToPrint = 20;
 uint16_t printLdrVal = 0;
 
 static AdcHandle potentiometer = Adc::getInstance().getAdcHandle<7>(); // Statically creates the handle that reads from the ADC, input 7
-static AdcHandle ldr = Adc::getInstance().getAdcHandle<4>(); // Statically creates the handle that reads from the ADC, input 4
+// Statically creates the handle that reads from the ADC, input 4. It is filtered with a moving average of 32 samples.
+static FilteredAdcHandle<SimpleMovingAverage<32>> ldr(Adc::getInstance().getAdcHandle<4>());
 /**
  * Function that evaluates the potentiometer ADC values and set the turn on the appropriate LEDs.
  */
@@ -126,7 +127,7 @@ void evaluateLDR() {
   // so we can filter for the settling time of the LDR.
   static uint8_t lastColorId = 99;  // Just initialize to some random number different than 0
 
-  // Get the filtered value of the LDR. A Moving average over the last 30 samples.
+  // Get the filtered value of the LDR. A Moving average over the last 32 samples, updated by the ADC interruption.
   const uint16_t ldrValue = ldr.getFilteredValue();
   uint8_t colorId = 0;  // Variable used to loop through the color table
 
@@ -175,6 +176,7 @@ int main() {
   initMSP();
 
   Timer0::getTimer().init();
+  Adc::getInstance().registerFilteredHandle(ldr);
   Adc::getInstance().init();
   shiftRegisterLEDs.init();
 
@@ -357,7 +357,7 @@ int main() {
  __enable_interrupt();
 
  while (true) {
-   _no_operation();
+   idle();  // Sleeps until the next interruption
  }
  return 0;
 }
@@ -41,17 +41,29 @@
 *
 * @note    The project was exported using CCS 12.1.0.00007
 ******************************************************************************/
+//#define WATCHDOG_TIME_5_SECONDS
+#define CONTROL_WITH_PWM
+
+// VLOCLK is 12 kHz according to datasheet, page 276. It is routed to ACLK.
+#define MICROTECH_ACLK_SOURCE_VLO
+#ifdef WATCHDOG_TIME_5_SECONDS
+#define MICROTECH_ACLK_DIVIDER 2
+#else
+#define MICROTECH_ACLK_DIVIDER 8
+#endif
+
 #include <templateEMP.h>
 
 #include "Button.hpp"
+#include "ClockSystem.hpp"
+#include "Controller.hpp"
 #include "GPIOs.hpp"
 #include "Adc.hpp"
+#include "NtcTable.hpp"
 #include "ShiftRegister.hpp"
 #include "Timer.hpp"
 #include "Pwm.hpp"
-
-//#define WATCHDOG_TIME_5_SECONDS
-#define CONTROL_WITH_PWM
+#include "Watchdog.hpp"
 
 using namespace Microtech;
 
@@ -67,6 +79,8 @@ Pwm heatingResistorPwm(
 #endif
 // NTC ADC value range: 320 - 570
 AdcHandle NTC_input = Adc::getInstance().getAdcHandle<5>();
+// Assuming a 10 kOhm NTC with beta 3435 to Vcc and a 10 kOhm resistor to ground, the range is around 6 to 31 C
+constexpr NtcTable<5> NTC_TABLE(10000.0, 3435.0, 10000.0, NtcPosition::HIGH_SIDE);
 
 // LEDs to show temperature
 ShiftRegisterLED ledD1ToD4(GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(4)>(),
@@ -81,6 +95,25 @@ bool enterInfiniteLoop = false;
 
 uint8_t currentTemperatureRange = 1;
 uint16_t currentNtcValue = 0;
+int16_t currentTemperatureDeciCelsius = 0;
+
+// The heating is on until the temperature reaches the range of LED4, as in VALUE_LED3 of displaytemperatureTaskFunc
+constexpr int16_t NTC_SETPOINT_VALUE = 320 + 3 * ((570 - 320) / 5);
+#ifdef CONTROL_WITH_PWM
+// Every 2s, as the thermometer. 50 NTC counts below the setpoint already turn the heating fully on.
+PidController<2, std::chrono::seconds> heaterController(2.0, 0.05, 0.0);
+#else
+HysteresisController heaterController(5);
+#endif
+
+void controlTaskFunc() {
+#ifndef CONTROL_WITH_PWM
+  heaterController.update(static_cast<int16_t>(currentNtcValue));
+  heatingResistorOnOffPin.setState(heaterController.isOn() ? IOState::HIGH : IOState::LOW);
+#else
+  heatingResistorPwm.setDutyCycle(heaterController.update(static_cast<int16_t>(currentNtcValue)));
+#endif
+}
 
 void displaytemperatureTaskFunc() {
     constexpr uint16_t NTC_MIN_VALUE = 320;
@@ -99,6 +132,7 @@ void displaytemperatureTaskFunc() {
         numInterrupts = 0;
         const uint16_t ntcValue = NTC_input.getRawValue();
         currentNtcValue = ntcValue;
+        currentTemperatureDeciCelsius = NTC_TABLE.getDeciCelsius(ntcValue);
 
         if(ntcValue < VALUE_LED1) {
             ledD1ToD4.writeValue(0x1);
@@ -130,15 +164,8 @@ void pb5Callback(ButtonState /*buttonState*/) {
 int main() {
  Timer<0>::getTimer().stop();   // Stops the timer first to since after registers are in undefined state after watchdog
  initMSP();
-
- // VLOCLK is 12 kHz according to datasheet, page 276.
- // Route VLOCLK to ACKL.
- BCSCTL3 |= LFXT1S_2;
-#ifdef WATCHDOG_TIME_5_SECONDS
- BCSCTL1 |= DIVA_1;  // Set ACKL divider to 2.
-#else
- BCSCTL1 |= DIVA_3;  // Set ACKL divider to 8.
-#endif
+ // ACLK = VLOCLK / MICROTECH_ACLK_DIVIDER
+ SystemClock::init();
 
  constexpr OutputHandle greenLed = GPIOs::getOutputHandle<IOPort::PORT_1, static_cast<uint8_t>(0)>();
  greenLed.init();
@@ -154,6 +181,7 @@ int main() {
 #else
  heatingResistorPwm.init();
 #endif
+ heaterController.setSetpoint(NTC_SETPOINT_VALUE);
 
  ledD1ToD4.init();
  ledD1ToD4.start();
@@ -165,22 +193,25 @@ int main() {
  Adc::getInstance().init();
  Adc::getInstance().startConversion();
 
- // Timer with CLK_DIV = 8 and since the period of SMCLK is 1us we also let the timer know that.
- constexpr TimerConfigBase<1, 1> TIMER_CONFIG(TimerClockSource::Option::SMCLK);
+ // Timer with CLK_DIV = 1 and the frequency of SMCLK from the SystemClock.
+ constexpr SmclkTimerConfig<1> TIMER_CONFIG;
  Timer<0>::getTimer().init(TIMER_CONFIG);
  // Creates a 1ms periodic task
  TaskHandler<1, std::chrono::milliseconds> displayTemperatureTask(&displaytemperatureTaskFunc, true);
- Timer<0>::getTimer().registerTask(TIMER_CONFIG, displayTemperatureTask);
+ // Creates a 2s periodic task for the heating
+ TaskHandler<2, std::chrono::seconds> controlTask(&controlTaskFunc, true);
+ Timer<0>::getTimer().registerTasks(TIMER_CONFIG, displayTemperatureTask, controlTask);
 
- // Enable watchdog
- WDTCTL = WDTPW + WDTCNTCL + WDTSSEL;
+ // Enable watchdog. 32768 clocks of ACLK, so the main loop has to report its progress at least every interval.
+ const ProgressMonitor mainLoopMonitor = Watchdog::getInstance().registerMonitor();
+ Watchdog::getInstance().startWatchdog<WatchdogClock::ACLK, WatchdogInterval::CLOCKS_32768>();
 
  // Initialize display
  displaytemperatureTaskFunc();
 
  while (true) {
    // Reset Watchdog
-   WDTCTL = WDTPW + WDTCNTCL + WDTSSEL;
+   mainLoopMonitor.reportProgress();
    while(enterInfiniteLoop) {}
 
    // Clock = 1 MHz. We want to have the LED blinking with 4Hz. It has a period of 0,25, but we need to divide it by
@@ -188,23 +219,6 @@ int main() {
    __delay_cycles(125000);
    greenLed.toggle();
 
-#ifndef CONTROL_WITH_PWM
-   if(currentTemperatureRange < 4) {
-       // Sets heating on
-       heatingResistorOnOffPin.setState(IOState::HIGH);
-   } else {
-       // Sets heating off
-       heatingResistorOnOffPin.setState(IOState::LOW);
-   }
-#else
-   if(currentTemperatureRange < 4) {
-       // Sets heating on
-       heatingResistorPwm.setDutyCycle(500);
-   } else {
-       // Sets heating off
-       heatingResistorPwm.setDutyCycle(0);
-   }
-#endif
    //serialPrint("Current NTC value: ");
    //serialPrintInt(NTC_input.getRawValue());
    //serialPrintln("");
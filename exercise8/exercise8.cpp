@@ -12,8 +12,16 @@
  *                  a minimum frequency of 0.5Hz, and a frequency step of 0.5Hz.
  *                  The amplitude of the signals can also be adjusted with an amplitude step of 0.05.
  *
+ *                  The signal is output with 500 samples per second by the PWM, see common/DacStream.hpp.
  *                  The oscilloscope prints new values every 20ms.
  *
+ *                  The signal can also be changed by commands over the serial port, each answered with OK or ERR:
+ *                    F 2.5     Frequency in Hz, from 0.5 to 5
+ *                    S TRA     Shape: SIN, TRA (trapezoidal), REC (rectangular) or ARB (arbitrary waveform)
+ *                    A 50      Amplitude in percent, from 0 to 100
+ *                    W 3 4096  Writes sample 3 (0 to 15) of the arbitrary waveform, from 0 to 65535
+ *                  The arbitrary waveform starts as a sawtooth and is interpolated between the samples.
+ *
  * Pin connections:
  *       CON3:P1.0 <-> DAC_OUT
  *       JP5 -> INT
@@ -28,12 +36,22 @@
  *
  * @note    The project was exported using CCS 12.1.0.00007
  ******************************************************************************/
+// The interruption of Port 1 is dispatched by GPIOs.hpp to the table at the end of this file
+#define MICROTECH_PORT1_INTERRUPTS
+// The receive interruption of the USCI_A0 is dispatched to the SerialReceiver
+#define MICROTECH_SERIAL_RX
 #include <templateEMP.h>
 
 #include "Adc.hpp"
 #include "Button.hpp"
+#include "DacStream.hpp"
+#include "Debouncer.hpp"
+#include "EventQueue.hpp"
 #include "GPIOs.hpp"
 #include "Pwm.hpp"
+#include "ScopeStream.hpp"
+#include "Serial.hpp"
+#include "SerialReceiver.hpp"
 #include "ShiftRegister.hpp"
 #include "SignalGenerator.hpp"
 #include "Timer.hpp"
@@ -47,76 +65,157 @@ Button btnIncreaseAmplitude(GPIOs::getInputHandle<IOPort::PORT_1, static_cast<ui
 // Oscilloscope channel
 AdcHandle adcCH1 = Adc::getInstance().getAdcHandle<0>();
 
-// Signal Generator with sampling frequency of 50Hz = every 20ms.
-SignalGenerator signalGenerator(50);
+// Uncomment to send the oscilloscope samples as binary frames instead of text (see common/ScopeStream.hpp).
+// They can be plotted with example/scopestream/decode_scope_stream.py
+// #define BINARY_SCOPE_STREAM
+#ifdef BINARY_SCOPE_STREAM
+// Channel A0 sampled at 50Hz, in frames of 16 delta encoded samples.
+ScopeStream<0x01, 16, true> scopeStream(50);
+#endif
+
+// Work deferred from the interruptions to the main loop
+EventQueue<8> eventQueue;
+
+// Each sample of the signal is output for 8 periods of the 4kHz PWM, so the signal generator has a sampling
+// frequency of 500Hz. At 1MHz, the main loop wouldn't keep up with a sample per period.
+constexpr uint16_t PWM_FREQUENCY_HZ = 4000;
+constexpr uint8_t PWM_PERIODS_PER_SAMPLE = 8;
+SignalGenerator signalGenerator(PWM_FREQUENCY_HZ / PWM_PERIODS_PER_SAMPLE);
+// Samples of the arbitrary waveform, written by the W command. It starts as a sawtooth.
+uint16_t arbitraryWaveformSamples[16] = {0,     4369,  8738,  13107, 17476, 21845, 26214, 30583,
+                                         34952, 39321, 43690, 48059, 52428, 56797, 61166, 65535};
 // Create handle of PWM for pin 6 from port 3
 Pwm DAC_IN(GPIOs::getOutputHandle<IOPort::PORT_3, static_cast<uint8_t>(6)>());
+// Samples of the signal generator, output at the period boundaries of the PWM. 32 samples are 64ms of the signal.
+DacStream<32> dacStream(DAC_IN, PWM_PERIODS_PER_SAMPLE);
 
 constexpr ShiftRegisterPB pb1to4(GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(4)>(),
                                  GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(5)>(),
                                  GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(2)>(),
                                  GPIOs::getOutputHandle<IOPort::PORT_2, static_cast<uint8_t>(3)>(),
                                  GPIOs::getInputHandle<IOPort::PORT_2, static_cast<uint8_t>(7)>());
+// Debounces PB1-4 together. It ticks every 20ms, so a PB has to be stable for 80ms. While no PB changes, the shift
+// register is only read every 160ms.
+PBScanner<ShiftRegisterPB> pbScanner(pb1to4, 8);
 
 /**
- * @brief Decreases the value of the given counter.
- * If the counter is already at 0, it will stay at 0.
- * @param[in, out] counter The counter that will be decreased.
- */
-void decreaseCounter(uint8_t &counter) {
-  if (counter > 0) {
-    counter--;
-  }
-}
-
-/**
- * @brief Interrupt service routine called by the timer
- * It will read the values of the oscilloscope and send it to the serial port
+ * @brief Processes the user interface in the main loop, deferred from the timer interruption.
+ * It will send the value of the oscilloscope to the serial port
  * It also handles the debouncing of the buttons and updates the signal generator's
  * amplitude and frequency based on user input.
+ * @param scopeSample The oscilloscope sample read in the timer interruption
  */
-void timerInterrupt() {
-  _iq15 nextDatapoint = signalGenerator.getNextDatapoint();
-  // Print values of Oscilloscope
-  serialPrintInt(adcCH1.getRawValue());
-  //serialPrint(" ");
-  //serialPrintInt(_IQ15int(nextDatapoint)); // For debugging purposes
-  serialPrintln("");
-
-  // Get the current PB values of the shift register (PB1-4)
-  uint8_t PBvalues = pb1to4.getPBValues();
-
-  static uint8_t PB1debounceCnt = 0;
-  static uint8_t PB2debounceCnt = 0;
-  static uint8_t PB3debounceCnt = 0;
-  static uint8_t PB4debounceCnt = 0;
-
-  // Check if buttons have been pressed and perform debounce
-  if (PBvalues & (0x01) && !PB1debounceCnt) {  // PB1
+void processUserInterface(uint16_t scopeSample) {
+#ifdef BINARY_SCOPE_STREAM
+  const uint16_t scopeSamples[] = {scopeSample};
+  scopeStream.addSamples(scopeSamples);
+#else
+  // Print values of Oscilloscope. It only copies the characters to the transmit buffer, so it doesn't block.
+  Serial::getInstance().printInt(scopeSample);
+  Serial::getInstance().println();
+#endif
+
+  // Debounces the PB values of the shift register (PB1-4) and gets the PBs that were just pressed
+  const uint8_t pressedPBs = pbScanner.tick().pressed;
+
+  if (pressedPBs & (0x01)) {  // PB1
     signalGenerator.previousSignalShape();
-    PB1debounceCnt = 10;                                    // Start debouncer counter
-  } else if (PBvalues & (0x01 << 1) && !PB2debounceCnt) {  // PB2
+  } else if (pressedPBs & (0x01 << 1)) {  // PB2
     signalGenerator.nextSignalShape();
-    PB2debounceCnt = 10;
   }
 
-  if (PBvalues & (0x01 << 2) && !PB3debounceCnt) {  // PB3
+  if (pressedPBs & (0x01 << 2)) {  // PB3
     signalGenerator.decreaseFrequency();
-    PB3debounceCnt = 10;
-  } else if (PBvalues & (0x01 << 3) && !PB4debounceCnt) {  // PB4
+  } else if (pressedPBs & (0x01 << 3)) {  // PB4
     signalGenerator.increaseFrequency();
-    PB4debounceCnt = 10;
   }
 
-  decreaseCounter(PB1debounceCnt);
-  decreaseCounter(PB2debounceCnt);
-  decreaseCounter(PB3debounceCnt);
-  decreaseCounter(PB4debounceCnt);
   btnDecreaseAmplitude.evaluateDebounce();
   btnIncreaseAmplitude.evaluateDebounce();
+}
+
+/**
+ * @brief Command "F <Hz>" that sets the frequency of the signal generator
+ * @param arguments Arguments of the command
+ * @return true if the frequency is within the range of the signal generator
+ */
+bool setFrequencyCommand(SerialReceiver::Arguments& arguments) {
+  _iq15 frequency;
+  if (!arguments.readFixedPoint(frequency) || (frequency < SignalGenerator::MINIMUM_FREQUENCY) ||
+      (frequency > SignalGenerator::MAXIMUM_FREQUENCY)) {
+    return false;
+  }
+  signalGenerator.setNewFrequency(frequency);
+  return true;
+}
 
-  // Update PWM output duty-cycle
-  DAC_IN.setDutyCycle(nextDatapoint);
+/**
+ * @brief Command "S <SIN|TRA|REC|ARB>" that sets the shape of the signal generator
+ * @param arguments Arguments of the command
+ * @return true if the shape is known
+ */
+bool setShapeCommand(SerialReceiver::Arguments& arguments) {
+  if (arguments.readWord("SIN")) {
+    signalGenerator.setActiveSignalShape(SignalGenerator::Shape::SINUSOIDAL);
+  } else if (arguments.readWord("TRA")) {
+    signalGenerator.setActiveSignalShape(SignalGenerator::Shape::TRAPEZOIDAL);
+  } else if (arguments.readWord("REC")) {
+    signalGenerator.setActiveSignalShape(SignalGenerator::Shape::RECTANGULAR);
+  } else if (arguments.readWord("ARB")) {
+    signalGenerator.setActiveSignalShape(SignalGenerator::Shape::ARBITRARY);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Command "A <percent>" that sets the amplitude of the signal generator
+ * @param arguments Arguments of the command
+ * @return true if the amplitude is between 0 and 100
+ */
+bool setAmplitudeCommand(SerialReceiver::Arguments& arguments) {
+  _iq15 amplitude;
+  if (!arguments.readFixedPoint(amplitude) || (amplitude < _IQ15(0.0)) || (amplitude > _IQ15(100.0))) {
+    return false;
+  }
+  signalGenerator.setAmplitude(amplitude);
+  return true;
+}
+
+/**
+ * @brief Command "W <index> <sample>" that writes a sample of the arbitrary waveform
+ * The signal generator only points to the samples, so the change is played right away.
+ * @param arguments Arguments of the command
+ * @return true if the index and the sample are valid
+ */
+bool writeWaveformCommand(SerialReceiver::Arguments& arguments) {
+  constexpr uint16_t NUM_SAMPLES = sizeof(arbitraryWaveformSamples) / sizeof(arbitraryWaveformSamples[0]);
+  _iq15 index;
+  _iq15 sample;
+  if (!arguments.readFixedPoint(index) || !arguments.readFixedPoint(sample) || (index < 0) ||
+      (index >= _IQ15(NUM_SAMPLES)) || (sample < 0)) {
+    return false;
+  }
+  // readFixedPoint limits the number to 65535, so the integer part of the sample always fits.
+  arbitraryWaveformSamples[_IQ15int(index)] = static_cast<uint16_t>(_IQ15int(sample));
+  return true;
+}
+
+// Commands received over the serial port
+const SerialCommand SERIAL_COMMANDS[] = {
+    {"F", &setFrequencyCommand},
+    {"S", &setShapeCommand},
+    {"A", &setAmplitudeCommand},
+    {"W", &writeWaveformCommand},
+};
+
+/**
+ * @brief Interrupt service routine called by the timer
+ * It only samples the oscilloscope, the rest is deferred to the main loop.
+ */
+void timerInterrupt() {
+  eventQueue.post<&processUserInterface>(adcCH1.getRawValue());
 }
 
 /**
@@ -149,37 +248,50 @@ int main() {
   pb1to4.init();
 
   DAC_IN.init();
-  DAC_IN.setPwmPeriod<250, std::chrono::microseconds>();  // 4kHz
+  DAC_IN.setPwmPeriod<1000000 / PWM_FREQUENCY_HZ, std::chrono::microseconds>();  // 4kHz
 
   Adc::getInstance().init();
   Adc::getInstance().startConversion();
 
-  // Timer with CLK_DIV = 8 and since the period of SMCLK is 1us we also let the timer know that.
-  constexpr TimerConfigBase<8, 1> TIMER_CONFIG(TimerClockSource::Option::SMCLK);
+  signalGenerator.setArbitraryWaveform(makeWaveformTable(arbitraryWaveformSamples, true));
+
+  // The stream latches every sample at the period boundary, so there are no runt pulses.
+  dacStream.fill(signalGenerator);
+  dacStream.start();
+
+  // The USCI_A0 was already configured by initMSP
+  SerialReceiver::getInstance().init();
+
+  // The timer chooses its CLK_DIV from the period of the task, and the frequency of SMCLK comes from the SystemClock.
+  constexpr SmclkTimerConfig<> TIMER_CONFIG;
   Timer<1>::getTimer().init(TIMER_CONFIG);
   // Creates a 20ms periodic task
   TaskHandler<20, std::chrono::milliseconds> timerTask(&timerInterrupt, true);
   Timer<1>::getTimer().registerTask(TIMER_CONFIG, timerTask);
 
   while (true) {
-    _no_operation();
+    // The DAC stream wakes up the main loop when half of its samples were output.
+    dacStream.fill(signalGenerator);
+    eventQueue.process();
+    SerialReceiver::getInstance().process(SERIAL_COMMANDS);
+    // Sleeps until an interruption posts new work or a command arrives. The serial communication runs with SMCLK.
+    idle(ClockRequirement::SMCLK);
   }
 
   return 0;
 }
 
-// Port 1 interrupt vector
-#pragma vector = PORT1_VECTOR
-__interrupt void Port_1_ISR(void) {
-  // Get bit 5 and 6 => 0110 0000 = 0x60
-  volatile const uint8_t pendingInterrupt = getRegisterBits(P1IFG, static_cast<uint8_t>(0x60), static_cast<uint8_t>(5));
-
-  if (pendingInterrupt > 1) {
-    btnIncreaseAmplitude.getDebouncer().pinStateChanged();
-  } else {
-    btnDecreaseAmplitude.getDebouncer().pinStateChanged();
-  }
+// The button callbacks are deferred to the main loop
+void decreaseAmplitudePinChanged() {
+  eventQueue.post<Debouncer<Button>, &Debouncer<Button>::pinStateChanged>(btnDecreaseAmplitude.getDebouncer());
+}
 
-  const uint8_t clearFlag = (pendingInterrupt << 0x05);
-  resetRegisterBits(P1IFG, clearFlag);  // clear interrupt flag
+void increaseAmplitudePinChanged() {
+  eventQueue.post<Debouncer<Button>, &Debouncer<Button>::pinStateChanged>(btnIncreaseAmplitude.getDebouncer());
 }
+
+// Port 1 interruption table: P1.5 decreases and P1.6 increases the amplitude
+template<>
+const PinInterruptHandler PortInterrupts<IOPort::PORT_1>::HANDLERS[8] = {
+    {}, {}, {}, {}, {}, makePinInterruptHandler<&decreaseAmplitudePinChanged>(),
+    makePinInterruptHandler<&increaseAmplitudePinChanged>(), {}};
@@ -1,23 +1,58 @@
 #ifndef MICROTECH_IQMATHLIB_H
 #define MICROTECH_IQMATHLIB_H
 
+/**
+ * Host implementation of the subset of the IQmath library used in common/.
+ *
+ * The values are Q15 integers, like in the library of the target, so the host builds have the same rounding,
+ * resolution and overflow of the target. The multiplication truncates and the division saturates, like
+ * _IQ15mpy and _IQ15div of the MSP430 IQmath library. _IQ15sin uses the math library of the host rounded to Q15,
+ * so it may differ by one LSB from the table of the target.
+ *
+ * Every call charges its cost in cycles to the simulator of the mock, so the functions are not constexpr, like
+ * on the target.
+ */
+
+#include "simulator.h"
 #include <cmath>
+#include <cstdint>
 
-typedef double _iq15;
-#define _IQ15(X) _iq15(X)
+typedef int32_t _iq15;
+#define _IQ15(A) ((_iq15)((A) * ((_iq15)1 << 15)))
 
-constexpr _iq15 _IQ15mpy(const _iq15 val1, const _iq15 val2) {
-  return val1 * val2;
+inline _iq15 _IQ15mpy(const _iq15 val1, const _iq15 val2) {
+  Mock::Simulator::getInstance().chargeIqOperation(Mock::IqOperation::MULTIPLICATION);
+  // The product has 30 fraction bits, so the lowest 15 are truncated. The result wraps around like on the target.
+  return static_cast<_iq15>(static_cast<uint32_t>((static_cast<int64_t>(val1) * val2) >> 15));
 }
 
-constexpr _iq15 _IQ15div(const _iq15 val1, const _iq15 val2) {
-  return val1/val2;
+inline _iq15 _IQ15div(const _iq15 val1, const _iq15 val2) {
+  Mock::Simulator::getInstance().chargeIqOperation(Mock::IqOperation::DIVISION);
+  // Results that don't fit, including the division by 0, saturate to the limit with the sign of the result.
+  if (val2 == 0) {
+    return (val1 < 0) ? INT32_MIN : INT32_MAX;
+  }
+  const int64_t quotient = (static_cast<int64_t>(val1) * (1 << 15)) / val2;
+  if (quotient > INT32_MAX) {
+    return INT32_MAX;
+  }
+  if (quotient < INT32_MIN) {
+    return INT32_MIN;
+  }
+  return static_cast<_iq15>(quotient);
 }
 
-constexpr _iq15 _IQ15sin(const _iq15 phase) {
-  return std::sin(phase);
+inline _iq15 _IQ15sin(const _iq15 phase) {
+  Mock::Simulator::getInstance().chargeIqOperation(Mock::IqOperation::SINE);
+  return static_cast<_iq15>(std::lround(std::sin(phase / 32768.0) * 32768.0));
 }
 
+constexpr int32_t _IQ15int(const _iq15 val) {
+  return val >> 15;
+}
 
+constexpr float _IQ15toF(const _iq15 val) {
+  return static_cast<float>(val) / 32768.0f;
+}
 
 #endif  // MICROTECH_IQMATHLIB_H
@@ -1,9 +1,41 @@
 #include "intrinsics.h"
+#include "simulator.h"
 
 void __enable_interrupt(void) {
-
+  Mock::Simulator::getInstance().chargeInterruptState();
 }
 
 void __no_operation(void) {
 
 }
+
+void __disable_interrupt(void) {
+  Mock::Simulator::getInstance().chargeInterruptState();
+}
+
+unsigned short __get_SR_register(void) {
+  Mock::Simulator::getInstance().chargeInterruptState();
+  return 0;
+}
+
+void __set_interrupt_state(unsigned short /*state*/) {
+  Mock::Simulator::getInstance().chargeInterruptState();
+}
+
+unsigned short __bis_SR_register(unsigned short mask) {
+  Mock::Simulator::getInstance().enterLowPowerMode(mask);
+  return 0;
+}
+
+unsigned short __bic_SR_register_on_exit(unsigned short mask) {
+  Mock::Simulator::getInstance().exitLowPowerModeOnReturn(mask);
+  return 0;
+}
+
+unsigned int __even_in_range(unsigned int val, unsigned int /*range*/) {
+  return val;
+}
+
+void __delay_cycles(unsigned long cycles) {
+  Mock::Simulator::getInstance().charge(static_cast<uint32_t>(cycles));
+}
@@ -1,8 +1,35 @@
 #include "msp430g2553.h"
+#include "simulator.h"
 #include <cstdint>
 
-#define DECLARE_8BIT_REGISTER(regName, initValue)  volatile uint8_t regName = initValue;
-#define DECLARE_16BIT_REGISTER(regName, initValue) volatile uint16_t regName = initValue;
+namespace Mock {
+
+uint32_t registerAccesses = 0;
+bool countingRegisterAccesses = true;
+
+void countRegisterAccesses(const uint8_t numberOfAccesses) noexcept {
+  if (!countingRegisterAccesses) {
+    return;
+  }
+  registerAccesses += numberOfAccesses;
+  Simulator::getInstance().chargeRegisterAccesses(numberOfAccesses);
+}
+
+ReceiveBufferRegister::operator uint8_t() const volatile noexcept {
+  const uint8_t character = Register<uint8_t>::operator uint8_t();
+  IFG2.value &= static_cast<uint8_t>(~UCA0RXIFG);  // Done by the USCI, so it is not counted
+  return character;
+}
+
+void TransmitBufferRegister::operator=(const uint8_t character) volatile noexcept {
+  Register<uint8_t>::operator=(character);
+  Simulator::getInstance().transmitSerial(static_cast<char>(character));
+}
+
+}  // namespace Mock
+
+#define DECLARE_8BIT_REGISTER(regName, initValue)  volatile Mock::Register<uint8_t> regName(initValue);
+#define DECLARE_16BIT_REGISTER(regName, initValue) volatile Mock::Register<uint16_t> regName(initValue);
 
 DECLARE_8BIT_REGISTER(P1DIR, 0)
 DECLARE_8BIT_REGISTER(P1IN, 0)
@@ -22,9 +49,30 @@ DECLARE_8BIT_REGISTER(P2SEL2, 0)
 DECLARE_8BIT_REGISTER(P2IE, 0)
 DECLARE_8BIT_REGISTER(P2IES, 0)
 DECLARE_8BIT_REGISTER(P2IFG, 0)
+DECLARE_8BIT_REGISTER(P3DIR, 0)
+DECLARE_8BIT_REGISTER(P3IN, 0)
+DECLARE_8BIT_REGISTER(P3OUT, 0)
+DECLARE_8BIT_REGISTER(P3REN, 0)
+DECLARE_8BIT_REGISTER(P3SEL, 0)
+DECLARE_8BIT_REGISTER(P3SEL2, 0)
 DECLARE_16BIT_REGISTER(TA0CCR0, 0)
+DECLARE_16BIT_REGISTER(TA0CCR1, 0)
+DECLARE_16BIT_REGISTER(TA0CCR2, 0)
 DECLARE_16BIT_REGISTER(TA0CCTL0, 0)
+DECLARE_16BIT_REGISTER(TA0CCTL1, 0)
+DECLARE_16BIT_REGISTER(TA0CCTL2, 0)
 DECLARE_16BIT_REGISTER(TA0CTL, 0)
+DECLARE_16BIT_REGISTER(TA0R, 0)
+DECLARE_16BIT_REGISTER(TA0IV, 0)
+DECLARE_16BIT_REGISTER(TA1CCR0, 0)
+DECLARE_16BIT_REGISTER(TA1CCR1, 0)
+DECLARE_16BIT_REGISTER(TA1CCR2, 0)
+DECLARE_16BIT_REGISTER(TA1CCTL0, 0)
+DECLARE_16BIT_REGISTER(TA1CCTL1, 0)
+DECLARE_16BIT_REGISTER(TA1CCTL2, 0)
+DECLARE_16BIT_REGISTER(TA1CTL, 0)
+DECLARE_16BIT_REGISTER(TA1R, 0)
+DECLARE_16BIT_REGISTER(TA1IV, 0)
 
 DECLARE_8BIT_REGISTER(ADC10AE0,0)
 DECLARE_8BIT_REGISTER(ADC10DTC0,0)
@@ -32,6 +80,52 @@ DECLARE_8BIT_REGISTER(ADC10DTC1,0)
 DECLARE_16BIT_REGISTER(ADC10CTL0,0)
 DECLARE_16BIT_REGISTER(ADC10CTL1,0)
 DECLARE_16BIT_REGISTER(ADC10MEM,0)
-DECLARE_16BIT_REGISTER(ADC10SA,0)
+// The DTC of the simulator writes to this address, so it can't be only 16 bits
+volatile Mock::Register<uintptr_t> ADC10SA(0);
+
+DECLARE_8BIT_REGISTER(IE2, 0)
+DECLARE_8BIT_REGISTER(IFG2, 0)
+DECLARE_8BIT_REGISTER(UCA0CTL0, 0)
+DECLARE_8BIT_REGISTER(UCA0CTL1, 0)
+DECLARE_8BIT_REGISTER(UCA0BR0, 0)
+DECLARE_8BIT_REGISTER(UCA0BR1, 0)
+DECLARE_8BIT_REGISTER(UCA0MCTL, 0)
+DECLARE_8BIT_REGISTER(UCA0STAT, 0)
+volatile Mock::ReceiveBufferRegister UCA0RXBUF(0);
+volatile Mock::TransmitBufferRegister UCA0TXBUF(0);
+DECLARE_8BIT_REGISTER(UCB0CTL0, 0)
+DECLARE_8BIT_REGISTER(UCB0CTL1, 0)
+DECLARE_8BIT_REGISTER(UCB0BR0, 0)
+DECLARE_8BIT_REGISTER(UCB0BR1, 0)
+DECLARE_8BIT_REGISTER(UCB0STAT, 0)
+DECLARE_8BIT_REGISTER(UCB0RXBUF, 0)
+DECLARE_8BIT_REGISTER(UCB0TXBUF, 0)
+
+DECLARE_8BIT_REGISTER(IE1, 0)
+DECLARE_8BIT_REGISTER(IFG1, 0)
+
+// The watchdog is running after the reset
+DECLARE_16BIT_REGISTER(WDTCTL, 0x6900)
+
+// The flash controller is locked after the reset
+DECLARE_16BIT_REGISTER(FCTL1, 0x9600)
+DECLARE_16BIT_REGISTER(FCTL2, 0x9642)
+DECLARE_16BIT_REGISTER(FCTL3, 0x9618)
 
+// Reset values of the basic clock system and the calibration data of a typical device
+DECLARE_8BIT_REGISTER(DCOCTL, 0x60)
+DECLARE_8BIT_REGISTER(BCSCTL1, 0x87)
+DECLARE_8BIT_REGISTER(BCSCTL2, 0)
+DECLARE_8BIT_REGISTER(BCSCTL3, 0x05)
+DECLARE_8BIT_REGISTER(CALDCO_16MHZ, 0x8E)
+DECLARE_8BIT_REGISTER(CALBC1_16MHZ, 0x8F)
+DECLARE_8BIT_REGISTER(CALDCO_12MHZ, 0x7A)
+DECLARE_8BIT_REGISTER(CALBC1_12MHZ, 0x8E)
+DECLARE_8BIT_REGISTER(CALDCO_8MHZ, 0x8B)
+DECLARE_8BIT_REGISTER(CALBC1_8MHZ, 0x8D)
+DECLARE_8BIT_REGISTER(CALDCO_1MHZ, 0xC3)
+DECLARE_8BIT_REGISTER(CALBC1_1MHZ, 0x86)
 
+DECLARE_8BIT_REGISTER(CACTL1, 0)
+DECLARE_8BIT_REGISTER(CACTL2, 0)
+DECLARE_8BIT_REGISTER(CAPD, 0)
@@ -48,6 +48,7 @@
 *
 ********************************************************************/
 #include <cstdint>
+#include "register.h"
 
 #ifdef __cplusplus
   extern "C" {
@@ -59,9 +60,11 @@
 /*----------------------------------------------------------------------------*/
 
 /* External references resolved by a device-specific linker command file */
-#define SFR_8BIT(address)   extern volatile uint8_t address
-#define SFR_16BIT(address)  extern volatile uint16_t address
-#define SFR_32BIT(address)  extern volatile uint32_t address
+/* Host only: the registers are Mock::Register, which count every access (see register.h) */
+#define SFR_8BIT(address)   extern volatile Mock::Register<uint8_t> address
+#define SFR_16BIT(address)  extern volatile Mock::Register<uint16_t> address
+#define SFR_32BIT(address)  extern volatile Mock::Register<uint32_t> address
+#define MOCK_REGISTERS
 
 
   /************************************************************
@@ -178,7 +181,7 @@
   SFR_16BIT(ADC10CTL0);                         /* ADC10 Control 0 */
   SFR_16BIT(ADC10CTL1);                         /* ADC10 Control 1 */
   SFR_16BIT(ADC10MEM);                          /* ADC10 Memory */
-  SFR_16BIT(ADC10SA);                           /* ADC10 Data Transfer Start Address */
+  extern volatile Mock::Register<uintptr_t> ADC10SA;  /* ADC10 Data Transfer Start Address (host: a whole pointer) */
 
 /* ADC10CTL0 */
 #define ADC10SC                (0x001)        /* ADC10 Start Conversion */
@@ -413,6 +416,8 @@
 
 #define ERASE                  (0x0002)       /* Enable bit for Flash segment erase */
 #define MERAS                  (0x0004)       /* Enable bit for Flash mass erase */
+#define EEI                    (0x0008)       /* Enable Erase Interrupts */
+#define EEIEX                  (0x0010)       /* Enable Emergency Interrupt Exit */
 #define WRT                    (0x0040)       /* Enable bit for Flash write */
 #define BLKWRT                 (0x0080)       /* Enable bit for Flash segment write */
 #define SEGWRT                 (0x0080)       /* old definition */ /* Enable bit for Flash segment write */
@@ -641,8 +646,8 @@
   SFR_8BIT(UCA0BR1);                            /* USCI A0 Baud Rate 1 */
   SFR_8BIT(UCA0MCTL);                           /* USCI A0 Modulation Control */
   SFR_8BIT(UCA0STAT);                           /* USCI A0 Status Register */
-  SFR_8BIT(UCA0RXBUF);                          /* USCI A0 Receive Buffer */
-  SFR_8BIT(UCA0TXBUF);                          /* USCI A0 Transmit Buffer */
+  extern volatile Mock::ReceiveBufferRegister UCA0RXBUF;  /* USCI A0 Receive Buffer */
+  extern volatile Mock::TransmitBufferRegister UCA0TXBUF;  /* USCI A0 Transmit Buffer */
   SFR_8BIT(UCA0ABCTL);                          /* USCI A0 LIN Control */
   SFR_8BIT(UCA0IRTCTL);                         /* USCI A0 IrDA Transmit Control */
   SFR_8BIT(UCA0IRRCTL);                         /* USCI A0 IrDA Receive Control */
@@ -0,0 +1,114 @@
+/******************************************************************************
+ * @file                    register.h
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Registers of the mock that count their accesses
+ *
+ * Description: On the target a register is a volatile integer at a fixed address.
+ *              In the mock it is a Mock::Register, which behaves like the integer
+ *              but counts every read and write, so the direct assignments, like
+ *              TA0CCR2 = value, are counted as well as the helpers of
+ *              common/helpers.hpp. A read-modify-write, like P1OUT |= BIT0, is two
+ *              accesses. The count is used by the benchmarks and charged by the
+ *              simulator to the running software.
+ *
+ *              The simulated peripherals use the value member directly, so their
+ *              accesses are not counted. The buffers of the USCI_A0 also tell the
+ *              simulator when they are accessed, since that changes the flags.
+ ******************************************************************************/
+#ifndef MICROTECH_MOCK_REGISTER_H
+#define MICROTECH_MOCK_REGISTER_H
+
+#include <cstdint>
+
+namespace Mock {
+
+extern uint32_t registerAccesses;      ///< Number of register accesses made by the software
+extern bool countingRegisterAccesses;  ///< If the accesses are counted, false while the peripherals are simulated
+
+/**
+ * Counts accesses to the registers and charges them to the simulator
+ * @param numberOfAccesses Number of reads and writes
+ */
+void countRegisterAccesses(uint8_t numberOfAccesses) noexcept;
+
+/**
+ * Register of the mock
+ * @tparam TYPE Integer type of the register on the target
+ */
+template<typename TYPE>
+class Register {
+public:
+  using ValueType = TYPE;
+
+  explicit constexpr Register(const TYPE resetValue) noexcept : value(resetValue) {}
+
+  // A register is a fixed location, so it can't be copied
+  Register(const Register&) = delete;
+  Register& operator=(const Register&) = delete;
+
+  operator TYPE() const volatile noexcept {
+    countRegisterAccesses(1);
+    return value;
+  }
+
+  // The assignments don't return the register, since using it would be another read
+  void operator=(const TYPE newValue) volatile noexcept {
+    countRegisterAccesses(1);
+    value = newValue;
+  }
+
+  void operator|=(const TYPE bits) volatile noexcept {
+    countRegisterAccesses(2);  // read and write
+    value |= bits;
+  }
+
+  void operator&=(const TYPE bits) volatile noexcept {
+    countRegisterAccesses(2);  // read and write
+    value &= bits;
+  }
+
+  void operator^=(const TYPE bits) volatile noexcept {
+    countRegisterAccesses(2);  // read and write
+    value ^= bits;
+  }
+
+  void operator+=(const TYPE addend) volatile noexcept {
+    countRegisterAccesses(2);  // read and write
+    value += addend;
+  }
+
+  void operator-=(const TYPE subtrahend) volatile noexcept {
+    countRegisterAccesses(2);  // read and write
+    value -= subtrahend;
+  }
+
+  volatile TYPE value;  ///< Content of the register, accessed without being counted by the simulated peripherals
+};
+
+/**
+ * UCA0RXBUF, whose read resets the receive flag of the USCI_A0, like on the target
+ */
+class ReceiveBufferRegister : public Register<uint8_t> {
+public:
+  using Register<uint8_t>::Register;
+
+  operator uint8_t() const volatile noexcept;
+};
+
+/**
+ * UCA0TXBUF, whose write starts the transmission of the character in the simulator
+ */
+class TransmitBufferRegister : public Register<uint8_t> {
+public:
+  using Register<uint8_t>::Register;
+
+  void operator=(uint8_t character) volatile noexcept;
+};
+
+}  // namespace Mock
+
+#endif  // MICROTECH_MOCK_REGISTER_H
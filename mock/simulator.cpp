@@ -0,0 +1,514 @@
+#include "simulator.h"
+#include "msp430g2553.h"
+#include <cstdio>
+
+namespace Mock {
+
+namespace {
+
+constexpr uint8_t NUMBER_OF_COMPARATORS = 3;
+
+/**
+ * Registers of a Timer_A
+ */
+struct TimerRegisters {
+  volatile uint16_t& control;
+  volatile uint16_t& counter;
+  volatile uint16_t& interruptVector;
+  volatile uint16_t* captureControls[NUMBER_OF_COMPARATORS];
+  volatile uint16_t* compares[NUMBER_OF_COMPARATORS];
+};
+
+TimerRegisters getTimerRegisters(const uint8_t timerNumber) {
+  if (timerNumber == 0) {
+    return {TA0CTL.value,
+            TA0R.value,
+            TA0IV.value,
+            {&TA0CCTL0.value, &TA0CCTL1.value, &TA0CCTL2.value},
+            {&TA0CCR0.value, &TA0CCR1.value, &TA0CCR2.value}};
+  }
+  return {TA1CTL.value,
+          TA1R.value,
+          TA1IV.value,
+          {&TA1CCTL0.value, &TA1CCTL1.value, &TA1CCTL2.value},
+          {&TA1CCR0.value, &TA1CCR1.value, &TA1CCR2.value}};
+}
+
+/**
+ * Value of TAxIV of the highest priority interruption of CCR1, CCR2 and the overflow that is pending and enabled.
+ */
+uint16_t getTimerInterruptVector(const TimerRegisters& timer) {
+  constexpr uint16_t INTERRUPT_VECTOR_VALUES[] = {TA0IV_TACCR1, TA0IV_TACCR2};
+  for (uint8_t channel = 1; channel < NUMBER_OF_COMPARATORS; channel++) {
+    const uint16_t captureControl = *timer.captureControls[channel];
+    if ((captureControl & CCIE) && (captureControl & CCIFG)) {
+      return INTERRUPT_VECTOR_VALUES[channel - 1];
+    }
+  }
+  if ((timer.control & TAIE) && (timer.control & TAIFG)) {
+    return TA0IV_TAIFG;
+  }
+  return TA0IV_NONE;
+}
+
+/**
+ * While it exists, the registers are accessed by the simulated peripherals, so the accesses are not counted and not
+ * charged to the software.
+ */
+class PeripheralAccess {
+public:
+  PeripheralAccess() noexcept : wasCounting(countingRegisterAccesses) {
+    countingRegisterAccesses = false;
+  }
+  ~PeripheralAccess() {
+    countingRegisterAccesses = wasCounting;
+  }
+  PeripheralAccess(PeripheralAccess&) = delete;
+  PeripheralAccess(PeripheralAccess&&) = delete;
+
+private:
+  const bool wasCounting;
+};
+
+constexpr const char* VECTOR_NAMES[Simulator::NUMBER_OF_VECTORS] = {
+    "TRAPINT", "", "PORT1", "PORT2", "", "ADC10", "USCIAB0TX", "USCIAB0RX",
+    "TIMER0_A1", "TIMER0_A0", "WDT", "COMPARATORA", "TIMER1_A1", "TIMER1_A0", "NMI", "RESET"};
+
+}  // namespace
+
+Simulator& Simulator::getInstance() {
+  static Simulator instance;
+  return instance;
+}
+
+void Simulator::setClockFrequencies(const uint32_t mclkHz, const uint32_t aclkHz, const uint32_t adc10oscHz) noexcept {
+  mclkFrequency = mclkHz;
+  aclkFrequency = aclkHz;
+  adc10oscFrequency = adc10oscHz;
+}
+
+void Simulator::attachInterrupt(const uint8_t vector, const InterruptHandler handler) noexcept {
+  if (vector < NUMBER_OF_VECTORS) {
+    vectorTable[vector] = handler;
+  }
+}
+
+void Simulator::raiseInterrupt(const uint8_t vector) noexcept {
+  if (vector < NUMBER_OF_VECTORS) {
+    raisedInterrupts |= static_cast<uint16_t>(1U << vector);
+  }
+}
+
+void Simulator::setSimulationLength(const uint64_t cycles) noexcept {
+  synchronize();
+  endCycle = cycle + cycles;
+  active = true;
+}
+
+void Simulator::run(const uint64_t cycles) noexcept {
+  smclkRunning = true;
+  aclkRunning = true;
+  synchronize();
+  advance(cycles, true);
+}
+
+void Simulator::enterLowPowerMode(const uint16_t statusBits) noexcept {
+  synchronize();
+  if (!(statusBits & CPUOFF) || !active) {
+    return;
+  }
+  wakeUpRequested = false;
+  while (!wakeUpRequested && cycle < endCycle) {
+    smclkRunning = !(statusBits & SCG1);
+    aclkRunning = !(statusBits & OSCOFF);
+    step();
+    // The clocks run during the interruptions, since the CPU is turned on to execute them.
+    smclkRunning = true;
+    aclkRunning = true;
+    serviceInterrupts();
+  }
+}
+
+void Simulator::exitLowPowerModeOnReturn(const uint16_t statusBits) noexcept {
+  if (inInterrupt && (statusBits & CPUOFF)) {
+    wakeUpRequested = true;
+  }
+}
+
+void Simulator::charge(const uint32_t cycles) noexcept {
+  if (inInterrupt) {
+    interruptCycles += cycles;
+  } else {
+    mainLoopCycles += cycles;
+  }
+}
+
+void Simulator::chargeIqOperation(const IqOperation operation) noexcept {
+  switch (operation) {
+    case IqOperation::MULTIPLICATION: charge(cycleCosts.iqMultiplication); break;
+    case IqOperation::DIVISION: charge(cycleCosts.iqDivision); break;
+    case IqOperation::SINE: charge(cycleCosts.iqSine); break;
+  }
+}
+
+const InterruptStatistics& Simulator::getInterruptStatistics(const uint8_t vector) const noexcept {
+  static const InterruptStatistics NO_STATISTICS{};
+  return (vector < NUMBER_OF_VECTORS) ? interruptStatistics[vector] : NO_STATISTICS;
+}
+
+void Simulator::printReport() const {
+  std::printf("Simulated %llu cycles (%.3f ms)\n", static_cast<unsigned long long>(cycle),
+              static_cast<double>(cycle) * 1000.0 / mclkFrequency);
+  std::printf("%-12s %10s %12s %12s %8s\n", "Vector", "Calls", "WCET [cyc]", "Avg [cyc]", "Load");
+  for (uint8_t vector = 0; vector < NUMBER_OF_VECTORS; vector++) {
+    const InterruptStatistics& statistics = interruptStatistics[vector];
+    if (statistics.calls == 0) {
+      continue;
+    }
+    std::printf("%-12s %10lu %12lu %12.1f %7.2f%%\n", VECTOR_NAMES[vector],
+                static_cast<unsigned long>(statistics.calls), static_cast<unsigned long>(statistics.worstCaseCycles),
+                static_cast<double>(statistics.totalCycles) / statistics.calls,
+                (cycle > 0) ? static_cast<double>(statistics.totalCycles) * 100.0 / cycle : 0.0);
+  }
+}
+
+void Simulator::reset() noexcept {
+  cycle = 0;
+  endCycle = 0;
+  active = false;
+  aclkAccumulator = 0;
+  smclkRunning = true;
+  aclkRunning = true;
+  inInterrupt = false;
+  wakeUpRequested = false;
+  interruptCycles = 0;
+  mainLoopCycles = 0;
+  timerStates = {};
+  adcState = {};
+  uartState.transmitEnd = 0;
+  uartState.nextReception = 0;
+  raisedInterrupts = 0;
+  interruptStatistics = {};
+}
+
+void Simulator::advance(const uint64_t cycles, const bool servicing) noexcept {
+  // The interruptions also advance the clock, so their execution time is part of the cycles.
+  const uint64_t end = cycle + cycles;
+  while (cycle < end) {
+    step();
+    if (servicing) {
+      serviceInterrupts();
+    }
+  }
+}
+
+void Simulator::step() noexcept {
+  const PeripheralAccess peripheralAccess;
+  cycle++;
+  bool aclkEdge = false;
+  if (aclkRunning) {
+    aclkAccumulator += aclkFrequency;
+    if (aclkAccumulator >= mclkFrequency) {
+      aclkAccumulator -= mclkFrequency;
+      aclkEdge = true;
+    }
+  }
+  for (uint8_t timerNumber = 0; timerNumber < timerStates.size(); timerNumber++) {
+    const uint16_t source = getTimerRegisters(timerNumber).control & TASSEL_3;
+    if ((source == TASSEL_2 && smclkRunning) || (source == TASSEL_1 && aclkEdge)) {
+      countTimer(timerNumber);
+    }
+  }
+  stepAdc();
+  stepUart();
+}
+
+void Simulator::countTimer(const uint8_t timerNumber) noexcept {
+  const TimerRegisters timer = getTimerRegisters(timerNumber);
+  TimerState& state = timerStates[timerNumber];
+  if (timer.control & TACLR) {
+    timer.control &= ~TACLR;
+    timer.counter = 0;
+    state = {};
+  }
+  const uint16_t mode = timer.control & MC_3;
+  const uint16_t top = *timer.compares[0];
+  if (mode == MC_0 || (mode != MC_2 && top == 0)) {
+    return;  // In the modes up and up/down, the timer doesn't count when CCR0 is 0
+  }
+  const uint32_t inputDivider = 1U << ((timer.control & ID_3) / ID_1);
+  if (++state.dividerCount < inputDivider) {
+    return;
+  }
+  state.dividerCount = 0;
+
+  switch (mode) {
+    case MC_1:
+      if (timer.counter >= top) {
+        timer.counter = 0;
+        timer.control |= TAIFG;
+      } else {
+        timer.counter++;
+      }
+      break;
+    case MC_2:
+      timer.counter++;
+      if (timer.counter == 0) {
+        timer.control |= TAIFG;
+      }
+      break;
+    default:  // Up/down
+      if (state.countingDown) {
+        timer.counter--;
+        if (timer.counter == 0) {
+          state.countingDown = false;
+          timer.control |= TAIFG;
+        }
+      } else {
+        timer.counter++;
+        if (timer.counter >= top) {
+          state.countingDown = true;
+        }
+      }
+      break;
+  }
+
+  for (uint8_t channel = 0; channel < NUMBER_OF_COMPARATORS; channel++) {
+    if (!(*timer.captureControls[channel] & CAP) && timer.counter == *timer.compares[channel]) {
+      compareEvent(timerNumber, channel);
+    }
+  }
+}
+
+void Simulator::compareEvent(const uint8_t timerNumber, const uint8_t channel) noexcept {
+  const TimerRegisters timer = getTimerRegisters(timerNumber);
+  *timer.captureControls[channel] |= CCIFG;
+  if (timerNumber != 0) {
+    return;
+  }
+  // Timer0_A output 0, 1 and 2 can trigger the ADC10
+  constexpr uint16_t TRIGGERS[NUMBER_OF_COMPARATORS] = {SHS_2, SHS_1, SHS_3};
+  if ((ADC10CTL1 & SHS_3) == TRIGGERS[channel]) {
+    adcState.triggered = true;
+  }
+}
+
+void Simulator::stepAdc() noexcept {
+  if (!(ADC10CTL0 & ADC10ON) || !(ADC10CTL0 & ENC)) {
+    adcState.converting = false;
+    adcState.sequenceRunning = false;
+    adcState.triggered = false;
+    return;
+  }
+  if (adcState.converting) {
+    if (cycle >= adcState.conversionEnd) {
+      completeConversion();
+    }
+    return;
+  }
+  const bool timerTriggered = (ADC10CTL1 & SHS_3) != SHS_0;
+  bool start = false;
+  if (ADC10CTL0 & ADC10SC) {
+    ADC10CTL0 &= ~ADC10SC;  // It is reset automatically by the hardware
+    start = !timerTriggered;
+  }
+  if (timerTriggered && adcState.triggered) {
+    adcState.triggered = false;
+    start = true;
+  }
+  if (adcState.sequenceRunning && !timerTriggered && (ADC10CTL0 & MSC)) {
+    start = true;  // Multiple sample and conversion starts the next conversion right away
+  }
+  if (start) {
+    startConversion();
+  }
+}
+
+void Simulator::startConversion() noexcept {
+  if (!adcState.sequenceRunning) {
+    adcState.channel = static_cast<uint8_t>((ADC10CTL1 & INCH_15) / INCH_1);
+    adcState.sequenceRunning = true;
+  }
+  constexpr uint32_t SAMPLE_AND_HOLD_CLOCKS[] = {4, 8, 16, 64};
+  constexpr uint32_t CONVERSION_CLOCKS = 13;
+  const uint32_t sampleAndHold = SAMPLE_AND_HOLD_CLOCKS[(ADC10CTL0 & ADC10SHT_3) / ADC10SHT_1];
+  const uint32_t divider = (ADC10CTL1 & ADC10DIV_7) / ADC10DIV_1 + 1;
+  const uint32_t clockFrequency = ((ADC10CTL1 & ADC10SSEL_3) == ADC10SSEL_0)   ? adc10oscFrequency
+                                  : ((ADC10CTL1 & ADC10SSEL_3) == ADC10SSEL_1) ? aclkFrequency
+                                                                               : mclkFrequency;
+  const uint64_t adcClocks = static_cast<uint64_t>(sampleAndHold + CONVERSION_CLOCKS) * divider;
+  const uint64_t conversionCycles = (adcClocks * mclkFrequency + clockFrequency - 1) / clockFrequency;
+  adcState.conversionEnd = cycle + conversionCycles;
+  adcState.converting = true;
+}
+
+void Simulator::completeConversion() noexcept {
+  adcState.converting = false;
+  constexpr uint16_t MAX_CONVERSION_VALUE = 0x3FF;
+  uint16_t value = (adcInput != nullptr) ? adcInput(adcInputContext, adcState.channel, cycle) : 0;
+  if (value > MAX_CONVERSION_VALUE) {
+    value = MAX_CONVERSION_VALUE;
+  }
+  ADC10MEM = value;
+  if (ADC10DTC1 != 0) {
+    transferConversion(value);
+  } else {
+    ADC10CTL0 |= ADC10IFG;
+  }
+
+  switch (ADC10CTL1 & CONSEQ_3) {
+    case CONSEQ_0: adcState.sequenceRunning = false; break;
+    case CONSEQ_1:
+      if (adcState.channel == 0) {
+        adcState.sequenceRunning = false;
+      } else {
+        adcState.channel--;
+      }
+      break;
+    case CONSEQ_2: break;
+    default:  // Repeat sequence of channels
+      adcState.channel = (adcState.channel == 0) ? static_cast<uint8_t>((ADC10CTL1 & INCH_15) / INCH_1)
+                                                 : static_cast<uint8_t>(adcState.channel - 1);
+      break;
+  }
+}
+
+void Simulator::transferConversion(const uint16_t value) noexcept {
+  const bool twoBlocks = ADC10DTC0 & ADC10TB;
+  const uint16_t transfersPerBlock = ADC10DTC1;
+  const uint16_t totalTransfers = twoBlocks ? 2 * transfersPerBlock : transfersPerBlock;
+  if (adcState.transferIndex >= totalTransfers) {
+    adcState.transferIndex = 0;  // The size of the transfer was changed
+  }
+  uint16_t* const destination = reinterpret_cast<uint16_t*>(ADC10SA.value);
+  if (destination == nullptr) {
+    return;
+  }
+  destination[adcState.transferIndex++] = value;
+
+  if (twoBlocks && adcState.transferIndex == transfersPerBlock) {
+    ADC10DTC0 |= ADC10B1;  // The first block is full
+    ADC10CTL0 |= ADC10IFG;
+  } else if (adcState.transferIndex == totalTransfers) {
+    ADC10DTC0 &= ~ADC10B1;
+    ADC10CTL0 |= ADC10IFG;
+    adcState.transferIndex = 0;
+    if (!(ADC10DTC0 & ADC10CT)) {
+      ADC10DTC1 = 0;  // Without continuous transfer, the DTC stops after the last transfer
+    }
+  }
+}
+
+void Simulator::stepUart() noexcept {
+  if (!(IFG2 & UCA0TXIFG) && cycle >= uartState.transmitEnd) {
+    IFG2 |= UCA0TXIFG;  // UCA0TXBUF is ready for the next character
+  }
+  if (uartState.input != nullptr && *uartState.input != '\0' && cycle >= uartState.nextReception) {
+    // The received character is already complete, so the next one starts now
+    UCA0RXBUF.value = static_cast<uint8_t>(*uartState.input++);
+    IFG2 |= UCA0RXIFG;
+    uartState.nextReception = cycle + getCharacterCycles();
+  }
+}
+
+uint32_t Simulator::getCharacterCycles() const noexcept {
+  // Start bit, 8 data bits and stop bit. initMSP of the templateEMP sets 9600 baud, but it is empty in the mock.
+  constexpr uint32_t BITS_PER_CHARACTER = 10;
+  constexpr uint32_t DEFAULT_BAUD_RATE = 9600;
+  const uint32_t divider = UCA0BR0.value | (static_cast<uint32_t>(UCA0BR1.value) << 8);
+  return BITS_PER_CHARACTER * ((divider != 0) ? divider : mclkFrequency / DEFAULT_BAUD_RATE);
+}
+
+void Simulator::transmitSerial(const char character) noexcept {
+  const PeripheralAccess peripheralAccess;
+  IFG2 &= static_cast<uint8_t>(~UCA0TXIFG);
+  // The cycles of a running interruption didn't advance the clock yet
+  uartState.transmitEnd = cycle + (inInterrupt ? interruptCycles : mainLoopCycles) + getCharacterCycles();
+  if (serialOutput != nullptr) {
+    serialOutput(serialOutputContext, character);
+  }
+}
+
+bool Simulator::isPending(const uint8_t vector) const noexcept {
+  const PeripheralAccess peripheralAccess;
+  if (raisedInterrupts & (1U << vector)) {
+    return true;
+  }
+  switch (vector) {
+    case TIMER0_A0_VECTOR:
+    case TIMER1_A0_VECTOR: {
+      const uint16_t captureControl = *getTimerRegisters(vector == TIMER0_A0_VECTOR ? 0 : 1).captureControls[0];
+      return (captureControl & CCIE) && (captureControl & CCIFG);
+    }
+    case TIMER0_A1_VECTOR:
+    case TIMER1_A1_VECTOR:
+      return getTimerInterruptVector(getTimerRegisters(vector == TIMER0_A1_VECTOR ? 0 : 1)) != TA0IV_NONE;
+    case ADC10_VECTOR: return (ADC10CTL0 & ADC10IE) && (ADC10CTL0 & ADC10IFG);
+    case USCIAB0TX_VECTOR: return (IE2 & UCA0TXIE) && (IFG2 & UCA0TXIFG);
+    case USCIAB0RX_VECTOR: return (IE2 & UCA0RXIE) && (IFG2 & UCA0RXIFG);
+    default: return false;
+  }
+}
+
+void Simulator::acknowledge(const uint8_t vector) noexcept {
+  const PeripheralAccess peripheralAccess;
+  raisedInterrupts &= static_cast<uint16_t>(~(1U << vector));
+  switch (vector) {
+    case TIMER0_A0_VECTOR:
+    case TIMER1_A0_VECTOR:
+      // The flag of CCR0 is reset automatically when the interruption is accepted
+      *getTimerRegisters(vector == TIMER0_A0_VECTOR ? 0 : 1).captureControls[0] &= ~CCIFG;
+      break;
+    case TIMER0_A1_VECTOR:
+    case TIMER1_A1_VECTOR: {
+      // On the target, reading TAxIV resets the flag. In the mock it is a variable, so it is done here.
+      const TimerRegisters timer = getTimerRegisters(vector == TIMER0_A1_VECTOR ? 0 : 1);
+      timer.interruptVector = getTimerInterruptVector(timer);
+      switch (timer.interruptVector) {
+        case TA0IV_TACCR1: *timer.captureControls[1] &= ~CCIFG; break;
+        case TA0IV_TACCR2: *timer.captureControls[2] &= ~CCIFG; break;
+        case TA0IV_TAIFG: timer.control &= ~TAIFG; break;
+        default: break;
+      }
+      break;
+    }
+    case ADC10_VECTOR: ADC10CTL0 &= ~ADC10IFG; break;
+    default: break;
+  }
+}
+
+bool Simulator::serviceInterrupts() noexcept {
+  bool serviced = false;
+  for (int8_t vector = NUMBER_OF_VECTORS - 1; vector >= 0; vector--) {
+    const InterruptHandler handler = vectorTable[vector];
+    if (handler == nullptr || !isPending(vector)) {
+      continue;
+    }
+    acknowledge(vector);
+    inInterrupt = true;
+    interruptCycles = cycleCosts.interruptEntry;
+    handler();
+    interruptCycles += cycleCosts.interruptReturn;
+    inInterrupt = false;
+
+    InterruptStatistics& statistics = interruptStatistics[vector];
+    statistics.calls++;
+    statistics.totalCycles += interruptCycles;
+    if (interruptCycles > statistics.worstCaseCycles) {
+      statistics.worstCaseCycles = interruptCycles;
+    }
+    // The peripherals keep running while the interruption executes, but no other interruption is accepted
+    advance(interruptCycles, false);
+    serviced = true;
+    vector = NUMBER_OF_VECTORS;  // Starts again from the highest priority
+  }
+  return serviced;
+}
+
+void Simulator::synchronize() noexcept {
+  const uint32_t cycles = mainLoopCycles;
+  mainLoopCycles = 0;
+  advance(cycles, true);
+}
+
+}  // namespace Mock
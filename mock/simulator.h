@@ -0,0 +1,343 @@
+/******************************************************************************
+ * @file                    simulator.h
+ * @author                  Rafael Andrioli Bauer
+ * @date                    14.10.2026
+ * @matriculation number    5163344
+ * @e-mail contact          abauer.rafael@gmail.com
+ *
+ * @brief   Cycle approximate simulation of the peripherals of the mock
+ *
+ * Description: The registers of the mock are plain variables, so without the
+ *              simulator nothing happens on the host: the timers don't count,
+ *              the ADC10 doesn't convert and no interruption is called.
+ *
+ *              The simulator advances a clock of MCLK cycles. At each cycle it
+ *              counts Timer0_A and Timer1_A in the modes up, continuous and
+ *              up/down, sets their flags, converts the ADC10 channels with the
+ *              values of a scripted waveform and transfers them with the DTC.
+ *              The USCI_A0 sends the characters written to UCA0TXBUF and receives
+ *              scripted characters, one per 10 bits at the baud rate.
+ *              The interruptions that are pending and enabled are then called
+ *              from the vector table, highest vector first, like on the target.
+ *
+ *              The time spent by the software is not known on the host, so every
+ *              register access (see register.h), the intrinsics of GIE and the
+ *              IQmath functions charge configurable costs in cycles. The cycles charged inside an
+ *              interruption are its execution time, and the clock is advanced
+ *              by it after the interruption returns. Interruptions don't nest.
+ *
+ *              The ISRs are defined in the headers of common/, so the mock
+ *              cannot reference them. The replay of an application attaches
+ *              them to the vector table:
+ *                Mock::Simulator& simulator = Mock::Simulator::getInstance();
+ *                simulator.attachInterrupt(TIMER0_A0_VECTOR, &Timer_A_CCR0_ISR);
+ *                simulator.attachInterrupt(ADC10_VECTOR, &ADC10_ISR);
+ *                simulator.setAdcInput(&waveform, nullptr);
+ *                init();  // The initialization of the application
+ *                simulator.setSimulationLength(5000000);
+ *                while (!simulator.isFinished()) {
+ *                  loop();  // Sleeps with LowPower, so the simulation advances until a wake up
+ *                }
+ *                simulator.printReport();
+ *
+ *              example/simulator replays an application like exercise8.
+ *
+ *              Limitations: the costs are only charged by the registers, GIE and
+ *              the IQmath functions, so plain arithmetic, branches and calls are
+ *              free. The execution times are a lower bound: an interruption that
+ *              only works in RAM, like the 20ms task of example/simulator, shows
+ *              little more than its entry and return. The ADC10 timer triggers
+ *              start a conversion at the compare event of the channel,
+ *              independent of its output mode. SMCLK runs at the frequency of
+ *              MCLK. The UART has no receive errors, and without a baud rate
+ *              divider it runs at 9600 baud.
+ ******************************************************************************/
+#ifndef MICROTECH_SIMULATOR_H
+#define MICROTECH_SIMULATOR_H
+
+#include <array>
+#include <cstdint>
+
+namespace Mock {
+
+/**
+ * Type definition of the functions of the vector table
+ */
+typedef void (*InterruptHandler)(void);
+
+/**
+ * Type definition of the waveform sampled by the ADC10
+ * @param context Pointer given when the input was set
+ * @param channel Channel being converted, as in INCHx
+ * @param cycle Cycle of MCLK at the end of the conversion
+ * @return Value of the conversion, from 0 to 1023
+ */
+typedef uint16_t (*AdcInput)(void* context, uint8_t channel, uint64_t cycle);
+
+/**
+ * Type definition of the function that gets the characters sent by the USCI_A0
+ * @param context Pointer given when the output was set
+ * @param character Character written to UCA0TXBUF
+ */
+typedef void (*SerialOutput)(void* context, char character);
+
+/**
+ * Cycles charged to the software. The default values are close to the MSP430G2553 without hardware multiplier.
+ */
+struct CycleCosts {
+  uint16_t registerAccess = 3;      ///< Each read or write of a register
+  uint16_t iqMultiplication = 160;  ///< _IQ15mpy, a software multiplication of 32 bits
+  uint16_t iqDivision = 420;        ///< _IQ15div, a software division of 32 bits
+  uint16_t iqSine = 520;            ///< _IQ15sin
+  uint16_t interruptState = 2;      ///< Disabling, enabling, saving or restoring GIE
+  uint16_t interruptEntry = 6;      ///< Accepting an interruption
+  uint16_t interruptReturn = 5;     ///< RETI
+};
+
+/**
+ * Execution times of the interruptions of one vector. The times include the entry and the return.
+ */
+struct InterruptStatistics {
+  uint32_t calls = 0;            ///< How many times the interruption was called
+  uint32_t worstCaseCycles = 0;  ///< Longest execution time
+  uint64_t totalCycles = 0;      ///< Sum of the execution times
+};
+
+/**
+ * Operations of the IQmath library that are charged.
+ */
+enum class IqOperation : uint8_t {
+  MULTIPLICATION,
+  DIVISION,
+  SINE,
+};
+
+class Simulator {
+  Simulator() = default;
+
+public:
+  // Deleted copy and move constructors
+  Simulator(Simulator&) = delete;
+  Simulator(Simulator&&) = delete;
+  ~Simulator() = default;
+
+  static constexpr uint8_t NUMBER_OF_VECTORS = 16;  ///< Vectors from TRAPINT_VECTOR to RESET_VECTOR
+
+  /**
+   * Method that guarantees that there is only one simulator, since there is only one set of registers
+   * @return A reference to the instance
+   */
+  static Simulator& getInstance();
+
+  /**
+   * Method to set the frequency of the clocks
+   * @param mclkHz Frequency of MCLK and SMCLK, so also of each cycle of the simulation
+   * @param aclkHz Frequency of ACLK
+   * @param adc10oscHz Frequency of the internal oscillator of the ADC10
+   */
+  void setClockFrequencies(uint32_t mclkHz, uint32_t aclkHz, uint32_t adc10oscHz) noexcept;
+
+  /**
+   * Method to set the cycles charged to the software
+   */
+  void setCycleCosts(const CycleCosts& costs) noexcept {
+    cycleCosts = costs;
+  }
+
+  /**
+   * Method to attach an interruption service routine to a vector
+   * @param vector Vector of msp430g2553.h, e.g. TIMER0_A0_VECTOR
+   * @param handler ISR, or nullptr to detach it
+   */
+  void attachInterrupt(uint8_t vector, InterruptHandler handler) noexcept;
+
+  /**
+   * Method to request an interruption of a vector that is not simulated, e.g. a port after a scripted press.
+   * It is called once at the next cycle, if a handler is attached.
+   */
+  void raiseInterrupt(uint8_t vector) noexcept;
+
+  /**
+   * Method to set the waveform converted by the ADC10. Without input, all the conversions are 0.
+   */
+  void setAdcInput(AdcInput input, void* context) noexcept {
+    adcInput = input;
+    adcInputContext = context;
+  }
+
+  /**
+   * Method to set the characters received by the USCI_A0, e.g. the commands of the application. They are received one
+   * after the other from the next cycle on.
+   * @param text null-terminated characters, which must stay valid until all of them were received
+   */
+  void setSerialInput(const char* text) noexcept {
+    uartState.input = text;
+  }
+
+  /**
+   * Method to set the function that gets the characters sent by the USCI_A0
+   */
+  void setSerialOutput(SerialOutput output, void* context) noexcept {
+    serialOutput = output;
+    serialOutputContext = context;
+  }
+
+  /**
+   * Method called when the software writes UCA0TXBUF. The transmit flag is cleared until the character was sent.
+   */
+  void transmitSerial(char character) noexcept;
+
+  /**
+   * Method to set after how many cycles from now the simulation finishes. From then on, the low power modes
+   * advance the simulation until an interruption wakes up the main loop or the simulation finished.
+   */
+  void setSimulationLength(uint64_t cycles) noexcept;
+
+  /**
+   * Method to know if the length of the simulation was reached
+   */
+  bool isFinished() const noexcept {
+    return active && cycle >= endCycle;
+  }
+
+  /**
+   * Method to advance the simulation while the main loop is busy
+   * @param cycles Number of MCLK cycles
+   */
+  void run(uint64_t cycles) noexcept;
+
+  /**
+   * Method called by __bis_SR_register. If the CPU is turned off, the simulation advances until an
+   * interruption wakes it up or the simulation finished. The clocks turned off by the bits stop.
+   * @param statusBits Bits set in the status register
+   */
+  void enterLowPowerMode(uint16_t statusBits) noexcept;
+
+  /**
+   * Method called by __bic_SR_register_on_exit. Inside an interruption, it wakes up the main loop if the
+   * CPU bit is cleared.
+   * @param statusBits Bits cleared in the status register
+   */
+  void exitLowPowerModeOnReturn(uint16_t statusBits) noexcept;
+
+  /**
+   * Method to charge cycles to the running software: the running interruption, or the main loop otherwise.
+   * The cycles of the main loop advance the simulation at the next run or low power mode.
+   */
+  void charge(uint32_t cycles) noexcept;
+
+  /**
+   * Method called by the registers of the mock at every access of the software
+   */
+  void chargeRegisterAccesses(uint8_t numberOfAccesses) noexcept {
+    charge(static_cast<uint32_t>(numberOfAccesses) * cycleCosts.registerAccess);
+  }
+
+  /**
+   * Method called by the intrinsics that read or change GIE
+   */
+  void chargeInterruptState() noexcept {
+    charge(cycleCosts.interruptState);
+  }
+
+  /**
+   * Method called by the IQmath functions
+   */
+  void chargeIqOperation(IqOperation operation) noexcept;
+
+  /**
+   * Method to get the current cycle of the simulation
+   */
+  uint64_t getCycle() const noexcept {
+    return cycle;
+  }
+
+  /**
+   * Method to get the execution times of the interruptions of a vector
+   */
+  const InterruptStatistics& getInterruptStatistics(uint8_t vector) const noexcept;
+
+  /**
+   * Method to print the execution times of every vector that was called
+   */
+  void printReport() const;
+
+  /**
+   * Method to restart the simulation at cycle 0, without statistics or pending interruptions.
+   * The vector table, the input and the costs are kept.
+   */
+  void reset() noexcept;
+
+private:
+  /**
+   * State of a Timer_A that is not in its registers
+   */
+  struct TimerState {
+    uint32_t dividerCount = 0;  ///< Source clock edges since the last count, for the input divider
+    bool countingDown = false;  ///< Direction in the up/down mode
+  };
+
+  /**
+   * State of the ADC10 and of the DTC that is not in their registers
+   */
+  struct AdcState {
+    bool converting = false;       ///< If a conversion is running
+    bool sequenceRunning = false;  ///< If the sequence or repeat mode has more conversions to do
+    bool triggered = false;        ///< If the timer trigger had an edge since the last conversion
+    uint64_t conversionEnd = 0;    ///< Cycle when the running conversion is complete
+    uint8_t channel = 0;           ///< Channel of the running or next conversion
+    uint16_t transferIndex = 0;    ///< Index of the next transfer of the DTC
+  };
+
+  /**
+   * State of the USCI_A0 that is not in its registers
+   */
+  struct UartState {
+    uint64_t transmitEnd = 0;     ///< Cycle when the character being sent is complete
+    uint64_t nextReception = 0;   ///< Cycle when the next scripted character is received
+    const char* input = nullptr;  ///< Scripted characters still to be received
+  };
+
+  void advance(uint64_t cycles, bool servicing) noexcept;
+  void step() noexcept;
+  void countTimer(uint8_t timerNumber) noexcept;
+  void compareEvent(uint8_t timerNumber, uint8_t channel) noexcept;
+  void stepAdc() noexcept;
+  void stepUart() noexcept;
+  uint32_t getCharacterCycles() const noexcept;
+  void startConversion() noexcept;
+  void completeConversion() noexcept;
+  void transferConversion(uint16_t value) noexcept;
+  bool isPending(uint8_t vector) const noexcept;
+  void acknowledge(uint8_t vector) noexcept;
+  bool serviceInterrupts() noexcept;
+  void synchronize() noexcept;
+
+  uint32_t mclkFrequency = 1000000;         ///< Frequency of MCLK, SMCLK and the simulation
+  uint32_t aclkFrequency = 32768;           ///< Frequency of ACLK
+  uint32_t adc10oscFrequency = 5000000;     ///< Frequency of the internal oscillator of the ADC10
+  CycleCosts cycleCosts;                    ///< Cycles charged to the software
+  uint64_t cycle = 0;                       ///< Current cycle of MCLK
+  uint64_t endCycle = 0;                    ///< Cycle where the simulation finishes
+  bool active = false;                      ///< If the low power modes advance the simulation
+  uint32_t aclkAccumulator = 0;             ///< Generates the edges of ACLK from the cycles of MCLK
+  bool smclkRunning = true;                 ///< If SMCLK is on in the current low power mode
+  bool aclkRunning = true;                  ///< If ACLK is on in the current low power mode
+  bool inInterrupt = false;                 ///< If the cycles are charged to an interruption
+  bool wakeUpRequested = false;             ///< If the running interruption wakes up the main loop
+  uint32_t interruptCycles = 0;             ///< Cycles charged to the running interruption
+  uint32_t mainLoopCycles = 0;              ///< Cycles charged to the main loop that didn't advance yet
+  std::array<TimerState, 2> timerStates{};  ///< State of Timer0_A and Timer1_A
+  AdcState adcState;                        ///< State of the ADC10
+  AdcInput adcInput = nullptr;              ///< Waveform converted by the ADC10
+  void* adcInputContext = nullptr;          ///< Pointer passed to the waveform
+  UartState uartState;                      ///< State of the USCI_A0
+  SerialOutput serialOutput = nullptr;      ///< Gets the characters sent by the USCI_A0
+  void* serialOutputContext = nullptr;      ///< Pointer passed to the serial output
+  uint16_t raisedInterrupts = 0;            ///< One bit per vector raised by raiseInterrupt
+  std::array<InterruptHandler, NUMBER_OF_VECTORS> vectorTable{};           ///< ISR of each vector
+  std::array<InterruptStatistics, NUMBER_OF_VECTORS> interruptStatistics{};  ///< Execution times of each vector
+};
+}  // namespace Mock
+
+#endif  // MICROTECH_SIMULATOR_H